@@ -110,7 +110,7 @@ Main::Main(QWidget *parent) :
 {
 	setWindowFlags(Qt::Window);
 	ui->setupUi(this);
-	g_logPost = [=](string const& s, char const* c)
+	setLogPost([=](string const& s, char const* c)
 	{
 		simpleDebugOut(s, c);
 		m_logLock.lock();
@@ -118,7 +118,7 @@ Main::Main(QWidget *parent) :
 		m_logChanged = true;
 		m_logLock.unlock();
 //		ui->log->addItem(QString::fromStdString(s));
-	};
+	});
 
 #if ETH_DEBUG
 	m_servers.append("localhost:30300");
@@ -198,7 +198,7 @@ Main::~Main()
 	writeSettings();
 	// Must do this here since otherwise m_ethereum'll be deleted (and therefore clearWatches() called by the destructor)
 	// *after* the client is dead.
-	g_logPost = simpleDebugOut;
+	setLogPost(simpleDebugOut);
 }
 
 bool Main::confirm() const
@@ -1394,7 +1394,7 @@ void Main::on_blocks_currentItemChanged()
 			Transaction tx(block[1][txi].data(), CheckSignature::Sender);
 			auto ss = tx.safeSender();
 			h256 th = sha3(rlpList(ss, tx.nonce()));
-			TransactionReceipt receipt = ethereum()->blockChain().receipts(h).receipts[txi];
+			TransactionReceipt receipt = ethereum()->blockChain().receipt(h, txi);
 			s << "<h3>" << th << "</h3>";
 			s << "<h4>" << h << "[<b>" << txi << "</b>]</h4>";
 			s << "<br/>From: <b>" << pretty(ss).toHtmlEscaped().toStdString() << "</b> " << ss;
@@ -91,6 +91,7 @@ void interactiveHelp()
 		<< "    inspect <contract>  Dumps a contract to <APPDATA>/<contract>.evm." << endl
 		<< "    dumptrace <block> <index> <filename> <format>  Dumps a transaction trace" << endl << "to <filename>. <format> should be one of pretty, standard, standard+." << endl
 		<< "    dumpreceipt <block> <index>  Dumps a transation receipt." << endl
+		<< "    dbstats  Shows the databases' statistics." << endl
 		<< "    exit  Exits the application." << endl;
 }
 
@@ -114,10 +115,12 @@ void help()
         << "    -l,--listen <port>  Listen on the given port for incoming connected (default: 30303)." << endl
 		<< "    -m,--mining <on/off/number>  Enable mining, optionally for a specified number of blocks (Default: off)" << endl
 		<< "    -n,--upnp <on/off>  Use upnp for NAT (default: on)." << endl
+		<< "    --network-threads <number>  Number of threads servicing network I/O (Default: 1)." << endl
 		<< "    -L,--local-networking Use peers whose addresses are local." << endl
 		<< "    -o,--mode <full/peer>  Start a full node or a peer node (Default: full)." << endl
         << "    -p,--port <port>  Connect to remote port (default: 30303)." << endl
         << "    -r,--remote <host>  Connect to remote host (default: none)." << endl
+		<< "    -S,--storage-profile <archive/full/light>  Set how much memory the databases may use (Default: full)." << endl
         << "    -s,--secret <secretkeyhex>  Set the secret key for use with send command (default: auto)." << endl
 		<< "    -t,--miners <number>  Number of mining threads to start (Default: " << thread::hardware_concurrency() << ")" << endl
         << "    -u,--public-ip <ip>  Force public ip to given (default; auto)." << endl
@@ -196,6 +199,7 @@ int main(int argc, char** argv)
 	unsigned mining = ~(unsigned)0;
 	NodeMode mode = NodeMode::Full;
 	unsigned peers = 5;
+	unsigned networkThreads = 1;
 	int miners = -1;
 	bool interactive = false;
 #if ETH_JSONRPC
@@ -313,6 +317,21 @@ int main(int argc, char** argv)
 			g_logVerbosity = atoi(argv[++i]);
 		else if ((arg == "-x" || arg == "--peers") && i + 1 < argc)
 			peers = atoi(argv[++i]);
+		else if ((arg == "-S" || arg == "--storage-profile") && i + 1 < argc)
+		{
+			string m = argv[++i];
+			try
+			{
+				Defaults::setStorageProfile(storageProfileFromString(m));
+			}
+			catch (...)
+			{
+				cerr << "Unknown storage profile: " << m << endl;
+				return -1;
+			}
+		}
+		else if (arg == "--network-threads" && i + 1 < argc)
+			networkThreads = max(atoi(argv[++i]), 1);
 		else if ((arg == "-t" || arg == "--miners") && i + 1 < argc)
 			miners = atoi(argv[++i]);
 		else if ((arg == "-o" || arg == "--mode") && i + 1 < argc)
@@ -352,6 +371,7 @@ int main(int argc, char** argv)
 
 	VMFactory::setKind(jit ? VMKind::JIT : VMKind::Interpreter);
 	NetworkPreferences netPrefs(listenPort, publicIP, upnp, useLocal);
+	netPrefs.ioThreads = networkThreads;
 	auto nodesState = contents((dbPath.size() ? dbPath : getDataDir()) + "/network.rlp");
 	dev::WebThreeDirect web3(
 		"Ethereum(++)/" + clientName + "v" + dev::Version + "/" DEV_QUOTED(ETH_BUILD_TYPE) "/" DEV_QUOTED(ETH_BUILD_PLATFORM) + (jit ? "/JIT" : ""),
@@ -401,11 +421,11 @@ int main(int argc, char** argv)
 		string l;
 		while (!g_exit)
 		{
-			g_logPost = [](std::string const& a, char const*) { cout << "\r           \r" << a << endl << "Press Enter" << flush; };
+			setLogPost([](std::string const& a, char const*) { cout << "\r           \r" << a << endl << "Press Enter" << flush; });
 			cout << logbuf << "Press Enter" << flush;
 			std::getline(cin, l);
 			logbuf.clear();
-			g_logPost = [&](std::string const& a, char const*) { logbuf += a + "\n"; };
+			setLogPost([&](std::string const& a, char const*) { logbuf += a + "\n"; });
 
 #if ETH_READLINE
 			if (l.size())
@@ -505,6 +525,10 @@ int main(int argc, char** argv)
 						<< std::chrono::duration_cast<std::chrono::milliseconds>(it.lastPing).count() << "ms"
 						<< endl;
 			}
+			else if (c && cmd == "dbstats")
+			{
+				cout << c->databaseStats();
+			}
 			else if (c && cmd == "balance")
 			{
 				cout << "Current balance: " << formatBalance( c->balanceAt(us.address())) << " = " <<c->balanceAt(us.address()) << " wei" << endl;
@@ -697,7 +721,7 @@ int main(int argc, char** argv)
 				unsigned block;
 				unsigned index;
 				iss >> block >> index;
-				dev::eth::TransactionReceipt r = c->blockChain().receipts(c->blockChain().numberHash(block)).receipts[index];
+				dev::eth::TransactionReceipt r = c->blockChain().receipt(c->blockChain().numberHash(block), index);
 				auto rb = r.rlp();
 				cout << "RLP: " << RLP(rb) << endl;
 				cout << "Hex: " << toHex(rb) << endl;
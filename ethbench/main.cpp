@@ -0,0 +1,479 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file main.cpp
+ * @date 2015
+ * Benchmarks of the trie, RLP, crypto, VM and block import, reported as JSON.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <boost/filesystem.hpp>
+#include <libdevcore/Log.h>
+#include <libdevcore/CommonIO.h>
+#include <libdevcore/RLP.h>
+#include <libdevcrypto/Common.h>
+#include <libdevcrypto/MemoryDB.h>
+#include <libdevcrypto/SHA3.h>
+#include <libdevcrypto/TrieDB.h>
+#include <libevm/ExtVMFace.h>
+#include <libevm/VMFactory.h>
+#include <libethereum/CanonBlockChain.h>
+#include <libethereum/State.h>
+#include <libethereum/Transaction.h>
+#include <liblll/Compiler.h>
+#include <test/JsonSpiritHeaders.h>
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+namespace js = json_spirit;
+namespace fs = boost::filesystem;
+
+void help()
+{
+	cout
+		<< "Usage ethbench [OPTIONS]" << endl
+		<< "Options:" << endl
+		<< "    -b,--blocks <n>  Number of blocks in the synthetic chain imported (default: 32)." << endl
+		<< "    -f,--filter <s>  Only run the benchmarks whose name contains s." << endl
+		<< "    -F,--filler <file>  Also run the VM on each exec test in the given VM test filler; may be repeated." << endl
+		<< "    -h,--help  Show this help message and exit." << endl
+#if ETH_EVMJIT
+		<< "    -J,--jit  Run the VM benchmarks on the JIT rather than the interpreter." << endl
+#endif
+		<< "    -o,--output <file>  Write the JSON report to file rather than stdout." << endl
+		<< "    -s,--samples <n>  Number of timed samples per benchmark (default: 20)." << endl
+		<< "    -t,--transactions <n>  Transactions per block of the synthetic chain (default: 20)." << endl
+		<< "    -v,--verbosity <0 - 9>  Set the log verbosity from 0 to 9 (default: 0)." << endl;
+	exit(0);
+}
+
+namespace
+{
+
+/**
+ * @brief Runs benchmarks and gathers their timings.
+ * Each benchmark runs an untimed warm-up sample first; every sample then times a batch of operations, and the
+ * distribution of the per-operation times over the samples is reported.
+ */
+class Benchmarks
+{
+public:
+	Benchmarks(string const& _filter, unsigned _samples): m_filter(_filter), m_samples(_samples) {}
+
+	unsigned samples() const { return m_samples; }
+
+	/// @returns true if the benchmark @a _name is to be run.
+	bool wanted(string const& _name) const { return m_filter.empty() || _name.find(m_filter) != string::npos; }
+
+	/// Times @a _ops calls of @a _op per sample, calling @a _setup untimed before each sample.
+	void run(string const& _name, unsigned _ops, function<void()> const& _setup, function<void(unsigned)> const& _op)
+	{
+		if (!wanted(_name))
+			return;
+		vector<double> ns;
+		for (unsigned s = 0; s <= m_samples; ++s)
+		{
+			_setup();
+			auto start = chrono::steady_clock::now();
+			for (unsigned i = 0; i < _ops; ++i)
+				_op(i);
+			double d = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+			if (s)
+				ns.push_back(d / _ops);
+		}
+		record(_name, ns, _ops);
+	}
+
+	/// Records the per-operation times @a _ns, in nanoseconds, of a benchmark that timed itself.
+	void record(string const& _name, vector<double> _ns, unsigned _opsPerSample)
+	{
+		if (_ns.empty())
+			return;
+		sort(_ns.begin(), _ns.end());
+		double sum = 0;
+		for (double d: _ns)
+			sum += d;
+		// Nearest-rank percentile.
+		auto percentile = [&](unsigned p) { return _ns[max<size_t>((_ns.size() * p + 99) / 100, 1) - 1]; };
+
+		js::mObject o;
+		o["samples"] = (int)_ns.size();
+		o["opsPerSample"] = (int)_opsPerSample;
+		o["min"] = _ns.front();
+		o["p50"] = percentile(50);
+		o["p90"] = percentile(90);
+		o["p99"] = percentile(99);
+		o["max"] = _ns.back();
+		o["mean"] = sum / _ns.size();
+		m_results[_name] = o;
+		cerr << _name << ": " << percentile(50) << " ns/op (p90 " << percentile(90) << ")" << endl;
+	}
+
+	js::mObject const& results() const { return m_results; }
+
+private:
+	string m_filter;
+	unsigned m_samples;
+	js::mObject m_results;
+};
+
+/// Deterministic pseudo-random words, so every run benchmarks the same inputs.
+h256 word(unsigned _i, string const& _salt = string())
+{
+	return sha3(_salt + toString(_i));
+}
+
+void benchTrie(Benchmarks& _b)
+{
+	unsigned const n = 10000;
+	vector<bytes> keys;
+	for (unsigned i = 0; i < n; ++i)
+		keys.push_back(word(i, "key").asBytes());
+
+	MemoryDB db;
+	unique_ptr<GenericTrieDB<MemoryDB>> t;
+	auto fresh = [&]() { db = MemoryDB(); t.reset(new GenericTrieDB<MemoryDB>(&db)); t->init(); };
+	auto fill = [&]() { fresh(); for (auto const& k: keys) t->insert(&k, &k); };
+
+	_b.run("trie/insert", n, fresh, [&](unsigned i) { t->insert(&keys[i], &keys[i]); });
+	if (_b.wanted("trie/lookup") || _b.wanted("trie/iterate"))
+		fill();
+	size_t found = 0;
+	_b.run("trie/lookup", n, []{}, [&](unsigned i) { found += t->at(&keys[i]).size(); });
+	_b.run("trie/iterate", 1, []{}, [&](unsigned) { for (auto it = t->begin(); it != t->end(); ++it) found += (*it).second.size(); });
+	cdebug << found;
+}
+
+void benchRLP(Benchmarks& _b)
+{
+	// A transaction-shaped list: integers of assorted sizes, an address, a hash and some data.
+	auto encode = [](unsigned _i)
+	{
+		RLPStream s;
+		s.appendList(9) << u256(_i) << u256(10000000000000ull) << u256(21000) << right160(word(_i)) << u256(_i) * 1000000007 << bytes(64, (byte)_i) << (byte)27 << word(_i, "r") << word(_i, "s");
+		return s.out();
+	};
+	unsigned const n = 1000;
+	vector<bytes> encoded;
+	for (unsigned i = 0; i < n; ++i)
+		encoded.push_back(encode(i));
+
+	size_t total = 0;
+	_b.run("rlp/encode", n, []{}, [&](unsigned i) { total += encode(i).size(); });
+	_b.run("rlp/decode", n, []{}, [&](unsigned i)
+	{
+		RLP r(encoded[i]);
+		total += r[0].toInt<u256>() != 0;
+		total += r[3].toHash<Address>()[0];
+		total += r[5].toBytesConstRef().size();
+		total += r[7].toHash<h256>()[0];
+	});
+	cdebug << total;
+}
+
+void benchCrypto(Benchmarks& _b)
+{
+	unsigned const n = 1000;
+	bytes small = word(0).asBytes();
+	bytes large(1024, 0xaa);
+	h256 h;
+	_b.run("sha3/32", n, []{}, [&](unsigned) { h = sha3(small); });
+	_b.run("sha3/1024", n, []{}, [&](unsigned) { h = sha3(large); });
+
+	unsigned const m = 100;
+	KeyPair k(word(0, "secret"));
+	vector<Signature> sigs;
+	for (unsigned i = 0; i < m; ++i)
+		sigs.push_back(sign(k.secret(), word(i)));
+	Public p;
+	_b.run("crypto/sign", m, []{}, [&](unsigned i) { sigs[i] = sign(k.secret(), word(i)); });
+	_b.run("crypto/recover", m, []{}, [&](unsigned i) { p = recover(sigs[i], word(i)); });
+	cdebug << h << p;
+}
+
+/// The environment of a contract run on its own: storage is kept in a map and there are no other accounts.
+class BenchExt: public ExtVMFace
+{
+public:
+	BenchExt(Address _myAddress, Address _caller, Address _origin, u256 _value, u256 _gasPrice, bytesConstRef _data, bytes const& _code, BlockInfo const& _currentBlock):
+		ExtVMFace(_myAddress, _caller, _origin, _value, _gasPrice, _data, _code, BlockInfo(), _currentBlock, LastHashes(256), 0)
+	{}
+
+	u256 store(u256 _n) override { auto it = m_store.find(_n); return it == m_store.end() ? 0 : it->second; }
+	void setStore(u256 _n, u256 _v) override { if (_v) m_store[_n] = _v; else m_store.erase(_n); }
+
+	/// Restores the storage to @a _store and forgets everything the last run left behind.
+	void reset(map<u256, u256> const& _store) { m_store = _store; sub.clear(); }
+
+private:
+	map<u256, u256> m_store;
+};
+
+/// A contract run in isolation by the VM benchmarks.
+struct Contract
+{
+	string name;
+	bytes code;
+	bytes data;
+	u256 gas = 100000000;
+	u256 value;
+	map<u256, u256> store;
+	BlockInfo block;
+};
+
+bytes importBytes(string const& _s)
+{
+	return fromHex(_s.substr(0, 2) == "0x" ? _s.substr(2) : _s, ThrowType::Throw);
+}
+
+bytes importCode(string const& _s)
+{
+	if (_s.substr(0, 2) == "0x")
+		return importBytes(_s);
+	vector<string> errors;
+	bytes ret = compileLLL(_s, false, &errors);
+	for (auto const& e: errors)
+		cwarn << e;
+	return ret;
+}
+
+u256 toInt(js::mValue const& _v)
+{
+	return _v.type() == js::int_type ? u256(_v.get_uint64()) : u256(_v.get_str());
+}
+
+/// Contracts exercising the interpreter's dispatch, memory and hashing.
+vector<Contract> builtinContracts()
+{
+	vector<pair<string, string>> src = {
+		{ "arithmetic", "{ (for {} (< @i 20000) [i](+ @i 1) [j](MULMOD (EXP @i 3) 0x10001 (+ @i 7))) [[0]] @j }" },
+		{ "memory", "{ (for {} (< @i 4096) [i](+ @i 1) (MSTORE (+ 0x1000 (* @i 32)) @i)) }" },
+		{ "sha3", "{ (for {} (< @i 2000) [i](+ @i 1) [j](SHA3 0 64)) [[0]] @j }" }
+	};
+	vector<Contract> ret;
+	for (auto const& s: src)
+	{
+		Contract c;
+		c.name = s.first;
+		c.code = importCode(s.second);
+		c.block.gasLimit = 1000000000;
+		ret.push_back(c);
+	}
+	return ret;
+}
+
+/// The "exec" tests of the VM test filler @a _file, with the code and storage of the account they run as.
+vector<Contract> fillerContracts(string const& _file)
+{
+	js::mValue v;
+	js::read_string(asString(contents(_file)), v);
+	if (v.type() != js::obj_type)
+	{
+		cwarn << "Can't read filler" << _file;
+		return {};
+	}
+	vector<Contract> ret;
+	for (auto& i: v.get_obj())
+	{
+		js::mObject& t = i.second.get_obj();
+		if (!t.count("exec"))
+			continue;
+		js::mObject& exec = t["exec"].get_obj();
+		Contract c;
+		c.name = fs::path(_file).stem().string() + "/" + i.first;
+		string address = exec["address"].get_str();
+		if (exec.count("code"))
+			c.code = importCode(exec["code"].get_str());
+		if (t.count("pre") && t["pre"].get_obj().count(address))
+		{
+			js::mObject& a = t["pre"].get_obj()[address].get_obj();
+			if (!exec.count("code"))
+				c.code = importCode(a["code"].get_str());
+			for (auto const& s: a["storage"].get_obj())
+				c.store[u256(s.first)] = toInt(s.second);
+		}
+		if (exec["data"].type() == js::str_type)
+			c.data = importBytes(exec["data"].get_str());
+		c.gas = toInt(exec["gas"]);
+		c.value = toInt(exec["value"]);
+		if (t.count("env"))
+		{
+			js::mObject& env = t["env"].get_obj();
+			c.block.number = toInt(env["currentNumber"]);
+			c.block.gasLimit = toInt(env["currentGasLimit"]);
+			c.block.difficulty = toInt(env["currentDifficulty"]);
+			c.block.timestamp = toInt(env["currentTimestamp"]);
+			c.block.coinbaseAddress = Address(env["currentCoinbase"].get_str());
+		}
+		ret.push_back(c);
+	}
+	return ret;
+}
+
+void benchVM(Benchmarks& _b, vector<Contract> const& _contracts, string const& _prefix)
+{
+	for (auto const& c: _contracts)
+	{
+		string name = _prefix + c.name;
+		if (!_b.wanted(name))
+			continue;
+		Address caller = right160(word(0, "caller"));
+		BenchExt ext(right160(word(0, "address")), caller, caller, c.value, 1, &c.data, c.code, c.block);
+		unsigned const n = 10;
+		_b.run(name, n, []{}, [&](unsigned)
+		{
+			ext.reset(c.store);
+			try
+			{
+				VMFactory::create(c.gas)->go(ext, {});
+			}
+			catch (VMException const&)
+			{
+				// Running out of gas or hitting a bad instruction ends the run the same as it would on chain.
+			}
+		});
+	}
+}
+
+/// Makes a chain of @a _blocks blocks, each but the first holding @a _txs value transfers to new accounts.
+vector<bytes> makeChain(string const& _path, unsigned _blocks, unsigned _txs)
+{
+	KeyPair miner(word(0, "miner"));
+	CanonBlockChain bc(_path, true);
+	OverlayDB db = State::openDB(_path, true);
+	State s(miner.address(), db);
+	s.sync(bc);
+
+	vector<bytes> ret;
+	for (unsigned b = 0; b < _blocks; ++b)
+	{
+		// The miner has nothing to send until its first block reward.
+		if (b)
+			for (unsigned i = 0; i < _txs; ++i)
+				s.execute(bc, Transaction(1, 0, 10000, right160(word(b * _txs + i, "to")), bytes(), s.transactionsFrom(miner.address()), miner.secret()).rlp());
+		s.commitToMine(bc);
+		for (MineInfo info; !info.completed; info = s.mine()) {}
+		s.completeMine();
+		ret.push_back(s.blockData());
+		bc.import(ret.back(), db);
+		s.sync(bc);
+	}
+	return ret;
+}
+
+void benchImport(Benchmarks& _b, unsigned _blocks, unsigned _txs)
+{
+	string const name = "import/block";
+	if (!_b.wanted(name) || !_blocks)
+		return;
+	fs::path dir = fs::temp_directory_path() / fs::unique_path();
+	cerr << "Mining a chain of " << _blocks << " blocks..." << endl;
+	vector<bytes> chain = makeChain((dir / "source").string(), _blocks, _txs);
+
+	// Each import is a sample of its own; every pass imports the whole chain into an empty database.
+	vector<double> ns;
+	for (unsigned pass = 0; pass <= max(_b.samples() / 10, 1u); ++pass)
+	{
+		string path = (dir / toString(pass)).string();
+		CanonBlockChain bc(path, true);
+		OverlayDB db = State::openDB(path, true);
+		for (auto const& block: chain)
+		{
+			auto start = chrono::steady_clock::now();
+			bc.import(block, db);
+			double d = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+			if (pass)
+				ns.push_back(d);
+		}
+	}
+	_b.record(name, ns, 1);
+	fs::remove_all(dir);
+}
+
+}
+
+int main(int argc, char** argv)
+{
+	string filter;
+	string output;
+	unsigned samples = 20;
+	unsigned blocks = 32;
+	unsigned txs = 20;
+	vector<string> fillers;
+	bool jit = false;
+	g_logVerbosity = 0;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		string arg = argv[i];
+		if ((arg == "-f" || arg == "--filter") && i + 1 < argc)
+			filter = argv[++i];
+		else if ((arg == "-F" || arg == "--filler") && i + 1 < argc)
+			fillers.push_back(argv[++i]);
+		else if ((arg == "-s" || arg == "--samples") && i + 1 < argc)
+			samples = max(atoi(argv[++i]), 1);
+		else if ((arg == "-b" || arg == "--blocks") && i + 1 < argc)
+			blocks = max(atoi(argv[++i]), 0);
+		else if ((arg == "-t" || arg == "--transactions") && i + 1 < argc)
+			txs = max(atoi(argv[++i]), 0);
+		else if ((arg == "-o" || arg == "--output") && i + 1 < argc)
+			output = argv[++i];
+		else if ((arg == "-v" || arg == "--verbosity") && i + 1 < argc)
+			g_logVerbosity = atoi(argv[++i]);
+#if ETH_EVMJIT
+		else if (arg == "-J" || arg == "--jit")
+			jit = true;
+#endif
+		else if (arg == "-h" || arg == "--help")
+			help();
+		else
+		{
+			cerr << "Unknown argument: " << arg << endl;
+			help();
+		}
+	}
+
+#if ETH_EVMJIT
+	if (jit)
+		VMFactory::setKind(VMKind::JIT);
+#endif
+	string vmPrefix = jit ? "jit/" : "vm/";
+
+	Benchmarks b(filter, samples);
+	benchTrie(b);
+	benchRLP(b);
+	benchCrypto(b);
+	benchVM(b, builtinContracts(), vmPrefix);
+	for (auto const& f: fillers)
+		benchVM(b, fillerContracts(f), vmPrefix);
+	benchImport(b, blocks, txs);
+
+	js::mObject report;
+	report["unit"] = "ns/op";
+	report["vm"] = jit ? "jit" : "interpreter";
+	report["benchmarks"] = b.results();
+	string json = js::write_string(js::mValue(report), true);
+	if (output.empty())
+		cout << json << endl;
+	else
+		writeFile(output, asBytes(json));
+	return 0;
+}
@@ -1,5 +1,6 @@
 #include "BasicBlock.h"
 
+#include <algorithm>
 #include <iostream>
 
 #include "preprocessor/llvm_includes_start.h"
@@ -193,28 +194,81 @@ void BasicBlock::linkLocalStacks(std::vector<BasicBlock*> basicBlocks, llvm::IRB
 	{
 		BasicBlock& bblock;
 		std::vector<BBInfo*> predecessors;
+		std::vector<BBInfo*> successors;
 		size_t inputItems;
 		size_t outputItems;
-		std::vector<llvm::PHINode*> phisToRewrite;
+		std::vector<llvm::PHINode*> passThrough;	///< Items fetched only to hand them on to successors
 
 		BBInfo(BasicBlock& _bblock) :
 			bblock(_bblock),
 			predecessors(),
+			successors(),
 			inputItems(0),
 			outputItems(0)
 		{
+			count();
+		}
+
+		/// Counts the items at the top of the initial and the exit stacks that are known values.
+		void count()
+		{
+			inputItems = 0;
 			auto& initialStack = bblock.m_initialStack;
 			for (auto it = initialStack.begin();
 				 it != initialStack.end() && *it != nullptr;
 				 ++it, ++inputItems);
 
-			//if (bblock.localStack().m_tosOffset > 0)
-			//	outputItems = bblock.localStack().m_tosOffset;
+			outputItems = 0;
 			auto& exitStack = bblock.m_currentStack;
 			for (auto it = exitStack.rbegin();
 				 it != exitStack.rend() && *it != nullptr;
 				 ++it, ++outputItems);
 		}
+
+		/// Makes the first unknown exit item known by fetching it on entry, if the block leaves it untouched
+		/// and it is the next item of the initial stack.
+		/// @returns false if the block cannot forward any more items.
+		bool forwardItem(llvm::IRBuilder<>& _builder)
+		{
+			auto& stack = bblock.m_currentStack;
+			if (outputItems < stack.size() && stack[stack.size() - 1 - outputItems] != nullptr)
+				return false;
+			int initialIdx = (int)outputItems - bblock.m_tosOffset;
+			if (initialIdx < 0 || (size_t)initialIdx != inputItems)
+				return false;
+
+			InsertPointGuard guard{_builder};
+			_builder.SetInsertPoint(bblock.llvm(), bblock.llvm()->begin());
+			passThrough.push_back(llvm::cast<llvm::PHINode>(bblock.localStack().get(outputItems)));
+			count();
+			return true;
+		}
+
+		/// Drops the forwarded items that did not end up linked to the predecessors, so that they stay on the
+		/// EVM stack instead of being fetched (and possibly found missing) on entry.
+		/// @returns true if any were dropped.
+		bool dropUnlinkedItems()
+		{
+			auto& initialStack = bblock.m_initialStack;
+			auto& exitStack = bblock.m_currentStack;
+			bool dropped = false;
+			for (auto it = passThrough.begin(); it != passThrough.end();)
+			{
+				auto initialIt = std::find(initialStack.begin(), initialStack.end(), *it);
+				assert(initialIt != initialStack.end());
+				if ((size_t)(initialIt - initialStack.begin()) < inputItems)
+				{
+					++it;
+					continue;
+				}
+				*initialIt = nullptr;
+				std::replace(exitStack.begin(), exitStack.end(), static_cast<llvm::Value*>(*it), static_cast<llvm::Value*>(nullptr));
+				(*it)->eraseFromParent();
+				it = passThrough.erase(it);
+				dropped = true;
+			}
+			return dropped;
+		}
 	};
 
 	std::map<llvm::BasicBlock*, BBInfo> cfg;
@@ -223,8 +277,8 @@ void BasicBlock::linkLocalStacks(std::vector<BasicBlock*> basicBlocks, llvm::IRB
 	for (auto bb : basicBlocks)
 		cfg.emplace(bb->llvm(), *bb);
 
-	// Create edges in cfg: for each bb info fill the list
-	// of predecessor infos.
+	// Create edges in cfg: for each bb info fill the lists
+	// of predecessor and successor infos.
 	for (auto& pair : cfg)
 	{
 		auto bb = pair.first;
@@ -234,45 +288,90 @@ void BasicBlock::linkLocalStacks(std::vector<BasicBlock*> basicBlocks, llvm::IRB
 		{
 			auto predInfoEntry = cfg.find(*predIt);
 			if (predInfoEntry != cfg.end())
+			{
 				info.predecessors.push_back(&predInfoEntry->second);
+				predInfoEntry->second.successors.push_back(&info);
+			}
 		}
 	}
 
-	// Iteratively compute inputs and outputs of each block, until reaching fixpoint.
-	bool valuesChanged = true;
-	while (valuesChanged)
-	{
-		if (getenv("EVMCC_DEBUG_BLOCKS"))
-		{
-			for (auto& pair : cfg)
-				std::cerr << pair.second.bblock.llvm()->getName().str()
-						  << ": in " << pair.second.inputItems
-						  << ", out " << pair.second.outputItems
-						  << "\n";
-		}
+	// Let blocks forward the items they do not touch, so that a value can travel
+	// in registers past blocks that do not use it to the block that does.
+	// The number of items a block wants to receive is capped by what any block
+	// reads by itself, otherwise a loop that pops more than it pushes would never settle.
+	size_t maxInputItems = 0;
+	for (auto& pair : cfg)
+		maxInputItems = std::max(maxInputItems, pair.second.inputItems);
 
-		valuesChanged = false;
+	bool forwarded = true;
+	while (forwarded)
+	{
+		forwarded = false;
 		for (auto& pair : cfg)
 		{
 			auto& info = pair.second;
-
 			if (info.predecessors.empty())
-				info.inputItems = 0; // no consequences for other blocks, so leave valuesChanged false
+				continue; // nothing to forward items from
 
-			for (auto predInfo : info.predecessors)
+			size_t wanted = 0;
+			for (auto succInfo : info.successors)
+				wanted = std::max(wanted, succInfo->inputItems);
+			wanted = std::min(wanted, maxInputItems);
+
+			while (info.outputItems < wanted && info.forwardItem(_builder))
+				forwarded = true;
+		}
+	}
+
+	// Iteratively compute inputs and outputs of each block, until reaching fixpoint.
+	// Forwarded items which are not linked in the end are dropped and the counts recomputed,
+	// until every forwarded item left is fed by all the predecessors.
+	bool itemsDropped = true;
+	while (itemsDropped)
+	{
+		bool valuesChanged = true;
+		while (valuesChanged)
+		{
+			if (getenv("EVMCC_DEBUG_BLOCKS"))
 			{
-				if (predInfo->outputItems < info.inputItems)
-				{
-					info.inputItems = predInfo->outputItems;
-					valuesChanged = true;
-				}
-				else if (predInfo->outputItems > info.inputItems)
+				for (auto& pair : cfg)
+					std::cerr << pair.second.bblock.llvm()->getName().str()
+							  << ": in " << pair.second.inputItems
+							  << ", out " << pair.second.outputItems
+							  << "\n";
+			}
+
+			valuesChanged = false;
+			for (auto& pair : cfg)
+			{
+				auto& info = pair.second;
+
+				if (info.predecessors.empty())
+					info.inputItems = 0; // no consequences for other blocks, so leave valuesChanged false
+
+				for (auto predInfo : info.predecessors)
 				{
-					predInfo->outputItems = info.inputItems;
-					valuesChanged = true;
+					if (predInfo->outputItems < info.inputItems)
+					{
+						info.inputItems = predInfo->outputItems;
+						valuesChanged = true;
+					}
+					else if (predInfo->outputItems > info.inputItems)
+					{
+						predInfo->outputItems = info.inputItems;
+						valuesChanged = true;
+					}
 				}
 			}
 		}
+
+		itemsDropped = false;
+		for (auto& pair : cfg)
+			itemsDropped = pair.second.dropUnlinkedItems() || itemsDropped;
+
+		if (itemsDropped)
+			for (auto& pair : cfg)
+				pair.second.count();
 	}
 
 	// Propagate values between blocks.
@@ -187,6 +187,11 @@ std::unique_ptr<llvm::Module> Compiler::compile(code_iterator _begin, code_itera
 
 	removeDeadBlocks();
 
+	std::vector<llvm::BasicBlock*> llvmBlocks;
+	for (auto& entry : m_basicBlocks)
+		llvmBlocks.push_back(entry.second.llvm());
+	gasMeter.mergeCostBlocks(llvmBlocks);
+
 	// Link jump table target index
 	if (m_jumpTableBlock)
 	{
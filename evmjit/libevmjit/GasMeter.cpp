@@ -124,17 +124,44 @@ void GasMeter::count(Instruction _inst)
 }
 
 void GasMeter::count(llvm::Value* _cost)
+{
+	if (_cost->getType() == Type::Word)
+		_cost = clampCost(_cost);
+
+	assert(_cost->getType() == Type::Gas);
+	createCall(m_gasCheckFunc, {m_runtimeManager.getRuntimePtr(), _cost});
+}
+
+llvm::Value* GasMeter::clampCost(llvm::Value* _cost)
 {
 	if (_cost->getType() == Type::Word)
 	{
 		auto gasMax256 = m_builder.CreateZExt(Constant::gasMax, Type::Word);
 		auto tooHigh = m_builder.CreateICmpUGT(_cost, gasMax256, "costTooHigh");
 		auto cost64 = m_builder.CreateTrunc(_cost, Type::Gas);
-		_cost = m_builder.CreateSelect(tooHigh, Constant::gasMax, cost64, "cost");
+		return m_builder.CreateSelect(tooHigh, Constant::gasMax, cost64, "cost");
 	}
 
 	assert(_cost->getType() == Type::Gas);
-	createCall(m_gasCheckFunc, {m_runtimeManager.getRuntimePtr(), _cost});
+	auto tooHigh = m_builder.CreateICmpUGT(_cost, Constant::gasMax, "costTooHigh");
+	return m_builder.CreateSelect(tooHigh, Constant::gasMax, _cost, "cost");
+}
+
+void GasMeter::countDeferred(llvm::Value* _cost)
+{
+	// Running out of gas aborts the whole execution wherever it happens, so the dynamic costs
+	// of a cost-block can be checked together at its end, as long as nothing reads the gas
+	// in between. Anything that does, commits the cost-block first.
+	_cost = clampCost(_cost);
+	if (!m_deferredCost)
+	{
+		m_deferredCost = _cost;
+		return;
+	}
+
+	// Both summands are at most gasMax so the unsigned sum cannot wrap
+	auto sum = m_builder.CreateNUWAdd(m_deferredCost, _cost);
+	m_deferredCost = clampCost(sum);
 }
 
 void GasMeter::countExp(llvm::Value* _exponent)
@@ -150,7 +177,7 @@ void GasMeter::countExp(llvm::Value* _exponent)
 	auto lz = m_builder.CreateTrunc(lz256, Type::Gas, "lz");
 	auto sigBits = m_builder.CreateSub(m_builder.getInt64(256), lz, "sigBits");
 	auto sigBytes = m_builder.CreateUDiv(m_builder.CreateAdd(sigBits, m_builder.getInt64(7)), m_builder.getInt64(8));
-	count(sigBytes);
+	countDeferred(sigBytes);
 }
 
 void GasMeter::countSStore(Ext& _ext, llvm::Value* _index, llvm::Value* _newValue)
@@ -164,7 +191,7 @@ void GasMeter::countSStore(Ext& _ext, llvm::Value* _index, llvm::Value* _newValu
 	auto isDelete = m_builder.CreateAnd(oldValueIsntZero, newValueIsZero, "isDelete");
 	auto cost = m_builder.CreateSelect(isInsert, m_builder.getInt64(c_sstoreSetGas), m_builder.getInt64(c_sstoreResetGas), "cost");
 	cost = m_builder.CreateSelect(isDelete, m_builder.getInt64(0), cost, "cost");
-	count(cost);
+	countDeferred(cost);
 }
 
 void GasMeter::countLogData(llvm::Value* _dataLength)
@@ -172,7 +199,7 @@ void GasMeter::countLogData(llvm::Value* _dataLength)
 	assert(m_checkCall);
 	assert(m_blockCost > 0); // LOGn instruction is already counted
 	static_assert(c_logDataGas == 1, "Log data gas cost has changed. Update GasMeter.");
-	count(_dataLength);
+	countDeferred(_dataLength);
 }
 
 void GasMeter::countSha3Data(llvm::Value* _dataLength)
@@ -185,7 +212,7 @@ void GasMeter::countSha3Data(llvm::Value* _dataLength)
 	auto dataLength64 = getBuilder().CreateTrunc(_dataLength, Type::Gas);
 	auto words64 = m_builder.CreateUDiv(m_builder.CreateNUWAdd(dataLength64, getBuilder().getInt64(31)), getBuilder().getInt64(32));
 	auto cost64 = m_builder.CreateNUWMul(getBuilder().getInt64(c_sha3WordGas), words64);
-	count(cost64);
+	countDeferred(cost64);
 }
 
 void GasMeter::giveBack(llvm::Value* _gas)
@@ -196,6 +223,21 @@ void GasMeter::giveBack(llvm::Value* _gas)
 
 void GasMeter::commitCostBlock()
 {
+	if (m_deferredCost)
+	{
+		// Check before leaving the block if it is already terminated
+		InsertPointGuard guard(m_builder);
+		if (auto terminator = m_builder.GetInsertBlock()->getTerminator())
+			m_builder.SetInsertPoint(terminator);
+		count(m_deferredCost);
+		m_deferredCost = nullptr;
+	}
+
+	// The first cost-block committed in a basic block starts it; the last one committed reaches its end
+	auto bb = m_builder.GetInsertBlock();
+	auto check = (m_checkCall && m_blockCost != 0 && m_checkCall->getParent() == bb) ? m_checkCall : nullptr;
+	m_blockChecks.emplace(bb, std::make_pair(check, nullptr)).first->second.second = check;
+
 	// If any uncommited block
 	if (m_checkCall)
 	{
@@ -213,6 +255,45 @@ void GasMeter::commitCostBlock()
 	assert(m_blockCost == 0);
 }
 
+void GasMeter::mergeCostBlocks(std::vector<llvm::BasicBlock*> const& _blocks)
+{
+	// A block whose only way in is the end of its predecessor, which leads nowhere else, runs exactly
+	// when the predecessor's last cost-block completes. Checking both costs there changes at most the point
+	// at which gas runs out, and so nothing else: the execution is aborted either way.
+	for (auto bb : _blocks)
+	{
+		auto pred = bb->getUniquePredecessor();
+		if (!pred || pred == bb)
+			continue;
+
+		auto terminator = pred->getTerminator();
+		bool leadsOnlyHere = true;
+		for (unsigned i = 0; i < terminator->getNumSuccessors(); ++i)
+			leadsOnlyHere = leadsOnlyHere && terminator->getSuccessor(i) == bb;
+
+		auto predChecks = m_blockChecks.find(pred);
+		auto checks = m_blockChecks.find(bb);
+		if (!leadsOnlyHere || predChecks == m_blockChecks.end() || checks == m_blockChecks.end())
+			continue;
+
+		auto target = predChecks->second.second;
+		auto check = checks->second.first;
+		if (!target || !check || target == check)
+			continue;
+
+		auto cost = llvm::cast<llvm::ConstantInt>(target->getArgOperand(1))->getSExtValue() +
+					llvm::cast<llvm::ConstantInt>(check->getArgOperand(1))->getSExtValue();
+		target->setArgOperand(1, m_builder.getInt64(cost));
+
+		// The block and the ones merged into it so far now end in the predecessor's cost-block
+		checks->second.first = nullptr;
+		for (auto& entry : m_blockChecks)
+			if (entry.second.second == check)
+				entry.second.second = target;
+		check->eraseFromParent();
+	}
+}
+
 void GasMeter::countMemory(llvm::Value* _additionalMemoryInWords)
 {
 	static_assert(c_memoryGas == 1, "Memory gas cost has changed. Update GasMeter.");
@@ -222,7 +303,7 @@ void GasMeter::countMemory(llvm::Value* _additionalMemoryInWords)
 void GasMeter::countCopy(llvm::Value* _copyWords)
 {
 	static_assert(c_copyGas == 1, "Copy gas cost has changed. Update GasMeter.");
-	count(_copyWords);
+	countDeferred(_copyWords);
 }
 
 }
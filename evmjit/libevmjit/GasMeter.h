@@ -1,5 +1,7 @@
 #pragma once
 
+#include <map>
+
 #include "CompilerHelper.h"
 #include "Instruction.h"
 
@@ -35,8 +37,14 @@ public:
 	void countSha3Data(llvm::Value* _dataLength);
 
 	/// Finalize cost-block by checking gas needed for the block before the block
+	/// and the dynamic costs counted within the block at its end
 	void commitCostBlock();
 
+	/// Move the static cost of each of the blocks entered only from the end of another block
+	/// into the last cost-block of that other block, so that passing between them checks gas once.
+	/// To be called once all the blocks are compiled and the dead ones removed.
+	void mergeCostBlocks(std::vector<llvm::BasicBlock*> const& _blocks);
+
 	/// Give back an amount of gas not used by a call
 	void giveBack(llvm::Value* _gas);
 
@@ -47,11 +55,24 @@ public:
 	void countCopy(llvm::Value* _copyWords);
 
 private:
+	/// Add a dynamic cost to be checked when the cost-block is committed
+	void countDeferred(llvm::Value* _cost);
+
+	/// Convert a cost to Type::Gas, saturating at Constant::gasMax
+	llvm::Value* clampCost(llvm::Value* _cost);
+
 	/// Cumulative gas cost of a block of instructions
 	/// @TODO Handle overflow
 	int64_t m_blockCost = 0;
 
 	llvm::CallInst* m_checkCall = nullptr;
+
+	/// Sum of the dynamic costs of the current cost-block, not checked yet
+	llvm::Value* m_deferredCost = nullptr;
+
+	/// Checks of the first and of the last cost-block of each basic block.
+	/// Null if the cost-block costs nothing or, for the last one, does not reach the end of the basic block.
+	std::map<llvm::BasicBlock*, std::pair<llvm::CallInst*, llvm::CallInst*>> m_blockChecks;
 	llvm::Function* m_gasCheckFunc = nullptr;
 
 	RuntimeManager& m_runtimeManager;
@@ -1,5 +1,7 @@
 #include "Memory.h"
 
+#include <algorithm>
+
 #include "preprocessor/llvm_includes_start.h"
 #include <llvm/IR/IntrinsicInst.h>
 #include "preprocessor/llvm_includes_end.h"
@@ -163,18 +165,38 @@ llvm::Function* Memory::getStoreByteFunc()
 
 llvm::Value* Memory::loadWord(llvm::Value* _addr)
 {
-	return createCall(getLoadWordFunc(), {getRuntimeManager().getRuntimePtr(), _addr});
+	if (isRequired(_addr, 32))
+	{
+		auto ptr = m_builder.CreateBitCast(getBytePtr(_addr), Type::WordPtr, "wordPtr");
+		return Endianness::toNative(m_builder, m_builder.CreateLoad(ptr));
+	}
+	auto ret = createCall(getLoadWordFunc(), {getRuntimeManager().getRuntimePtr(), _addr});
+	markRequired(_addr, Constant::get(32));
+	return ret;
 }
 
 void Memory::storeWord(llvm::Value* _addr, llvm::Value* _word)
 {
+	if (isRequired(_addr, 32))
+	{
+		auto ptr = m_builder.CreateBitCast(getBytePtr(_addr), Type::WordPtr, "wordPtr");
+		m_builder.CreateStore(Endianness::toBE(m_builder, _word), ptr);
+		return;
+	}
 	createCall(getStoreWordFunc(), {getRuntimeManager().getRuntimePtr(), _addr, _word});
+	markRequired(_addr, Constant::get(32));
 }
 
 void Memory::storeByte(llvm::Value* _addr, llvm::Value* _word)
 {
 	auto byte = m_builder.CreateTrunc(_word, Type::Byte, "byte");
+	if (isRequired(_addr, 1))
+	{
+		m_builder.CreateStore(byte, getBytePtr(_addr));
+		return;
+	}
 	createCall(getStoreByteFunc(), {getRuntimeManager().getRuntimePtr(), _addr, byte});
+	markRequired(_addr, Constant::get(1));
 }
 
 llvm::Value* Memory::getData()
@@ -203,8 +225,35 @@ void Memory::require(llvm::Value* _offset, llvm::Value* _size)
 	{
 		if (!constant->getValue())
 			return;
+		if (constant->getValue().getActiveBits() <= 32 && isRequired(_offset, constant->getZExtValue()))
+			return;
 	}
 	createCall(getRequireFunc(), {getRuntimeManager().getRuntimePtr(), _offset, _size});
+	markRequired(_offset, _size);
+}
+
+bool Memory::isRequired(llvm::Value* _offset, uint64_t _size)
+{
+	auto offset = llvm::dyn_cast<llvm::ConstantInt>(_offset);
+	if (!offset || offset->getValue().getActiveBits() > 32 || m_builder.GetInsertBlock() != m_requiredBlock)
+		return false;
+	return offset->getZExtValue() + _size <= m_requiredEnd;
+}
+
+void Memory::markRequired(llvm::Value* _offset, llvm::Value* _size)
+{
+	auto offset = llvm::dyn_cast<llvm::ConstantInt>(_offset);
+	auto size = llvm::dyn_cast<llvm::ConstantInt>(_size);
+	if (!offset || !size || offset->getValue().getActiveBits() > 32 || size->getValue().getActiveBits() > 32)
+		return;
+
+	auto end = offset->getZExtValue() + size->getZExtValue();
+	if (m_builder.GetInsertBlock() != m_requiredBlock)
+	{
+		m_requiredBlock = m_builder.GetInsertBlock();
+		m_requiredEnd = 0;
+	}
+	m_requiredEnd = std::max(m_requiredEnd, end);
 }
 
 void Memory::copyBytes(llvm::Value* _srcPtr, llvm::Value* _srcSize, llvm::Value* _srcIdx,
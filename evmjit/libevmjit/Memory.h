@@ -28,8 +28,20 @@ public:
 	void require(llvm::Value* _offset, llvm::Value* _size);
 
 private:
+	/// @returns true if memory at constant @a _offset of @a _size bytes has already been required
+	/// earlier in the current basic block (and so dominates the insert point).
+	bool isRequired(llvm::Value* _offset, uint64_t _size);
+
+	/// Records that the memory at constant @a _offset of @a _size bytes has been required.
+	void markRequired(llvm::Value* _offset, llvm::Value* _size);
+
 	GasMeter& m_gasMeter;
 
+	/// The basic block and the end of the constant range required so far within it.
+	/// Memory never shrinks, so no later require() below that end can resize memory or cost gas.
+	llvm::BasicBlock* m_requiredBlock = nullptr;
+	uint64_t m_requiredEnd = 0;
+
 	llvm::Function* createFunc(bool _isStore, llvm::Type* _type, GasMeter& _gasMeter);
 
 	llvm::Function* getRequireFunc();
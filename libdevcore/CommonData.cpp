@@ -67,51 +67,100 @@ std::string dev::randomWord()
 	return ret;
 }
 
+/// The value of each character as a hex digit, or -1 if it isn't one.
+static signed char const c_hexValues[256] =
+{
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	0, 1, 2, 3, 4, 5, 6, 7, 8, 9, -1, -1, -1, -1, -1, -1,
+	-1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+};
+
+char* dev::writeHex(bytesConstRef _data, char* o_out)
+{
+	for (byte b: _data)
+	{
+		*o_out++ = c_hexDigits[b >> 4];
+		*o_out++ = c_hexDigits[b & 0xf];
+	}
+	return o_out;
+}
+
+bool dev::readHex(char const* _hex, size_t _size, byte* o_out)
+{
+	// Accumulate the bad digits rather than branch on each one.
+	int bad = 0;
+	for (char const* end = _hex + _size; _hex != end; _hex += 2)
+	{
+		int h = c_hexValues[(byte)_hex[0]];
+		int l = c_hexValues[(byte)_hex[1]];
+		bad |= h | l;
+		*o_out++ = (byte)(h * 16 + l);
+	}
+	return bad >= 0;
+}
+
 int dev::fromHex(char _i)
 {
-	if (_i >= '0' && _i <= '9')
-		return _i - '0';
-	if (_i >= 'a' && _i <= 'f')
-		return _i - 'a' + 10;
-	if (_i >= 'A' && _i <= 'F')
-		return _i - 'A' + 10;
-	BOOST_THROW_EXCEPTION(BadHexCharacter() << errinfo_invalidSymbol(_i));
+	int ret = c_hexValues[(byte)_i];
+	if (ret < 0)
+		BOOST_THROW_EXCEPTION(BadHexCharacter() << errinfo_invalidSymbol(_i));
+	return ret;
 }
 
 bytes dev::fromHex(std::string const& _s, ThrowType _throw)
 {
 	unsigned s = (_s[0] == '0' && _s[1] == 'x') ? 2 : 0;
-	std::vector<uint8_t> ret;
-	ret.reserve((_s.size() - s + 1) / 2);
+	bytes ret((_s.size() - s + 1) / 2);
+	byte* o = ret.data();
 
-	if (_s.size() % 2)
+	// Replaces a bad digit with 0, or throws.
+	auto digit = [&](char _c) -> int
+	{
 		try
 		{
-			ret.push_back(fromHex(_s[s++]));
+			return fromHex(_c);
 		}
 		catch (...)
-		{ 
-			ret.push_back(0);
-			// msvc does not support it
-#ifndef BOOST_NO_EXCEPTIONS
-			cwarn << boost::current_exception_diagnostic_information(); 
-#endif
-			if (_throw == ThrowType::Throw)
-				throw;
-		}
-	for (unsigned i = s; i < _s.size(); i += 2)
-		try
 		{
-			ret.push_back((byte)(fromHex(_s[i]) * 16 + fromHex(_s[i + 1])));
-		}
-		catch (...){
-			ret.push_back(0);
+			// msvc does not support it
 #ifndef BOOST_NO_EXCEPTIONS
 			cwarn << boost::current_exception_diagnostic_information();
 #endif
 			if (_throw == ThrowType::Throw)
 				throw;
+			return -1;
 		}
+	};
+
+	if ((_s.size() - s) % 2)
+	{
+		int v = digit(_s[s++]);
+		*o++ = v < 0 ? 0 : (byte)v;
+	}
+	unsigned n = (unsigned)(_s.size() - s) / 2;
+	if (readHex(_s.data() + s, n * 2, o))
+		return ret;
+
+	// Some digit is bad; go through again, dealing with each bad pair as it comes.
+	for (unsigned i = s; i < _s.size(); i += 2, ++o)
+	{
+		int h = digit(_s[i]);
+		int l = h < 0 ? 0 : digit(_s[i + 1]);
+		*o = h < 0 || l < 0 ? 0 : (byte)(h * 16 + l);
+	}
 	return ret;
 }
 
@@ -41,18 +41,43 @@ enum class ThrowType
 	Throw = 1,
 };
 
+/// The lower-case hex digits, by value.
+static char const c_hexDigits[] = "0123456789abcdef";
+
 /// Convert a series of bytes to the corresponding string of hex duplets.
 /// @param _w specifies the width of each of the elements. Defaults to two - enough to represent a byte.
 /// @example toHex("A\x69") == "4169"
 template <class _T>
 std::string toHex(_T const& _data, int _w = 2)
 {
+	if (_w == 2 && sizeof(*std::begin(_data)) == 1)
+	{
+		// Bytes (or chars): straight from the table, into a string allocated once.
+		std::string ret(_data.size() * 2, '0');
+		char* o = &ret[0];
+		for (auto i: _data)
+		{
+			byte b = (byte)i;
+			*o++ = c_hexDigits[b >> 4];
+			*o++ = c_hexDigits[b & 0xf];
+		}
+		return ret;
+	}
 	std::ostringstream ret;
 	for (auto i: _data)
 		ret << std::hex << std::setfill('0') << std::setw(_w) << (int)(typename std::make_unsigned<decltype(i)>::type)i;
 	return ret.str();
 }
 
+/// Writes the hex duplets of @a _data to @a o_out, which must have room for 2 * _data.size() characters.
+/// @returns the end of what was written.
+char* writeHex(bytesConstRef _data, char* o_out);
+
+/// Decodes the @a _size hex characters (no prefix, an even number) at @a _hex into @a o_out, which must have
+/// room for _size / 2 bytes.
+/// @returns false, having written some unspecified part of @a o_out, if any of them isn't a hex digit.
+bool readHex(char const* _hex, size_t _size, byte* o_out);
+
 /// Converts a (printable) ASCII hex character into the correspnding integer value.
 /// @example fromHex('A') == 10 && fromHex('f') == 15 && fromHex('5') == 5
 int fromHex(char _i);
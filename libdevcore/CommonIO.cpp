@@ -26,7 +26,7 @@
 using namespace std;
 using namespace dev;
 
-string dev::memDump(bytes const& _bytes, unsigned _width, bool _html)
+string dev::memDump(bytesConstRef _bytes, unsigned _width, bool _html)
 {
 	stringstream ret;
 	if (_html)
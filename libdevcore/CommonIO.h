@@ -48,7 +48,8 @@ void writeFile(std::string const& _file, bytes const& _data);
 
 /// Nicely renders the given bytes to a string, optionally as HTML.
 /// @a _bytes: bytes array to be rendered as string. @a _width of a bytes line.
-std::string memDump(bytes const& _bytes, unsigned _width = 8, bool _html = false);
+std::string memDump(bytesConstRef _bytes, unsigned _width = 8, bool _html = false);
+inline std::string memDump(bytes const& _bytes, unsigned _width = 8, bool _html = false) { return memDump(bytesConstRef(&_bytes), _width, _html); }
 
 // Stream I/O functions.
 // Provides templated stream I/O for all STL collections so they can be shifted on to any iostream-like interface.
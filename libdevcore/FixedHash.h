@@ -24,6 +24,7 @@
 #pragma once
 
 #include <array>
+#include <cstring>
 #include <random>
 #include <algorithm>
 #include "CommonData.h"
@@ -74,7 +75,18 @@ public:
 	explicit FixedHash(byte const* _bs, ConstructFromPointerType) { memcpy(m_data.data(), _bs, N); }
 
 	/// Explicitly construct, copying from a  string.
-	explicit FixedHash(std::string const& _s, ConstructFromStringType _t = FromHex): FixedHash(_t == FromHex ? fromHex(_s) : dev::asBytes(_s)) {}
+	explicit FixedHash(std::string const& _s, ConstructFromStringType _t = FromHex)
+	{
+		// Exactly N bytes of valid hex, the usual case, is decoded in place; anything else goes the long way round.
+		unsigned p = (_s.size() >= 2 && _s[0] == '0' && _s[1] == 'x') ? 2 : 0;
+		if (_t != FromHex || _s.size() - p != N * 2 || !readHex(_s.data() + p, N * 2, m_data.data()))
+		{
+			bytes b = _t == FromHex ? fromHex(_s) : dev::asBytes(_s);
+			m_data.fill(0);
+			if (b.size() == N)
+				memcpy(m_data.data(), b.data(), N);
+		}
+	}
 
 	/// Convert to arithmetic type.
 	operator Arith() const { return fromBigEndian<Arith>(m_data); }
@@ -144,13 +156,20 @@ public:
 	/// A generic std::hash compatible function object.
 	struct hash
 	{
-		/// Make a hash of the object's data.
+		/// Make a hash of the object's data. It's usually itself a hash, so folding it a word at a time is enough.
 		size_t operator()(FixedHash const& value) const
 		{
-			size_t h = 0;
-			for (auto i: value.m_data)
-				h = (h << (5 - h)) + i;
-			return h;
+			uint64_t h = 0;
+			unsigned i = 0;
+			for (; i + sizeof(uint64_t) <= N; i += sizeof(uint64_t))
+			{
+				uint64_t w;
+				memcpy(&w, value.m_data.data() + i, sizeof(uint64_t));
+				h ^= w;
+			}
+			for (; i < N; ++i)
+				h ^= (uint64_t)value.m_data[i] << (8 * (i % sizeof(uint64_t)));
+			return (size_t)h;
 		}
 	};
 
@@ -232,11 +251,9 @@ template<> inline size_t FixedHash<32>::hash::operator()(FixedHash<32> const& va
 template <unsigned N>
 inline std::ostream& operator<<(std::ostream& _out, FixedHash<N> const& _h)
 {
-	_out << std::noshowbase << std::hex << std::setfill('0');
-	for (unsigned i = 0; i < N; ++i)
-		_out << std::setw(2) << (int)_h[i];
-	_out << std::dec;
-	return _out;
+	char buf[N * 2];
+	writeHex(_h.ref(), buf);
+	return _out.write(buf, N * 2);
 }
 
 // Common types of FixedHash.
@@ -283,4 +300,6 @@ namespace std
 {
 	/// Forward std::hash<dev::h256> to dev::h256::hash.
 	template<> struct hash<dev::h256>: dev::h256::hash {};
+	/// Forward std::hash<dev::h160> (i.e. dev::Address) to dev::h160::hash.
+	template<> struct hash<dev::h160>: dev::h160::hash {};
 }
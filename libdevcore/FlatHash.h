@@ -0,0 +1,334 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file FlatHash.h
+ * @date 2015
+ *
+ * Open-addressing hash map and set.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace dev
+{
+
+namespace detail
+{
+/// @returns a random value, fixed for the life of the process, mixed into every FlatHashTable slot choice.
+inline uint64_t flatHashSeed()
+{
+	static uint64_t const s_seed = (uint64_t(std::random_device()()) << 32) | std::random_device()();
+	return s_seed;
+}
+}
+
+/**
+ * @brief The table behind FlatHashMap and FlatHashSet.
+ * All entries live in a single array, found by linear probing from the slot their hash picks; erasing shifts
+ * the following entries of the run back, so there are no tombstones. The table doubles once three quarters full.
+ * The key's hash is mixed with a per-process random seed before picking a slot, so that keys chosen by a remote
+ * party (e.g. hashes of blocks from a peer) can't be ground to pile up in one run unless their whole hash collides.
+ * Unlike std::map and std::set, inserting or erasing invalidates all iterators, pointers and references into
+ * the table, and the order of iteration is unspecified. Keys and values must be default-constructible.
+ */
+template <class K, class T, class KeyOf, class H>
+class FlatHashTable
+{
+protected:
+	struct Slot
+	{
+		T value;
+		bool used = false;
+	};
+
+private:
+	template <class S, class R> class Iterator
+	{
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = typename std::remove_const<R>::type;
+		using difference_type = std::ptrdiff_t;
+		using pointer = R*;
+		using reference = R&;
+
+		Iterator() {}
+		Iterator(S* _s, S* _end): m_s(_s), m_end(_end) { skip(); }
+		template <class S2, class R2> Iterator(Iterator<S2, R2> const& _i): m_s(_i.m_s), m_end(_i.m_end) {}
+
+		R& operator*() const { return m_s->value; }
+		R* operator->() const { return &m_s->value; }
+		Iterator& operator++() { ++m_s; skip(); return *this; }
+		Iterator operator++(int) { Iterator ret = *this; ++*this; return ret; }
+		bool operator==(Iterator const& _i) const { return m_s == _i.m_s; }
+		bool operator!=(Iterator const& _i) const { return m_s != _i.m_s; }
+
+	private:
+		template <class, class, class, class> friend class FlatHashTable;
+		template <class, class> friend class Iterator;
+
+		void skip() { while (m_s != m_end && !m_s->used) ++m_s; }
+
+		S* m_s = nullptr;
+		S* m_end = nullptr;
+	};
+
+public:
+	using key_type = K;
+	using value_type = T;
+	using size_type = size_t;
+	using hasher = H;
+	using iterator = Iterator<Slot, T>;
+	using const_iterator = Iterator<Slot const, T const>;
+
+	FlatHashTable() {}
+	FlatHashTable(FlatHashTable const&) = default;
+	FlatHashTable(FlatHashTable&& _t): m_slots(std::move(_t.m_slots)), m_size(_t.m_size) { _t.m_slots.clear(); _t.m_size = 0; }
+	template <class I> FlatHashTable(I _begin, I _end) { insert(_begin, _end); }
+	FlatHashTable(std::initializer_list<T> _l) { insert(_l.begin(), _l.end()); }
+
+	FlatHashTable& operator=(FlatHashTable const&) = default;
+	FlatHashTable& operator=(FlatHashTable&& _t) { if (this != &_t) { m_slots = std::move(_t.m_slots); m_size = _t.m_size; _t.m_slots.clear(); _t.m_size = 0; } return *this; }
+
+	iterator begin() { return iterator(m_slots.data(), m_slots.data() + m_slots.size()); }
+	iterator end() { return iterator(m_slots.data() + m_slots.size(), m_slots.data() + m_slots.size()); }
+	const_iterator begin() const { return const_iterator(m_slots.data(), m_slots.data() + m_slots.size()); }
+	const_iterator end() const { return const_iterator(m_slots.data() + m_slots.size(), m_slots.data() + m_slots.size()); }
+
+	size_t size() const { return m_size; }
+	bool empty() const { return !m_size; }
+
+	size_t bucket_count() const { return m_slots.size(); }
+
+	/// Removes all entries but keeps the table, so that refilling it to the same size needs no growth.
+	void clear()
+	{
+		if (m_size)
+			for (Slot& s: m_slots)
+				if (s.used)
+				{
+					s.value = T();
+					s.used = false;
+				}
+		m_size = 0;
+	}
+
+	/// Makes room for @a _n entries in total without any further growth.
+	void reserve(size_t _n)
+	{
+		size_t c = capacityFor(_n);
+		if (c > m_slots.size())
+			rehash(c);
+	}
+
+	/// Frees as much of the table as the entries held allow; all of it if there are none.
+	void shrink_to_fit()
+	{
+		if (!m_size)
+			std::vector<Slot>().swap(m_slots);
+		else if (capacityFor(m_size) < m_slots.size())
+			rehash(capacityFor(m_size));
+	}
+
+	iterator find(K const& _k) { return iterator(findSlot(_k), m_slots.data() + m_slots.size()); }
+	const_iterator find(K const& _k) const { return const_iterator(findSlot(_k), m_slots.data() + m_slots.size()); }
+	size_t count(K const& _k) const { return findSlot(_k) != m_slots.data() + m_slots.size() ? 1 : 0; }
+
+	/// Inserts @a _v unless an entry with its key exists.
+	/// @returns the entry with that key and whether it was inserted.
+	std::pair<iterator, bool> insert(T const& _v) { return insertValue(T(_v)); }
+	std::pair<iterator, bool> insert(T&& _v) { return insertValue(std::move(_v)); }
+	template <class I> void insert(I _begin, I _end) { for (; _begin != _end; ++_begin) insert(*_begin); }
+
+	/// Erases the entry with key @a _k, if any. @returns the number of entries erased.
+	size_t erase(K const& _k)
+	{
+		Slot* s = findSlot(_k);
+		if (s == m_slots.data() + m_slots.size())
+			return 0;
+		eraseSlot(s - m_slots.data());
+		return 1;
+	}
+	void erase(const_iterator _it) { eraseSlot(_it.m_s - m_slots.data()); }
+
+	void swap(FlatHashTable& _t) { m_slots.swap(_t.m_slots); std::swap(m_size, _t.m_size); }
+
+	bool operator==(FlatHashTable const& _t) const
+	{
+		if (m_size != _t.m_size)
+			return false;
+		for (auto const& i: *this)
+		{
+			auto it = _t.find(KeyOf()(i));
+			if (it == _t.end() || !(*it == i))
+				return false;
+		}
+		return true;
+	}
+	bool operator!=(FlatHashTable const& _t) const { return !operator==(_t); }
+
+protected:
+	/// @returns the entry with key @a _k, inserting a value-initialised one first if there's none.
+	T& findOrInsert(K const& _k)
+	{
+		Slot* s = findSlot(_k);
+		if (s != m_slots.data() + m_slots.size())
+			return s->value;
+		T v;
+		KeyOf()(v) = _k;
+		return *insertValue(std::move(v)).first;
+	}
+
+	/// @returns true if @a _s is past the end of the table, as findSlot() returns when the key isn't there.
+	bool isEnd(Slot const* _s) const { return _s == m_slots.data() + m_slots.size(); }
+
+	/// @returns the slot in which a search for @a _k starts, given a table of @a _mask + 1 slots.
+	static size_t home(K const& _k, size_t _mask)
+	{
+		// The finaliser of MurmurHash3; every bit of the seeded hash affects the low bits we use.
+		uint64_t x = uint64_t(H()(_k)) ^ detail::flatHashSeed();
+		x ^= x >> 33;
+		x *= 0xff51afd7ed558ccdULL;
+		x ^= x >> 33;
+		x *= 0xc4ceb9fe1a85ec53ULL;
+		x ^= x >> 33;
+		return size_t(x) & _mask;
+	}
+
+	/// @returns the slot holding key @a _k, or the end of the table.
+	Slot* findSlot(K const& _k) const
+	{
+		Slot* slots = const_cast<Slot*>(m_slots.data());
+		if (!m_size)
+			return slots + m_slots.size();
+		size_t mask = m_slots.size() - 1;
+		for (size_t i = home(_k, mask);; i = (i + 1) & mask)
+			if (!slots[i].used)
+				return slots + m_slots.size();
+			else if (KeyOf()(slots[i].value) == _k)
+				return slots + i;
+	}
+
+private:
+	std::pair<iterator, bool> insertValue(T&& _v)
+	{
+		if ((m_size + 1) > m_slots.size() / 4 * 3)
+			rehash(m_slots.empty() ? 8 : m_slots.size() * 2);
+		size_t mask = m_slots.size() - 1;
+		size_t i = home(KeyOf()(_v), mask);
+		for (; m_slots[i].used; i = (i + 1) & mask)
+			if (KeyOf()(m_slots[i].value) == KeyOf()(_v))
+				return std::make_pair(iterator(&m_slots[i], m_slots.data() + m_slots.size()), false);
+		m_slots[i].value = std::move(_v);
+		m_slots[i].used = true;
+		++m_size;
+		return std::make_pair(iterator(&m_slots[i], m_slots.data() + m_slots.size()), true);
+	}
+
+	void eraseSlot(size_t _i)
+	{
+		size_t mask = m_slots.size() - 1;
+		// Shift back each following entry of the run that may sit no earlier than the hole.
+		for (size_t j = (_i + 1) & mask; m_slots[j].used; j = (j + 1) & mask)
+		{
+			size_t ideal = home(KeyOf()(m_slots[j].value), mask);
+			if (((j - ideal) & mask) >= ((j - _i) & mask))
+			{
+				m_slots[_i].value = std::move(m_slots[j].value);
+				_i = j;
+			}
+		}
+		m_slots[_i].value = T();
+		m_slots[_i].used = false;
+		--m_size;
+	}
+
+	/// @returns the number of slots that holds @a _n entries within the load limit.
+	static size_t capacityFor(size_t _n)
+	{
+		size_t c = 8;
+		while (c / 4 * 3 < _n)
+			c *= 2;
+		return c;
+	}
+
+	void rehash(size_t _capacity)
+	{
+		std::vector<Slot> old(_capacity);
+		old.swap(m_slots);
+		m_size = 0;
+		for (Slot& s: old)
+			if (s.used)
+				insertValue(std::move(s.value));
+	}
+
+	std::vector<Slot> m_slots;		///< Always empty or a power of two in size.
+	size_t m_size = 0;
+};
+
+namespace detail
+{
+template <class K, class V> struct PairKey
+{
+	K& operator()(std::pair<K, V>& _v) const { return _v.first; }
+	K const& operator()(std::pair<K, V> const& _v) const { return _v.first; }
+};
+template <class K> struct SelfKey
+{
+	K& operator()(K& _v) const { return _v; }
+	K const& operator()(K const& _v) const { return _v; }
+};
+}
+
+/// An open-addressing replacement for std::map/std::unordered_map; see FlatHashTable.
+/// The key of an entry must not be modified through an iterator.
+template <class K, class V, class H = std::hash<K>>
+class FlatHashMap: public FlatHashTable<K, std::pair<K, V>, detail::PairKey<K, V>, H>
+{
+	using Base = FlatHashTable<K, std::pair<K, V>, detail::PairKey<K, V>, H>;
+
+public:
+	using mapped_type = V;
+	using Base::Base;
+	FlatHashMap() {}
+
+	V& operator[](K const& _k) { return this->findOrInsert(_k).second; }
+	V& at(K const& _k) { auto s = this->findSlot(_k); if (this->isEnd(s)) throw std::out_of_range("FlatHashMap::at"); return s->value.second; }
+	V const& at(K const& _k) const { auto s = this->findSlot(_k); if (this->isEnd(s)) throw std::out_of_range("FlatHashMap::at"); return s->value.second; }
+};
+
+/// An open-addressing replacement for std::set/std::unordered_set; see FlatHashTable.
+template <class K, class H = std::hash<K>>
+class FlatHashSet: public FlatHashTable<K, K, detail::SelfKey<K>, H>
+{
+	using Base = FlatHashTable<K, K, detail::SelfKey<K>, H>;
+
+public:
+	using Base::Base;
+	FlatHashSet() {}
+};
+
+}
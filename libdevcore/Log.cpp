@@ -23,6 +23,13 @@
 
 #include <string>
 #include <iostream>
+#include <array>
+#include <atomic>
+#include <algorithm>
+#include <condition_variable>
+#include <memory>
+#include <thread>
+#include <vector>
 #include "Guards.h"
 using namespace std;
 using namespace dev;
@@ -56,3 +63,229 @@ void dev::simpleDebugOut(std::string const& _s, char const*)
 
 std::function<void(std::string const&, char const*)> dev::g_logPost = simpleDebugOut;
 
+namespace
+{
+
+/// A log line as queued by the logging thread, before formatting.
+struct QueuedLogLine
+{
+	chrono::system_clock::time_point time;
+	char const* channel;
+	bool term;
+	string thread;
+	string line;
+};
+
+/// Lock-free single-producer (the logging thread), single-consumer (the writer) ring of log lines.
+class LogRing
+{
+public:
+	bool push(QueuedLogLine&& _l)
+	{
+		unsigned t = m_tail.load(memory_order_relaxed);
+		unsigned n = (t + 1) % c_size;
+		if (n == m_head.load(memory_order_acquire))
+			return false;
+		m_lines[t] = move(_l);
+		m_tail.store(n, memory_order_release);
+		return true;
+	}
+
+	bool pop(QueuedLogLine& o_l)
+	{
+		unsigned h = m_head.load(memory_order_relaxed);
+		if (h == m_tail.load(memory_order_acquire))
+			return false;
+		o_l = move(m_lines[h]);
+		m_head.store((h + 1) % c_size, memory_order_release);
+		return true;
+	}
+
+	bool empty() const { return m_head.load(memory_order_acquire) == m_tail.load(memory_order_acquire); }
+
+private:
+	static const unsigned c_size = 1024;
+	array<QueuedLogLine, c_size> m_lines;
+	atomic<unsigned> m_head{0};
+	atomic<unsigned> m_tail{0};
+};
+
+string format(QueuedLogLine const& _l)
+{
+	time_t rawTime = chrono::system_clock::to_time_t(_l.time);
+	char buf[24];
+	if (strftime(buf, 24, "%X", localtime(&rawTime)) == 0)
+		buf[0] = '\0'; // empty if case strftime fails
+	string ret;
+	ret.reserve(_l.line.size() + 32);
+	ret += _l.channel;
+	ret += " [ ";
+	ret += buf;
+	ret += " | ";
+	ret += _l.thread;
+	if (_l.term)
+		ret += " ] ";
+	ret += _l.line;
+	return ret;
+}
+
+Mutex x_logPost;
+
+void postNow(QueuedLogLine const& _l)
+{
+	Guard l(x_logPost);
+	g_logPost(format(_l), _l.channel);
+}
+
+/// Drains every thread's ring, passing the lines to g_logPost in time order.
+class LogWriter
+{
+public:
+	LogWriter(): m_thread([=](){ setThreadName("log"); run(); }) {}
+
+	~LogWriter()
+	{
+		{
+			unique_lock<mutex> l(x_wake);
+			m_stopping = true;
+		}
+		m_wake.notify_all();
+		m_thread.join();
+	}
+
+	void post(QueuedLogLine&& _l)
+	{
+		if (!t_ring.get())
+		{
+			t_ring.reset(new shared_ptr<LogRing>(make_shared<LogRing>()));
+			Guard l(x_rings);
+			m_rings.push_back(*t_ring);
+		}
+		++m_posted;
+		// Should the writer be falling behind, wait for it rather than lose lines.
+		while (!(*t_ring)->push(move(_l)))
+		{
+			m_wake.notify_one();
+			this_thread::yield();
+		}
+	}
+
+	void flush()
+	{
+		if (this_thread::get_id() == m_thread.get_id())
+			return;
+		unsigned long long target = m_posted;
+		if (m_written >= target)
+			return;
+		unique_lock<mutex> l(x_wake);
+		m_wake.notify_one();
+		m_flushed.wait(l, [&](){ return m_written >= target; });
+	}
+
+private:
+	void run()
+	{
+		while (true)
+		{
+			if (!drain())
+			{
+				unique_lock<mutex> l(x_wake);
+				if (m_stopping)
+					break;
+				m_wake.wait_for(l, chrono::milliseconds(10));
+			}
+		}
+		drain();
+	}
+
+	/// @returns true if anything was written.
+	bool drain()
+	{
+		vector<shared_ptr<LogRing>> rings;
+		{
+			Guard l(x_rings);
+			// Forget the rings of threads that have finished, once we've had everything from them.
+			m_rings.erase(remove_if(m_rings.begin(), m_rings.end(), [](shared_ptr<LogRing> const& _r){ return _r.use_count() == 1 && _r->empty(); }), m_rings.end());
+			rings = m_rings;
+		}
+
+		m_batch.clear();
+		QueuedLogLine l;
+		for (auto const& r: rings)
+			while (r->pop(l))
+				m_batch.push_back(move(l));
+		if (m_batch.empty())
+			return false;
+
+		stable_sort(m_batch.begin(), m_batch.end(), [](QueuedLogLine const& _a, QueuedLogLine const& _b) { return _a.time < _b.time; });
+		{
+			Guard l(x_logPost);
+			for (auto const& i: m_batch)
+				g_logPost(format(i), i.channel);
+		}
+		m_written += m_batch.size();
+		{
+			// Taken so that a flush() between checking m_written and waiting can't miss this.
+			lock_guard<mutex> l(x_wake);
+		}
+		m_flushed.notify_all();
+		return true;
+	}
+
+	static boost::thread_specific_ptr<shared_ptr<LogRing>> t_ring;
+
+	Mutex x_rings;
+	vector<shared_ptr<LogRing>> m_rings;
+	vector<QueuedLogLine> m_batch;				///< Used only by the writer thread.
+	atomic<unsigned long long> m_posted{0};
+	atomic<unsigned long long> m_written{0};
+
+	mutex x_wake;
+	condition_variable m_wake;
+	condition_variable m_flushed;				///< Notified whenever m_written goes up.
+	bool m_stopping = false;
+	thread m_thread;
+};
+
+boost::thread_specific_ptr<shared_ptr<LogRing>> LogWriter::t_ring;
+
+/// Set once the writer has been destroyed at exit; anything logged after that is written synchronously.
+atomic<bool> s_writerGone{false};
+
+struct LogWriterHolder
+{
+	~LogWriterHolder() { s_writerGone = true; }
+	LogWriter writer;
+};
+
+LogWriter* logWriter()
+{
+	if (s_writerGone)
+		return nullptr;
+	static LogWriterHolder s_holder;
+	return &s_holder.writer;
+}
+
+}
+
+void dev::postLogLine(char const* _channel, chrono::system_clock::time_point _time, bool _term, string&& _line)
+{
+	QueuedLogLine l{_time, _channel, _term, t_logThreadName.m_name.get() ? *t_logThreadName.m_name.get() : string("<unknown>"), move(_line)};
+	if (auto w = logWriter())
+		w->post(move(l));
+	else
+		postNow(l);
+}
+
+void dev::flushLog()
+{
+	if (auto w = logWriter())
+		w->flush();
+}
+
+void dev::setLogPost(std::function<void(std::string const&, char const*)> const& _post)
+{
+	flushLog();
+	Guard l(x_logPost);
+	g_logPost = _post;
+}
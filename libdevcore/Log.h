@@ -19,12 +19,21 @@
  * @date 2014
  *
  * The logging subsystem.
+ *
+ * Log lines are queued on a per-thread lock-free ring together with a binary timestamp; a background
+ * writer thread adds the time and thread prefix and passes them, in time order, to g_logPost.
  */
 
 #pragma once
 
 #include <ctime>
 #include <chrono>
+#include <functional>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <string>
+#include <typeinfo>
 #include <boost/thread.hpp>
 #include "vector_ref.h"
 #include "CommonIO.h"
@@ -46,8 +55,16 @@ void simpleDebugOut(std::string const&, char const*);
 extern int g_logVerbosity;
 
 /// The current method that the logging system uses to output the log messages. Defaults to simpleDebugOut().
+/// It's called from the background log writer thread; change it with setLogPost().
 extern std::function<void(std::string const&, char const*)> g_logPost;
 
+/// Change g_logPost, first passing anything already logged to the old one.
+/// Once this returns, the old one won't be called again.
+void setLogPost(std::function<void(std::string const&, char const*)> const& _post);
+
+/// Block until everything logged so far has been passed to g_logPost.
+void flushLog();
+
 /// Map of Log Channel types to bool, false forces the channel to be disabled, true forces it to be enabled.
 /// If a channel has no entry, then it will output as long as its verbosity (LogChannel::verbosity) is less than
 /// or equal to the currently output verbosity (g_logVerbosity).
@@ -75,6 +92,21 @@ struct WarnChannel: public LogChannel  { static const char* name() { return "!!!
 struct NoteChannel: public LogChannel  { static const char* name() { return "***"; } };
 struct DebugChannel: public LogChannel { static const char* name() { return "---"; } static const int verbosity = 0; };
 
+/// @returns true if log channel Id currently outputs anything.
+template <class Id> bool isChannelVisible()
+{
+	if (!g_logOverride.empty())
+	{
+		auto it = g_logOverride.find(&typeid(Id));
+		if (it != g_logOverride.end())
+			return it->second;
+	}
+	return Id::verbosity <= g_logVerbosity;
+}
+
+/// Queue a log line for the background writer, which will prefix it with the channel, time and thread name.
+void postLogLine(char const* _channel, std::chrono::system_clock::time_point _time, bool _term, std::string&& _line);
+
 /// Logging class, iostream-like, that can be shifted to.
 template <class Id, bool _AutoSpacing = true>
 class LogOutputStream
@@ -82,34 +114,53 @@ class LogOutputStream
 public:
 	/// Construct a new object.
 	/// If _term is true the the prefix info is terminated with a ']' character; if not it ends only with a '|' character.
-	LogOutputStream(bool _term = true)
+	LogOutputStream(bool _term = true): m_enabled(isChannelVisible<Id>()), m_term(_term)
 	{
-		std::type_info const* i = &typeid(Id);
-		auto it = g_logOverride.find(i);
-		if ((it != g_logOverride.end() && it->second == true) || (it == g_logOverride.end() && Id::verbosity <= g_logVerbosity))
-		{
-			time_t rawTime = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
-			char buf[24];
-			if (strftime(buf, 24, "%X", localtime(&rawTime)) == 0)
-				buf[0] = '\0'; // empty if case strftime fails
-			m_sstr << Id::name() << " [ " << buf << " | " << (t_logThreadName.m_name.get() ? *t_logThreadName.m_name.get() : std::string("<unknown>")) << (_term ? " ] " : "");
-		}
+		if (m_enabled)
+			m_time = std::chrono::system_clock::now();
 	}
 
-	/// Destructor. Posts the accrued log entry to the g_logPost function.
-	~LogOutputStream() { if (Id::verbosity <= g_logVerbosity) g_logPost(m_sstr.str(), Id::name()); }
+	/// Destructor. Queues the accrued log entry for g_logPost.
+	~LogOutputStream() { if (m_enabled) postLogLine(Id::name(), m_time, m_term, m_sstr.str()); }
 
 	/// Shift arbitrary data to the log. Spaces will be added between items as required.
-	template <class T> LogOutputStream& operator<<(T const& _t) { if (Id::verbosity <= g_logVerbosity) { if (_AutoSpacing && m_sstr.str().size() && m_sstr.str().back() != ' ') m_sstr << " "; m_sstr << _t; } return *this; }
+	template <class T> LogOutputStream& operator<<(T const& _t)
+	{
+		if (m_enabled)
+		{
+			if (_AutoSpacing && (m_sstr.tellp() > 0 ? lastChar() != ' ' : !m_term))
+				m_sstr << " ";
+			m_sstr << _t;
+		}
+		return *this;
+	}
 
 private:
-	std::stringstream m_sstr;	///< The accrued log entry.
+	/// @returns the last character written so far, reading it straight from the buffer rather than copying it out.
+	int lastChar()
+	{
+		std::stringbuf* b = m_sstr.rdbuf();
+		b->pubseekoff(-1, std::ios::end, std::ios::in);
+		return b->sgetc();
+	}
+
+	bool m_enabled;
+	bool m_term;
+	std::chrono::system_clock::time_point m_time;
+	std::stringstream m_sstr;	///< The accrued log entry, sans prefix.
 };
 
+/// A LogOutputStream for channel X whose operands aren't evaluated at all unless X is visible.
+#define LOG_STREAM(X, S) LOG_STREAM_TERM(X, S, true)
+#define LOG_STREAM_TERM(X, S, T) for (bool _logVisible = dev::isChannelVisible<X>(); _logVisible; _logVisible = false) dev::LogOutputStream<X, S>(T)
+
+/// As LOG_STREAM, for a line about the connection identified by @a ID, which starts the line.
+#define LOG_SESSION_STREAM(X, ID) LOG_STREAM_TERM(X, true, false) << "| " << std::setw(2) << (ID) << "] "
+
 // Simple cout-like stream objects for accessing common log channels.
 // Dirties the global namespace, but oh so convenient...
-#define cnote dev::LogOutputStream<dev::NoteChannel, true>()
-#define cwarn dev::LogOutputStream<dev::WarnChannel, true>()
+#define cnote LOG_STREAM(dev::NoteChannel, true)
+#define cwarn LOG_STREAM(dev::WarnChannel, true)
 
 // Null stream-like objects.
 #define ndebug if (true) {} else dev::NullOutputStream()
@@ -120,7 +171,7 @@ private:
 #if NDEBUG
 #define cdebug ndebug
 #else
-#define cdebug dev::LogOutputStream<dev::DebugChannel, true>()
+#define cdebug LOG_STREAM(dev::DebugChannel, true)
 #endif
 
 // Kill all logs when when NLOG is defined.
@@ -128,8 +179,8 @@ private:
 #define clog(X) nlog(X)
 #define cslog(X) nslog(X)
 #else
-#define clog(X) dev::LogOutputStream<X, true>()
-#define cslog(X) dev::LogOutputStream<X, false>()
+#define clog(X) LOG_STREAM(X, true)
+#define cslog(X) LOG_STREAM(X, false)
 #endif
 
 }
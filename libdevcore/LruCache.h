@@ -0,0 +1,221 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file LruCache.h
+ * @date 2015
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <list>
+#include <ostream>
+#include <unordered_map>
+#include <utility>
+#include "Guards.h"
+
+namespace dev
+{
+
+/// Hashes a key that is itself a cryptographic hash (e.g. h256) by taking its leading bytes.
+struct LeadingBytesHash
+{
+	template <class K> size_t operator()(K const& _k) const { size_t ret; memcpy(&ret, _k.data(), sizeof(size_t)); return ret; }
+};
+
+/// Counters describing how well a cache is doing.
+struct CacheStats
+{
+	unsigned long long hits = 0;
+	unsigned long long misses = 0;
+	unsigned long long evictions = 0;
+	size_t entries = 0;
+	size_t bytes = 0;
+	size_t budget = 0;
+};
+
+inline std::ostream& operator<<(std::ostream& _out, CacheStats const& _s)
+{
+	return _out << _s.entries << " entries, " << (_s.bytes / 1024) << "/" << (_s.budget / 1024) << " KB, " << _s.hits << " hits, " << _s.misses << " misses, " << _s.evictions << " evictions";
+}
+
+/**
+ * @brief A least-recently-used cache with a budget in bytes.
+ * The keys are split between a number of shards, each with its own lock and its own share of the
+ * budget, so that lookups of different keys rarely contend. The caller gives the (approximate) size
+ * of each value when inserting it; once a shard's values exceed its share of the budget, its least
+ * recently used entries are evicted. A value too big for a shard's whole share isn't cached at all,
+ * rather than flushing everything else out of the shard.
+ * @threadsafe
+ */
+template <class K, class V, class H = std::hash<K>, unsigned Shards = 16>
+class LruCache
+{
+public:
+	explicit LruCache(size_t _budget = 32 * 1024 * 1024) { setBudget(_budget); }
+
+	/// Look up @a _k, marking it as most recently used.
+	/// @returns true and sets @a o_v if found.
+	bool get(K const& _k, V& o_v) const
+	{
+		Shard& s = shardFor(_k);
+		Guard l(s.x);
+		auto it = s.index.find(_k);
+		if (it == s.index.end())
+		{
+			++m_misses;
+			return false;
+		}
+		s.lru.splice(s.lru.begin(), s.lru, it->second);
+		o_v = it->second->value;
+		++m_hits;
+		return true;
+	}
+
+	/// @returns true if @a _k is in the cache. Doesn't affect recency.
+	bool contains(K const& _k) const
+	{
+		Shard& s = shardFor(_k);
+		Guard l(s.x);
+		return s.index.count(_k);
+	}
+
+	/// Insert (or replace) @a _k as the most recently used entry, with a value of @a _bytes bytes.
+	void insert(K const& _k, V _v, size_t _bytes)
+	{
+		Shard& s = shardFor(_k);
+		Guard l(s.x);
+		auto it = s.index.find(_k);
+		if (it != s.index.end())
+		{
+			s.bytes -= it->second->bytes;
+			s.lru.erase(it->second);
+			s.index.erase(it);
+		}
+		if (_bytes > m_shardBudget)
+			return;
+		s.lru.push_front(Entry{_k, std::move(_v), _bytes});
+		s.index[_k] = s.lru.begin();
+		s.bytes += _bytes;
+		trim(s);
+	}
+
+	/// Remove @a _k from the cache, if present.
+	void erase(K const& _k)
+	{
+		Shard& s = shardFor(_k);
+		Guard l(s.x);
+		auto it = s.index.find(_k);
+		if (it != s.index.end())
+		{
+			s.bytes -= it->second->bytes;
+			s.lru.erase(it->second);
+			s.index.erase(it);
+		}
+	}
+
+	void clear()
+	{
+		for (Shard& s: m_shards)
+		{
+			Guard l(s.x);
+			s.lru.clear();
+			s.index.clear();
+			s.bytes = 0;
+		}
+	}
+
+	/// Change the total budget, evicting as necessary to bring each shard within it.
+	void setBudget(size_t _bytes)
+	{
+		m_shardBudget = std::max<size_t>(_bytes / Shards, 1);
+		garbageCollect();
+	}
+	size_t budget() const { return m_shardBudget * Shards; }
+
+	/// Evict until each shard is within its share of the budget.
+	void garbageCollect()
+	{
+		for (Shard& s: m_shards)
+		{
+			Guard l(s.x);
+			trim(s);
+		}
+	}
+
+	CacheStats stats() const
+	{
+		CacheStats ret;
+		ret.hits = m_hits;
+		ret.misses = m_misses;
+		ret.evictions = m_evictions;
+		ret.budget = budget();
+		for (Shard const& s: m_shards)
+		{
+			Guard l(s.x);
+			ret.entries += s.index.size();
+			ret.bytes += s.bytes;
+		}
+		return ret;
+	}
+
+private:
+	struct Entry
+	{
+		K key;
+		V value;
+		size_t bytes;
+	};
+	using Entries = std::list<Entry>;
+
+	struct Shard
+	{
+		mutable Mutex x;
+		Entries lru;										///< Most recently used first.
+		std::unordered_map<K, typename Entries::iterator, H> index;
+		size_t bytes = 0;
+	};
+
+	Shard& shardFor(K const& _k) const
+	{
+		// Take the shard from the top bits; the unordered_map buckets use the bottom ones.
+		return m_shards[(H()(_k) >> (sizeof(size_t) * 8 - 8)) % Shards];
+	}
+
+	/// Evict least recently used entries from @a _s until within budget. Assumes the shard's lock is held.
+	void trim(Shard& _s)
+	{
+		while (_s.bytes > m_shardBudget && !_s.lru.empty())
+		{
+			Entry const& e = _s.lru.back();
+			_s.bytes -= e.bytes;
+			_s.index.erase(e.key);
+			_s.lru.pop_back();
+			++m_evictions;
+		}
+	}
+
+	mutable std::array<Shard, Shards> m_shards;
+	std::atomic<size_t> m_shardBudget;
+	mutable std::atomic<unsigned long long> m_hits{0};
+	mutable std::atomic<unsigned long long> m_misses{0};
+	mutable std::atomic<unsigned long long> m_evictions{0};
+};
+
+}
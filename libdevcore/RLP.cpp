@@ -218,14 +218,20 @@ RLPStream& RLPStream::appendList(unsigned _items)
 
 RLPStream& RLPStream::appendList(bytesConstRef _rlp)
 {
-	if (_rlp.size() < c_rlpListImmLenCount)
-		m_out.push_back((byte)(_rlp.size() + c_rlpListStart));
-	else
-		pushCount(_rlp.size(), c_rlpListIndLenZero);
+	appendListPrefix(_rlp.size());
 	appendRaw(_rlp, 1);
 	return *this;
 }
 
+RLPStream& RLPStream::appendListPrefix(unsigned _payloadSize)
+{
+	if (_payloadSize < c_rlpListImmLenCount)
+		m_out.push_back((byte)(_payloadSize + c_rlpListStart));
+	else
+		pushCount(_payloadSize, c_rlpListIndLenZero);
+	return *this;
+}
+
 RLPStream& RLPStream::append(bytesConstRef _s, bool _compact)
 {
 	unsigned s = _s.size();
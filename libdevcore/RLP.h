@@ -360,6 +360,9 @@ public:
 	RLPStream& appendList(bytes const& _rlp) { return appendList(&_rlp); }
 	RLPStream& appendList(RLPStream const& _s) { return appendList(&_s.out()); }
 
+	/// Appends only the prefix of a list whose @a _payloadSize bytes of content are to be appended (or sent) separately. Use with caution.
+	RLPStream& appendListPrefix(unsigned _payloadSize);
+
 	/// Appends raw (pre-serialised) RLP data. Use with caution.
 	RLPStream& appendRaw(bytesConstRef _rlp, unsigned _itemCount = 1);
 	RLPStream& appendRaw(bytes const& _rlp, unsigned _itemCount = 1) { return appendRaw(&_rlp, _itemCount); }
@@ -0,0 +1,94 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file RollingBloom.cpp
+ * @date 2015
+ */
+
+#include "RollingBloom.h"
+
+#include <algorithm>
+using namespace std;
+using namespace dev;
+
+/// Number of bits set per entry. With ~10 bits per entry this gives under 1% false positives.
+static const unsigned c_bloomHashes = 4;
+static const unsigned c_bloomBitsPerEntry = 10;
+
+RollingBloom::RollingBloom(unsigned _capacity, chrono::seconds _maxAge):
+	m_capacity(max(_capacity, 1u)),
+	m_maxAge(_maxAge),
+	m_started(chrono::steady_clock::now())
+{
+	unsigned bits = 64;
+	while (bits < m_capacity * c_bloomBitsPerEntry)
+		bits <<= 1;
+	m_mask = bits - 1;
+	m_current.resize(bits / 64);
+	m_previous.resize(bits / 64);
+}
+
+// The hashes inserted are already uniformly distributed, so we take the bit indices straight from them.
+static inline unsigned bloomIndex(h256 const& _h, unsigned _i)
+{
+	byte const* p = _h.data() + _i * 4;
+	return (unsigned(p[0]) << 24) | (unsigned(p[1]) << 16) | (unsigned(p[2]) << 8) | p[3];
+}
+
+void RollingBloom::rollIfNeeded()
+{
+	if (m_count < m_capacity && chrono::steady_clock::now() - m_started < m_maxAge)
+		return;
+	swap(m_previous, m_current);
+	fill(m_current.begin(), m_current.end(), 0);
+	m_count = 0;
+	m_started = chrono::steady_clock::now();
+}
+
+void RollingBloom::insert(h256 const& _h)
+{
+	rollIfNeeded();
+	for (unsigned i = 0; i < c_bloomHashes; ++i)
+	{
+		unsigned b = bloomIndex(_h, i) & m_mask;
+		m_current[b / 64] |= uint64_t(1) << (b % 64);
+	}
+	++m_count;
+}
+
+bool RollingBloom::test(vector<uint64_t> const& _bits, h256 const& _h) const
+{
+	for (unsigned i = 0; i < c_bloomHashes; ++i)
+	{
+		unsigned b = bloomIndex(_h, i) & m_mask;
+		if (!(_bits[b / 64] & (uint64_t(1) << (b % 64))))
+			return false;
+	}
+	return true;
+}
+
+bool RollingBloom::contains(h256 const& _h) const
+{
+	return test(m_current, _h) || test(m_previous, _h);
+}
+
+void RollingBloom::clear()
+{
+	fill(m_current.begin(), m_current.end(), 0);
+	fill(m_previous.begin(), m_previous.end(), 0);
+	m_count = 0;
+	m_started = chrono::steady_clock::now();
+}
@@ -0,0 +1,67 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file RollingBloom.h
+ * @date 2015
+ */
+
+#pragma once
+
+#include <chrono>
+#include <vector>
+#include "FixedHash.h"
+
+namespace dev
+{
+
+/**
+ * @brief A probabilistic set of hashes with bounded memory which forgets old entries.
+ * Entries are kept in two bloom filters, the current and the previous generation. Once the current
+ * generation holds _capacity entries or becomes older than _maxAge, it is made the previous one and
+ * a fresh one is started; anything inserted two generations ago is thereby forgotten.
+ * contains() may yield false positives (around 1% at capacity) but never false negatives for entries
+ * in either live generation.
+ * @threadsafe no.
+ */
+class RollingBloom
+{
+public:
+	explicit RollingBloom(unsigned _capacity = 4096, std::chrono::seconds _maxAge = std::chrono::seconds(600));
+
+	/// Note that _h is known.
+	void insert(h256 const& _h);
+	/// @returns true if _h has (probably) been inserted in the current or previous generation.
+	bool contains(h256 const& _h) const;
+	/// Forget everything.
+	void clear();
+
+	/// @returns the number of bytes used by the filters.
+	size_t memoryUsage() const { return (m_current.size() + m_previous.size()) * sizeof(uint64_t); }
+
+private:
+	void rollIfNeeded();
+	bool test(std::vector<uint64_t> const& _bits, h256 const& _h) const;
+
+	unsigned m_capacity;
+	std::chrono::seconds m_maxAge;
+	unsigned m_mask;							///< Mask for a bit index; the filters have m_mask + 1 bits.
+	unsigned m_count = 0;						///< Number of insertions in the current generation.
+	std::chrono::steady_clock::time_point m_started;	///< When the current generation began.
+	std::vector<uint64_t> m_current;
+	std::vector<uint64_t> m_previous;
+};
+
+}
@@ -20,7 +20,6 @@
  */
 
 #include "CryptoPP.h"
-#include <libdevcore/Guards.h>
 
 using namespace std;
 using namespace dev;
@@ -31,6 +30,18 @@ static_assert(dev::Secret::size == 32, "Secret key must be 32 bytes.");
 static_assert(dev::Public::size == 64, "Public key must be 64 bytes.");
 static_assert(dev::Signature::size == 65, "Signature must be 65 bytes.");
 
+Secp256k1::Secp256k1(): m_oid(ASN1::secp256k1()), m_params(m_oid), m_q(m_params.GetGroupOrder()), m_qs(m_params.GetSubgroupOrder())
+{
+	m_params.Precompute();
+}
+
+Secp256k1::Context& Secp256k1::context()
+{
+	if (!m_context.get())
+		m_context.reset(new Context(m_params));
+	return *m_context;
+}
+
 void Secp256k1::encrypt(Public const& _k, bytes& io_cipher)
 {
 	ECIES<ECP>::Encryptor e;
@@ -40,10 +51,7 @@ void Secp256k1::encrypt(Public const& _k, bytes& io_cipher)
 	bytes ciphertext;
 	ciphertext.resize(e.CiphertextLength(plen));
 	
-	{
-		Guard l(x_rng);
-		e.Encrypt(m_rng, io_cipher.data(), plen, ciphertext.data());
-	}
+	e.Encrypt(context().rng, io_cipher.data(), plen, ciphertext.data());
 	
 	memset(io_cipher.data(), 0, io_cipher.size());
 	io_cipher = std::move(ciphertext);
@@ -64,11 +72,7 @@ void Secp256k1::decrypt(Secret const& _k, bytes& io_text)
 	bytes plain;
 	plain.resize(d.MaxPlaintextLength(io_text.size()));
 	
-	DecodingResult r;
-	{
-		Guard l(x_rng);
-		r = d.Decrypt(m_rng, io_text.data(), clen, plain.data());
-	}
+	DecodingResult r = d.Decrypt(context().rng, io_text.data(), clen, plain.data());
 	
 	if (!r.isValidCoding)
 	{
@@ -97,13 +101,9 @@ Signature Secp256k1::sign(Secret const& _key, h256 const& _hash)
 		BOOST_THROW_EXCEPTION(InvalidState());
 	k = 1 + (k % (m_qs - 1));
 	
-	ECP::Point rp;
-	Integer r;
-	{
-		Guard l(x_params);
-		rp = m_params.ExponentiateBase(k);
-		r = m_params.ConvertElementToInteger(rp);
-	}
+	Context& c = context();
+	ECP::Point rp = c.params.ExponentiateBase(k);
+	Integer r = c.params.ConvertElementToInteger(rp);
 	sig[64] = 0;
 //	sig[64] = (r >= m_q) ? 2 : 0;
 	
@@ -148,19 +148,16 @@ Public Secp256k1::recover(Signature _signature, bytesConstRef _message)
 	encodedpoint[0] = _signature[64] | 2;
 	memcpy(&encodedpoint[1], _signature.data(), 32);
 	
+	Context& c = context();
 	ECP::Element x;
-	{
-		Guard l(x_curve);
-		m_curve.DecodePoint(x, encodedpoint, 33);
-		if (!m_curve.VerifyPoint(x))
-			return recovered;
-	}
+	c.curve.DecodePoint(x, encodedpoint, 33);
+	if (!c.curve.VerifyPoint(x))
+		return recovered;
 	
 //	if (_signature[64] & 2)
 //	{
 //		r += m_q;
-//		Guard l(x_params);
-//		if (r >= m_params.GetMaxExponent())
+//		if (r >= c.params.GetMaxExponent())
 //			return recovered;
 //	}
 	
@@ -169,28 +166,24 @@ Public Secp256k1::recover(Signature _signature, bytesConstRef _message)
 	Integer u1 = m_q - (rn.Times(z)).Modulo(m_q);
 	Integer u2 = (rn.Times(s)).Modulo(m_q);
 	
-	ECP::Point p;
 	byte recoveredbytes[65];
-	{
-		Guard l(x_curve);
-		// todo: make generator member
-		p = m_curve.CascadeMultiply(u2, x, u1, m_params.GetSubgroupGenerator());
-		m_curve.EncodePoint(recoveredbytes, p, false);
-	}
+	ECP::Point p = c.curve.CascadeMultiply(u2, x, u1, c.params.GetSubgroupGenerator());
+	c.curve.EncodePoint(recoveredbytes, p, false);
 	memcpy(recovered.data(), &recoveredbytes[1], 64);
 	return recovered;
 }
 
 bool Secp256k1::verifySecret(Secret const& _s, Public& _p)
 {
+	Context& c = context();
 	DL_PrivateKey_EC<ECP> k;
-	k.Initialize(m_params, secretToExponent(_s));
-	if (!k.Validate(m_rng, 3))
+	k.Initialize(c.params, secretToExponent(_s));
+	if (!k.Validate(c.rng, 3))
 		return false;
 	
 	DL_PublicKey_EC<CryptoPP::ECP> pub;
 	k.MakePublicKey(pub);
-	if (!k.Validate(m_rng, 3))
+	if (!k.Validate(c.rng, 3))
 		return false;
 
 	exportPublicKey(pub, _p);
@@ -199,37 +192,30 @@ bool Secp256k1::verifySecret(Secret const& _s, Public& _p)
 
 void Secp256k1::agree(Secret const& _s, Public const& _r, h256& o_s)
 {
-	(void)o_s;
-	(void)_s;
-	ECDH<ECP>::Domain d(m_oid);
+	ECDH<ECP>::Domain d(context().params);
 	assert(d.AgreedValueLength() == sizeof(o_s));
 	byte remote[65] = {0x04};
 	memcpy(&remote[1], _r.data(), 64);
-	assert(d.Agree(o_s.data(), _s.data(), remote));
+	bool agreed = d.Agree(o_s.data(), _s.data(), remote);
+	assert(agreed);
+	(void)agreed;
 }
 
 void Secp256k1::exportPublicKey(CryptoPP::DL_PublicKey_EC<CryptoPP::ECP> const& _k, Public& o_p)
 {
 	bytes prefixedKey(_k.GetGroupParameters().GetEncodedElementSize(true));
 	
-	{
-		Guard l(x_params);
-		m_params.GetCurve().EncodePoint(prefixedKey.data(), _k.GetPublicElement(), false);
-		assert(Public::size + 1 == _k.GetGroupParameters().GetEncodedElementSize(true));
-	}
+	context().curve.EncodePoint(prefixedKey.data(), _k.GetPublicElement(), false);
+	assert(Public::size + 1 == _k.GetGroupParameters().GetEncodedElementSize(true));
 
 	memcpy(o_p.data(), &prefixedKey[1], Public::size);
 }
 
 void Secp256k1::exponentToPublic(Integer const& _e, Public& o_p)
 {
+	Context& c = context();
 	CryptoPP::DL_PublicKey_EC<CryptoPP::ECP> pk;
-	
-	{
-		Guard l(x_params);
-		pk.Initialize(m_params, m_params.ExponentiateBase(_e));
-	}
-	
+	pk.Initialize(c.params, c.params.ExponentiateBase(_e));
 	exportPublicKey(pk, o_p);
 }
 
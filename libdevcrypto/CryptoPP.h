@@ -23,7 +23,7 @@
 
 #pragma once
 
-#include <mutex>
+#include <boost/thread/tss.hpp>
 // need to leave this one disabled for link-time. blame cryptopp.
 #pragma GCC diagnostic ignored "-Wunused-function"
 #pragma warning(push)
@@ -65,11 +65,15 @@ inline Integer secretToExponent(Secret const& _s) { return std::move(Integer(_s.
 
 /**
  * CryptoPP secp256k1 algorithms.
+ *
+ * CryptoPP's group and curve objects keep scratch values while computing, so rather than sharing one set
+ * behind a lock, each thread works on its own copy of the group parameters, taken from m_params (which has
+ * the powers of the generator precomputed) the first time it uses this object.
  */
 class Secp256k1
 {	
 public:
-	Secp256k1(): m_oid(ASN1::secp256k1()), m_params(m_oid), m_curve(m_params.GetCurve()), m_q(m_params.GetGroupOrder()), m_qs(m_params.GetSubgroupOrder()) {}
+	Secp256k1();
 	
 	Address toAddress(Public const& _p) { return right160(sha3(_p.ref())); }
 	
@@ -108,24 +112,32 @@ protected:
 	
 	void exponentToPublic(Integer const& _e, Public& o_p);
 	
-	template <class T> void initializeDLScheme(Secret const& _s, T& io_operator) { std::lock_guard<std::mutex> l(x_params); io_operator.AccessKey().Initialize(m_params, secretToExponent(_s)); }
+	template <class T> void initializeDLScheme(Secret const& _s, T& io_operator) { io_operator.AccessKey().Initialize(context().params, secretToExponent(_s)); }
 	
-	template <class T> void initializeDLScheme(Public const& _p, T& io_operator) { std::lock_guard<std::mutex> l(x_params); io_operator.AccessKey().Initialize(m_params, publicToPoint(_p)); }
+	template <class T> void initializeDLScheme(Public const& _p, T& io_operator) { io_operator.AccessKey().Initialize(context().params, publicToPoint(_p)); }
 	
 private:
-	OID m_oid;
-	
-	std::mutex x_rng;
-	AutoSeededRandomPool m_rng;
+	/// Everything a thread computes with.
+	struct Context
+	{
+		explicit Context(DL_GroupParameters_EC<ECP> const& _params): params(_params), curve(params.GetCurve()) {}
+		
+		DL_GroupParameters_EC<ECP> params;
+		DL_GroupParameters_EC<ECP>::EllipticCurve curve;
+		AutoSeededRandomPool rng;
+	};
+	
+	/// @returns the calling thread's context, creating it on first use.
+	Context& context();
 	
-	std::mutex x_params;
-	DL_GroupParameters_EC<ECP> m_params;
+	OID m_oid;
 	
-	std::mutex x_curve;
-	DL_GroupParameters_EC<ECP>::EllipticCurve m_curve;
+	DL_GroupParameters_EC<ECP> m_params;	///< Only ever copied from once constructed.
 	
 	Integer m_q;
 	Integer m_qs;
+	
+	boost::thread_specific_ptr<Context> m_context;
 };
 
 }
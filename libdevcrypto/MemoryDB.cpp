@@ -30,7 +30,7 @@ namespace dev
 std::map<h256, std::string> MemoryDB::get() const
 {
 	if (!m_enforceRefs)
-		return m_over;
+		return std::map<h256, std::string>(m_over.begin(), m_over.end());
 	std::map<h256, std::string> ret;
 	for (auto const& i: m_refCount)
 		if (i.second)
@@ -24,6 +24,7 @@
 #include <map>
 #include <libdevcore/Common.h>
 #include <libdevcore/FixedHash.h>
+#include <libdevcore/FlatHash.h>
 #include <libdevcore/Log.h>
 #include <libdevcore/RLP.h>
 
@@ -53,8 +54,8 @@ public:
 	std::set<h256> keys() const;
 
 protected:
-	std::map<h256, std::string> m_over;
-	std::map<h256, unsigned> m_refCount;
+	FlatHashMap<h256, std::string> m_over;
+	FlatHashMap<h256, unsigned> m_refCount;
 
 	mutable bool m_enforceRefs = false;
 };
@@ -45,12 +45,14 @@ void OverlayDB::commit()
 	if (m_db)
 	{
 //		cnote << "Committing nodes to disk DB:";
+		ldb::WriteBatch batch;
 		for (auto const& i: m_over)
 		{
 //			cnote << i.first << "#" << m_refCount[i.first];
 			if (m_refCount[i.first])
-				m_db->Put(m_writeOptions, ldb::Slice((char const*)i.first.data(), i.first.size), ldb::Slice(i.second.data(), i.second.size()));
+				batch.Put(ldb::Slice((char const*)i.first.data(), i.first.size), ldb::Slice(i.second.data(), i.second.size()));
 		}
+		m_db->Write(m_writeOptions, &batch);
 		m_over.clear();
 		m_refCount.clear();
 	}
@@ -24,6 +24,7 @@
 #pragma warning(push)
 #pragma warning(disable: 4100 4267)
 #include <leveldb/db.h>
+#include <leveldb/write_batch.h>
 #pragma warning(pop)
 
 #include <memory>
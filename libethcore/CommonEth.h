@@ -47,6 +47,9 @@ std::vector<std::pair<u256, std::string>> const& units();
 /// The log bloom's size (512 bit).
 using LogBloom = h512;
 
+/// Many log blooms.
+using LogBlooms = std::vector<LogBloom>;
+
 template <size_t n> inline u256 exp10()
 {
 	return exp10<n - 1>() * u256(10);
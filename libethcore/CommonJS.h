@@ -23,6 +23,7 @@
 
 #pragma once
 
+#include <array>
 #include <string>
 #include <libdevcore/Common.h>
 #include <libdevcore/FixedHash.h>
@@ -33,19 +34,34 @@
 namespace dev
 {
 
+/// @returns "0x" followed by the hex of @a _b, built in a single allocation.
+inline std::string toJS(bytesConstRef _b)
+{
+	std::string ret(2 + _b.size() * 2, '0');
+	ret[1] = 'x';
+	writeHex(_b, &ret[2]);
+	return ret;
+}
+
 template <unsigned S> std::string toJS(FixedHash<S> const& _h)
 {
-	return "0x" + toHex(_h.ref());
+	return toJS(_h.ref());
 }
 
 template <unsigned N> std::string toJS(boost::multiprecision::number<boost::multiprecision::cpp_int_backend<N, N, boost::multiprecision::unsigned_magnitude, boost::multiprecision::unchecked, void>> const& _n)
 {
-	return "0x" + toHex(toCompactBigEndian(_n));
+	// The compact big-endian bytes, without a heap-allocated intermediate.
+	std::array<byte, N / 8> be;
+	toBigEndian(_n, be);
+	unsigned leading = 0;
+	while (leading < be.size() && !be[leading])
+		++leading;
+	return toJS(bytesConstRef(be.data() + leading, be.size() - leading));
 }
 
 inline std::string toJS(dev::bytes const& _n)
 {
-	return "0x" + dev::toHex(_n);
+	return toJS(bytesConstRef(&_n));
 }
 
 /// Convert string to byte array. Input parameters can be hex or dec. Returns empty array if invalid input e.g neither dec or hex.
@@ -67,9 +83,14 @@ Address fromString(std::string const& _a);
 
 template <unsigned N> FixedHash<N> jsToFixed(std::string const& _s)
 {
-	if (_s.substr(0, 2) == "0x")
-		// Hex
+	if (_s.compare(0, 2, "0x") == 0)
+	{
+		// Hex; only the last N bytes count. Valid hex decodes in place, anything else goes the long way round.
+		FixedHash<N> ret;
+		if (_s.size() - 2 >= N * 2 && readHex(_s.data() + _s.size() - N * 2, N * 2, ret.data()))
+			return ret;
 		return FixedHash<N>(_s.substr(2 + std::max<unsigned>(N * 2, _s.size() - 2) - N * 2));
+	}
 	else if (_s.find_first_not_of("0123456789") == std::string::npos)
 		// Decimal
 		return (typename FixedHash<N>::Arith)(_s);
@@ -85,7 +106,7 @@ inline std::string jsToFixed(double _s)
 
 template <unsigned N> boost::multiprecision::number<boost::multiprecision::cpp_int_backend<N * 8, N * 8, boost::multiprecision::unsigned_magnitude, boost::multiprecision::unchecked, void>> jsToInt(std::string const& _s)
 {
-	if (_s.substr(0, 2) == "0x")
+	if (_s.compare(0, 2, "0x") == 0)
 		// Hex
 		return fromBigEndian<boost::multiprecision::number<boost::multiprecision::cpp_int_backend<N * 8, N * 8, boost::multiprecision::unsigned_magnitude, boost::multiprecision::unchecked, void>>>(fromHex(_s.substr(2)));
 	else if (_s.find_first_not_of("0123456789") == std::string::npos)
@@ -40,6 +40,18 @@ namespace js = json_spirit;
 
 #define ETH_CATCH 1
 
+/// Key in the extras DB under which the hash of a block being imported is kept; see BlockChain::commit().
+/// Prefix of the key, in the blocks DB, of a block's import marker; the block's hash follows.
+static const string c_importMarker = "importing";
+
+/// The number of blocks whose extras may be written unsynced before a synced write of the extras is forced.
+static const unsigned c_maxUnsyncedImports = 256;
+
+static string importMarker(h256 const& _hash)
+{
+	return c_importMarker + string((char const*)_hash.data(), 32);
+}
+
 std::ostream& dev::eth::operator<<(std::ostream& _out, BlockChain const& _bc)
 {
 	string cmp = toBigEndianString(_bc.currentHash());
@@ -72,6 +84,9 @@ ldb::Slice dev::eth::toSlice(h256 _h, unsigned _sub)
 
 BlockChain::BlockChain(bytes const& _genesisBlock, std::string _path, bool _killExisting)
 {
+	setCacheBudget(chainCacheBudget(Defaults::storageProfile()));
+	m_syncWriteOptions.sync = true;
+
 	// Initialise with the genesis as the last block on the longest chain.
 	m_genesisBlock = _genesisBlock;
 	m_genesisHash = sha3(RLP(m_genesisBlock)[0].data());
@@ -95,24 +110,52 @@ void BlockChain::open(std::string _path, bool _killExisting)
 		boost::filesystem::remove_all(_path + "/details");
 	}
 
-	ldb::Options o;
-	o.create_if_missing = true;
-	ldb::DB::Open(o, _path + "/blocks", &m_db);
-	ldb::DB::Open(o, _path + "/details", &m_extrasDB);
+	auto profile = Defaults::storageProfile();
+	ldb::DB::Open(databaseOptions(profile, Database::Blocks), _path + "/blocks", &m_db);
+	ldb::DB::Open(databaseOptions(profile, Database::Details), _path + "/details", &m_extrasDB);
 	if (!m_db)
 		BOOST_THROW_EXCEPTION(DatabaseAlreadyOpen());
 	if (!m_extrasDB)
 		BOOST_THROW_EXCEPTION(DatabaseAlreadyOpen());
 
+	// A block whose marker is left behind may have been imported without its extras reaching the disk. If they did,
+	// the marker is just stale; if not, the block is removed again, as nothing else of its import can be there.
+	{
+		ldb::WriteBatch recovered;
+		unsigned markers = 0;
+		unsigned discarded = 0;
+		unique_ptr<ldb::Iterator> it(m_db->NewIterator(m_readOptions));
+		for (it->Seek(ldb::Slice(c_importMarker)); it->Valid() && it->key().starts_with(ldb::Slice(c_importMarker)); it->Next())
+		{
+			if (it->key().size() != c_importMarker.size() + 32)
+				continue;
+			h256 h((byte const*)it->key().data() + c_importMarker.size(), h256::ConstructFromPointer);
+			if (extrasRaw<0>(h).empty())
+			{
+				cwarn << "Discarding block" << h.abridged() << "from an interrupted import.";
+				recovered.Delete(ldb::Slice((char const*)h.data(), 32));
+				++discarded;
+			}
+			recovered.Delete(it->key());
+			++markers;
+		}
+		it.reset();
+		if (markers)
+			checkWrite(m_db->Write(m_syncWriteOptions, &recovered));
+		if (discarded)
+			cwarn << discarded << "blocks discarded.";
+	}
+
 	if (!details(m_genesisHash))
 	{
 		// Insert details of genesis block.
-		m_details[m_genesisHash] = BlockDetails(0, c_genesisDifficulty, h256(), {});
-		auto r = m_details[m_genesisHash].rlp();
-		m_extrasDB->Put(m_writeOptions, ldb::Slice((char const*)&m_genesisHash, 32), (ldb::Slice)dev::ref(r));
+		writeExtras<BlockDetails, 0>(m_genesisHash, BlockDetails(0, c_genesisDifficulty, h256(), {}), m_details);
+		commitImports();
 	}
 
+#if ETH_PARANOIA
 	checkConsistency();
+#endif
 
 	// TODO: Implement ability to rebuild details map from DB.
 	std::string l;
@@ -129,8 +172,58 @@ void BlockChain::close()
 	delete m_extrasDB;
 	delete m_db;
 	m_lastBlockHash = m_genesisHash;
+	{
+		WriteGuard l(x_lastHashes);
+		m_lastHashes.reset();
+	}
 	m_details.clear();
-	m_cache.clear();
+	m_logBlooms.clear();
+	m_receipts.clear();
+	m_blocks.clear();
+}
+
+void BlockChain::setCacheBudget(size_t _bytes)
+{
+	// Blocks are the bulkiest and most often re-read; details are small but needed for everything.
+	m_blocks.setBudget(_bytes / 2);
+	m_receipts.setBudget(_bytes / 4);
+	m_details.setBudget(_bytes / 8);
+	m_logBlooms.setBudget(_bytes / 8);
+}
+
+BlockChainCacheStats BlockChain::cacheStats() const
+{
+	BlockChainCacheStats ret;
+	ret.details = m_details.stats();
+	ret.logBlooms = m_logBlooms.stats();
+	ret.receipts = m_receipts.stats();
+	ret.blocks = m_blocks.stats();
+	return ret;
+}
+
+void BlockChain::process()
+{
+	m_details.garbageCollect();
+	m_logBlooms.garbageCollect();
+	m_receipts.garbageCollect();
+	m_blocks.garbageCollect();
+
+	if (chrono::steady_clock::now() - m_lastStatsNote > chrono::minutes(1))
+	{
+		clog(BlockChainNote) << "Cache usage:" << cacheStats();
+		m_lastStatsNote = chrono::steady_clock::now();
+	}
+}
+
+std::string BlockChain::databaseStats() const
+{
+	return "Blocks DB:\n" + dev::eth::databaseStats(m_db) + "Details DB:\n" + dev::eth::databaseStats(m_extrasDB);
+}
+
+std::ostream& dev::eth::operator<<(std::ostream& _out, BlockChainCacheStats const& _s)
+{
+	_out << "details: " << _s.details << "; logBlooms: " << _s.logBlooms << "; receipts: " << _s.receipts << "; blocks: " << _s.blocks;
+	return _out;
 }
 
 template <class T, class V>
@@ -156,10 +249,11 @@ h256s BlockChain::sync(BlockQueue& _bq, OverlayDB const& _stateDB, unsigned _max
 {
 	_bq.tick(*this);
 
-	vector<bytes> blocks;
+	VerifiedBlocks blocks;
 	_bq.drain(blocks);
 
 	h256s ret;
+	++m_importRun;
 	for (auto const& block: blocks)
 	{
 		try
@@ -172,17 +266,19 @@ h256s BlockChain::sync(BlockQueue& _bq, OverlayDB const& _stateDB, unsigned _max
 		}
 		catch (UnknownParent)
 		{
-			cwarn << "Unknown parent of block!!!" << BlockInfo::headerHash(block).abridged() << boost::current_exception_diagnostic_information();
-			_bq.import(&block, *this);
+			cwarn << "Unknown parent of block!!!" << block.info.hash.abridged() << boost::current_exception_diagnostic_information();
+			_bq.import(&block.block, *this);
 		}
 		catch (Exception const& _e)
 		{
 			cwarn << "Unexpected exception!" << diagnostic_information(_e);
-			_bq.import(&block, *this);
+			_bq.import(&block.block, *this);
 		}
 		catch (...)
 		{}
 	}
+	--m_importRun;
+	commitImports();
 	_bq.doneDrain();
 	return ret;
 }
@@ -200,11 +296,9 @@ h256s BlockChain::attemptImport(bytes const& _block, OverlayDB const& _stateDB)
 	}
 }
 
-h256s BlockChain::import(bytes const& _block, OverlayDB const& _db)
+VerifiedBlock BlockChain::verifyBlock(bytesConstRef _block, bool _checkNonce)
 {
-	// VERIFY: populates from the block and checks the block is internally coherent.
-	BlockInfo bi;
-
+	VerifiedBlock res;
 #if ETH_CATCH
 	try
 #endif
@@ -214,8 +308,12 @@ h256s BlockChain::import(bytes const& _block, OverlayDB const& _db)
 		if (!blockRLP.isList())
 			BOOST_THROW_EXCEPTION(InvalidBlockFormat(0, blockRLP.data()) << errinfo_comment("block header needs to be a list"));
 
-		bi.populate(&_block);
-		bi.verifyInternals(&_block);
+		res.info.populate(_block, _checkNonce);
+		res.info.verifyInternals(_block);
+
+		// Recovering the senders is the bulk of the work of executing most transactions; do it here, off the import path.
+		for (auto const& tr: blockRLP[1])
+			res.transactions.push_back(Transaction(tr.data(), CheckSignature::Sender));
 	}
 #if ETH_CATCH
 	catch (Exception const& _e)
@@ -225,7 +323,19 @@ h256s BlockChain::import(bytes const& _block, OverlayDB const& _db)
 		throw;
 	}
 #endif
-	auto newHash = BlockInfo::headerHash(_block);
+	res.block = _block.toBytes();
+	return res;
+}
+
+h256s BlockChain::import(bytes const& _block, OverlayDB const& _db)
+{
+	return import(verifyBlock(&_block), _db);
+}
+
+h256s BlockChain::import(VerifiedBlock const& _block, OverlayDB const& _db)
+{
+	BlockInfo const& bi = _block.info;
+	auto newHash = bi.hash;
 
 	// Check block doesn't already exist first!
 	if (isKnown(newHash))
@@ -269,7 +379,7 @@ h256s BlockChain::import(bytes const& _block, OverlayDB const& _db)
 		// Check transactions are valid and that they result in a state equivalent to our state_root.
 		// Get total difficulty increase and update state, checking it.
 		State s(bi.coinbaseAddress, _db);
-		auto tdIncrease = s.enactOn(&_block, bi, *this);
+		auto tdIncrease = s.enactOn(_block, *this);
 		BlockLogBlooms blb;
 		BlockReceipts br;
 		for (unsigned i = 0; i < s.pending().size(); ++i)
@@ -284,29 +394,12 @@ h256s BlockChain::import(bytes const& _block, OverlayDB const& _db)
 		checkConsistency();
 #endif
 		// All ok - insert into DB
-		{
-			WriteGuard l(x_details);
-			m_details[newHash] = BlockDetails((unsigned)pd.number + 1, td, bi.parentHash, {});
-			m_details[bi.parentHash].children.push_back(newHash);
-		}
-		{
-			WriteGuard l(x_logBlooms);
-			m_logBlooms[newHash] = blb;
-		}
-		{
-			WriteGuard l(x_receipts);
-			m_receipts[newHash] = br;
-		}
-
-		m_extrasDB->Put(m_writeOptions, toSlice(newHash), (ldb::Slice)dev::ref(m_details[newHash].rlp()));
-		m_extrasDB->Put(m_writeOptions, toSlice(bi.parentHash), (ldb::Slice)dev::ref(m_details[bi.parentHash].rlp()));
-		m_extrasDB->Put(m_writeOptions, toSlice(newHash, 3), (ldb::Slice)dev::ref(m_logBlooms[newHash].rlp()));
-		m_extrasDB->Put(m_writeOptions, toSlice(newHash, 4), (ldb::Slice)dev::ref(m_receipts[newHash].rlp()));
-		m_db->Put(m_writeOptions, toSlice(newHash), (ldb::Slice)ref(_block));
-
-#if ETH_PARANOIA
-		checkConsistency();
-#endif
+		pd.children.push_back(newHash);
+		writeBlock(newHash, &_block.block);
+		writeExtras<BlockDetails, 0>(newHash, BlockDetails((unsigned)pd.number + 1, td, bi.parentHash, {}), m_details);
+		writeExtras<BlockDetails, 0>(bi.parentHash, pd, m_details);
+		writeExtras<BlockLogBlooms, 3>(newHash, blb, m_logBlooms);
+		writeExtras<BlockReceipts, 4>(newHash, br, m_receipts);
 	}
 #if ETH_CATCH
 	catch (Exception const& _e)
@@ -322,14 +415,40 @@ h256s BlockChain::import(bytes const& _block, OverlayDB const& _db)
 	h256s ret;
 	// This might be the new best block...
 	h256 last = currentHash();
-	if (td > details(last).totalDifficulty)
+	bool best = td > details(last).totalDifficulty;
+	if (best)
+	{
+		WriteGuard l(x_pendingExtras);
+		m_pendingExtras["best"] = string((char const*)newHash.data(), 32);
+	}
+	if (!m_importRun)
+		commitImports();
+#if ETH_PARANOIA
+	checkConsistency();
+#endif
+
+	if (best)
 	{
 		ret = treeRoute(last, newHash);
 		{
 			WriteGuard l(x_lastBlockHash);
 			m_lastBlockHash = newHash;
 		}
-		m_extrasDB->Put(m_writeOptions, ldb::Slice("best"), ldb::Slice((char const*)&newHash, 32));
+		{
+			// If this just extends the head we can shift the new block onto the last hashes; otherwise (a
+			// reorganisation) they'll be rebuilt when next asked for.
+			WriteGuard l(x_lastHashes);
+			if (m_lastHashes && m_lastHashes->front() == bi.parentHash)
+			{
+				auto lh = make_shared<LastHashes>(m_lastHashes->size());
+				(*lh)[0] = newHash;
+				copy(m_lastHashes->begin(), m_lastHashes->end() - 1, lh->begin() + 1);
+				m_lastHashes = lh;
+				++m_lastHashesNumber;
+			}
+			else
+				m_lastHashes.reset();
+		}
 		clog(BlockChainNote) << "   Imported and best" << td << ". Has" << (details(bi.parentHash).children.size() - 1) << "siblings. Route:" << toString(ret);
 	}
 	else
@@ -389,12 +508,58 @@ h256s BlockChain::treeRoute(h256 _from, h256 _to, h256* o_common, bool _pre, boo
 	return ret;
 }
 
-void BlockChain::checkConsistency()
+void BlockChain::checkWrite(ldb::Status const& _s)
+{
+	if (!_s.ok())
+		BOOST_THROW_EXCEPTION(DatabaseWriteFailed() << errinfo_comment(_s.ToString()));
+}
+
+void BlockChain::writeBlock(h256 const& _hash, bytesConstRef _block)
 {
+	ldb::WriteBatch batch;
+	batch.Put(toSlice(_hash), (ldb::Slice)_block);
+	batch.Put(ldb::Slice(importMarker(_hash)), ldb::Slice());
+	checkWrite(m_db->Write(m_writeOptions, &batch));
+	m_unsyncedImports.push_back(_hash);
+}
+
+void BlockChain::commitImports()
+{
+	ldb::WriteBatch extras;
+	{
+		ReadGuard l(x_pendingExtras);
+		if (m_pendingExtras.empty())
+			return;
+		for (auto const& i: m_pendingExtras)
+			extras.Put(ldb::Slice(i.first), ldb::Slice(i.second));
+	}
+
+	// An empty synced write still waits for all the blocks (and markers) written before it.
+	bool syncExtras = m_unsyncedImports.size() >= c_maxUnsyncedImports;
+	if (!m_unsyncedImports.empty())
+	{
+		ldb::WriteBatch none;
+		checkWrite(m_db->Write(m_syncWriteOptions, &none));
+	}
+	checkWrite(m_extrasDB->Write(syncExtras ? m_syncWriteOptions : m_writeOptions, &extras));
+	{
+		WriteGuard l(x_pendingExtras);
+		m_pendingExtras.clear();
+	}
+
+	if (syncExtras)
 	{
-		WriteGuard l(x_details);
-		m_details.clear();
+		ldb::WriteBatch markers;
+		for (auto const& h: m_unsyncedImports)
+			markers.Delete(ldb::Slice(importMarker(h)));
+		checkWrite(m_db->Write(m_writeOptions, &markers));
+		m_unsyncedImports.clear();
 	}
+}
+
+void BlockChain::checkConsistency()
+{
+	m_details.clear();
 	ldb::Iterator* it = m_db->NewIterator(m_readOptions);
 	for (it->SeekToFirst(); it->Valid(); it->Next())
 		if (it->key().size() == 32)
@@ -437,27 +602,37 @@ bool BlockChain::isKnown(h256 _hash) const
 {
 	if (_hash == m_genesisHash)
 		return true;
-	{
-		ReadGuard l(x_cache);
-		if (m_cache.count(_hash))
-			return true;
-	}
+	if (m_blocks.contains(_hash))
+		return true;
 	string d;
 	m_db->Get(m_readOptions, ldb::Slice((char const*)&_hash, 32), &d);
 	return !!d.size();
 }
 
+TransactionReceipt BlockChain::receipt(h256 _blockHash, unsigned _i) const
+{
+	BlockReceipts br;
+	if (m_receipts.get(_blockHash, br))
+		return br.receipts.at(_i);
+	return BlockReceipts::receipt(RLP(extrasRaw<4>(_blockHash)), _i);
+}
+
+LogEntry BlockChain::log(h256 _blockHash, unsigned _receipt, unsigned _log) const
+{
+	BlockReceipts br;
+	if (m_receipts.get(_blockHash, br))
+		return br.receipts.at(_receipt).log().at(_log);
+	return BlockReceipts::log(RLP(extrasRaw<4>(_blockHash)), _receipt, _log);
+}
+
 bytes BlockChain::block(h256 _hash) const
 {
 	if (_hash == m_genesisHash)
 		return m_genesisBlock;
 
-	{
-		ReadGuard l(x_cache);
-		auto it = m_cache.find(_hash);
-		if (it != m_cache.end())
-			return it->second;
-	}
+	bytes ret;
+	if (m_blocks.get(_hash, ret))
+		return ret;
 
 	string d;
 	m_db->Get(m_readOptions, ldb::Slice((char const*)&_hash, 32), &d);
@@ -468,11 +643,48 @@ bytes BlockChain::block(h256 _hash) const
 		return bytes();
 	}
 
-	WriteGuard l(x_cache);
-	m_cache[_hash].resize(d.size());
-	memcpy(m_cache[_hash].data(), d.data(), d.size());
+	ret = asBytes(d);
+	m_blocks.insert(_hash, ret, ret.size());
+	return ret;
+}
+
+shared_ptr<LastHashes const> BlockChain::lastHashes(unsigned _n) const
+{
+	unsigned head = number();
+	if (_n > head)
+		_n = head;
+
+	shared_ptr<LastHashes const> known;
+	unsigned knownNumber;
+	{
+		ReadGuard l(x_lastHashes);
+		if (m_lastHashes && m_lastHashesNumber == _n)
+			return m_lastHashes;
+		known = m_lastHashes;
+		knownNumber = m_lastHashesNumber;
+	}
 
-	return m_cache[_hash];
+	auto ret = make_shared<LastHashes>(256);
+	unsigned i = 0;
+	if (known && knownNumber == head && _n < knownNumber && knownNumber - _n < 256)
+		// Reuse what we have of the head's; only the oldest few need looking up.
+		for (unsigned j = knownNumber - _n; j < 256; ++i, ++j)
+			(*ret)[i] = (*known)[j];
+	else
+		(*ret)[i++] = numberHash(_n);
+	for (; i < 256; ++i)
+		(*ret)[i] = (*ret)[i - 1] ? details((*ret)[i - 1]).parent : h256();
+
+	if (_n == head)
+	{
+		WriteGuard l(x_lastHashes);
+		if (currentHash() == ret->front())
+		{
+			m_lastHashes = ret;
+			m_lastHashesNumber = _n;
+		}
+	}
+	return ret;
 }
 
 h256 BlockChain::numberHash(unsigned _n) const
@@ -24,14 +24,17 @@
 #pragma warning(push)
 #pragma warning(disable: 4100 4267)
 #include <leveldb/db.h>
+#include <leveldb/write_batch.h>
 #pragma warning(pop)
 
+#include <chrono>
 #include <mutex>
 #include <libdevcore/Log.h>
 #include <libdevcore/Exceptions.h>
 #include <libethcore/CommonEth.h>
 #include <libethcore/BlockInfo.h>
 #include <libdevcore/Guards.h>
+#include <libdevcore/LruCache.h>
 #include "BlockDetails.h"
 #include "Account.h"
 #include "BlockQueue.h"
@@ -52,6 +55,7 @@ class State;
 struct AlreadyHaveBlock: virtual Exception {};
 struct UnknownParent: virtual Exception {};
 struct FutureTime: virtual Exception {};
+struct DatabaseWriteFailed: virtual Exception {};
 
 struct BlockChainChat: public LogChannel { static const char* name() { return "-B-"; } static const int verbosity = 7; };
 struct BlockChainNote: public LogChannel { static const char* name() { return "=B="; } static const int verbosity = 4; };
@@ -61,10 +65,21 @@ std::map<Address, Account> const& genesisState();
 
 ldb::Slice toSlice(h256 _h, unsigned _sub = 0);
 
+/// Statistics for each of BlockChain's caches.
+struct BlockChainCacheStats
+{
+	CacheStats details;
+	CacheStats logBlooms;
+	CacheStats receipts;
+	CacheStats blocks;
+};
+
+std::ostream& operator<<(std::ostream& _out, BlockChainCacheStats const& _s);
+
 /**
  * @brief Implements the blockchain database. All data this gives is disk-backed.
+ * Recently used blocks and extras are kept in memory-bounded LRU caches.
  * @threadsafe
- * @todo Make not memory hog (should actually act as a cache and deallocate old entries).
  */
 class BlockChain
 {
@@ -74,10 +89,17 @@ public:
 
 	void reopen(std::string _path, bool _killExisting = false) { close(); open(_path, _killExisting); }
 
-	/// (Potentially) renders invalid existing bytesConstRef returned by lastBlock.
+	/// Bring the caches back within budget and periodically note their statistics.
 	/// To be called from main loop every 100ms or so.
 	void process();
 
+	/// Set the total memory budget, in bytes, of the block and extras caches.
+	void setCacheBudget(size_t _bytes);
+	/// @returns the hit, miss and eviction counts and the memory usage of each cache.
+	BlockChainCacheStats cacheStats() const;
+	/// @returns LevelDB's statistics for the blocks and details databases.
+	std::string databaseStats() const;
+
 	/// Sync the chain with any incoming blocks. All blocks should, if processed in order
 	h256s sync(BlockQueue& _bq, OverlayDB const& _stateDB, unsigned _max);
 
@@ -88,6 +110,14 @@ public:
 	/// Import block into disk-backed DB
 	/// @returns the block hashes of any blocks that came into/went out of the canonical block chain.
 	h256s import(bytes const& _block, OverlayDB const& _stateDB);
+	/// Import a block that has already been through verifyBlock() into disk-backed DB.
+	/// @returns the block hashes of any blocks that came into/went out of the canonical block chain.
+	h256s import(VerifiedBlock const& _block, OverlayDB const& _stateDB);
+
+	/// Checks the block @a _block is internally coherent, parsing its header and transactions and recovering their senders.
+	/// Needs no access to the chain, so may be called from any thread.
+	/// @throws if the block is malformed.
+	static VerifiedBlock verifyBlock(bytesConstRef _block, bool _checkNonce = true);
 
 	/// Returns true if the given block is known (though not necessarily a part of the canon chain).
 	bool isKnown(h256 _hash) const;
@@ -97,16 +127,22 @@ public:
 	BlockInfo info() const { return BlockInfo(block()); }
 
 	/// Get the familial details concerning a block (or the most recent mined if none given). Thread-safe.
-	BlockDetails details(h256 _hash) const { return queryExtras<BlockDetails, 0>(_hash, m_details, x_details, NullBlockDetails); }
+	BlockDetails details(h256 _hash) const { return queryExtras<BlockDetails, 0>(_hash, m_details, NullBlockDetails); }
 	BlockDetails details() const { return details(currentHash()); }
 
 	/// Get the transactions' log blooms of a block (or the most recent mined if none given). Thread-safe.
-	BlockLogBlooms logBlooms(h256 _hash) const { return queryExtras<BlockLogBlooms, 3>(_hash, m_logBlooms, x_logBlooms, NullBlockLogBlooms); }
+	BlockLogBlooms logBlooms(h256 _hash) const { return queryExtras<BlockLogBlooms, 3>(_hash, m_logBlooms, NullBlockLogBlooms); }
 	BlockLogBlooms logBlooms() const { return logBlooms(currentHash()); }
 
 	/// Get the transactions' receipts of a block (or the most recent mined if none given). Thread-safe.
-	BlockReceipts receipts(h256 _hash) const { return queryExtras<BlockReceipts, 4>(_hash, m_receipts, x_receipts, NullBlockReceipts); }
+	BlockReceipts receipts(h256 _hash) const { return queryExtras<BlockReceipts, 4>(_hash, m_receipts, NullBlockReceipts); }
 	BlockReceipts receipts() const { return receipts(currentHash()); }
+	/// Get receipt @a _i of a block, decoding none of its others unless they're already cached. Thread-safe.
+	/// @throws if there's no such receipt.
+	TransactionReceipt receipt(h256 _blockHash, unsigned _i) const;
+	/// Get log @a _log of receipt @a _receipt of a block, decoding nothing else of its receipts. Thread-safe.
+	/// @throws if there's no such log.
+	LogEntry log(h256 _blockHash, unsigned _receipt, unsigned _log) const;
 
 	/// Get a block (RLP format) for the given hash (or the most recent mined if none given). Thread-safe.
 	bytes block(h256 _hash) const;
@@ -129,6 +165,11 @@ public:
 	/// Get the hash of a block of a given number. Slow; try not to use it too much.
 	h256 numberHash(unsigned _n) const;
 
+	/// Get the hashes of the 256 canonical blocks ending with number @a _n, most recent first. Thread-safe.
+	/// Those ending at the head are kept up to date as blocks are imported, so this is usually O(1).
+	std::shared_ptr<LastHashes const> lastHashes(unsigned _n) const;
+	std::shared_ptr<LastHashes const> lastHashes() const { return lastHashes(number()); }
+
 	/// Get all blocks not allowed as uncles given a parent (i.e. featured as uncles/main in parent, parent + 1, ... parent + 5).
 	/// @returns set including the header-hash of every parent (including @a _parent) up to and including generation +5
 	/// togther with all their quoted uncles.
@@ -154,54 +195,105 @@ private:
 	void open(std::string _path, bool _killExisting = false);
 	void close();
 
-	template<class T, unsigned N> T queryExtras(h256 _h, std::map<h256, T>& _m, boost::shared_mutex& _x, T const& _n) const
+	template <class T> using ExtrasCache = LruCache<h256, T, LeadingBytesHash>;
+
+	/// @returns the number of bytes to charge the cache for @a _t, whose RLP is @a _rlpSize bytes.
+	template <class T> static size_t cacheSize(T const&, size_t _rlpSize) { return sizeof(T) + _rlpSize; }
+	/// The stored receipts are far more compact than the decoded ones, which each carry a bloom, so measure the latter.
+	static size_t cacheSize(BlockReceipts const& _r, size_t) { return _r.memoryUsage(); }
+
+	/// @returns the extras of kind @a N for @a _h as stored in the extras DB (or about to be), or an empty string if there are none.
+	template<unsigned N> std::string extrasRaw(h256 _h) const
 	{
+		std::string ret;
 		{
-			ReadGuard l(_x);
-			auto it = _m.find(_h);
-			if (it != _m.end())
+			ReadGuard l(x_pendingExtras);
+			auto it = m_pendingExtras.find(toSlice(_h, N).ToString());
+			if (it != m_pendingExtras.end())
 				return it->second;
 		}
+		m_extrasDB->Get(m_readOptions, toSlice(_h, N), &ret);
+		return ret;
+	}
 
-		std::string s;
-		m_extrasDB->Get(m_readOptions, toSlice(_h, N), &s);
+	template<class T, unsigned N> T queryExtras(h256 _h, ExtrasCache<T>& _m, T const& _n) const
+	{
+		T ret;
+		if (_m.get(_h, ret))
+			return ret;
+
+		std::string s = extrasRaw<N>(_h);
 		if (s.empty())
 		{
 //			cout << "Not found in DB: " << _h << endl;
 			return _n;
 		}
 
-		WriteGuard l(_x);
-		auto ret = _m.insert(std::make_pair(_h, T(RLP(s))));
-		return ret.first->second;
+		ret = T(RLP(s));
+		_m.insert(_h, ret, cacheSize(ret, s.size()));
+		return ret;
+	}
+
+	/// Put the given extras into the cache and the extras to be written by the next commitImports().
+	template<class T, unsigned N> void writeExtras(h256 _h, T const& _t, ExtrasCache<T>& _m)
+	{
+		bytes b = _t.rlp();
+		_m.insert(_h, _t, cacheSize(_t, b.size()));
+		WriteGuard l(x_pendingExtras);
+		m_pendingExtras[toSlice(_h, N).ToString()] = asString(b);
 	}
 
+	/// Writes the block @a _block to the blocks DB straight away, unsynced, together with an import marker for it.
+	/// The marker goes in the same batch, so the block can't reach the disk without it.
+	void writeBlock(h256 const& _hash, bytesConstRef _block);
+
+	/// Writes the extras of all the blocks imported since the last call, as one batch. The blocks DB is synced first,
+	/// so the extras can't reach the disk before their blocks; this is the only synced write of an import run.
+	/// The markers stay until the extras are known to be on disk too: every c_maxUnsyncedImports blocks the extras
+	/// are written synced and the markers of those blocks removed. open() removes any block that has a marker but
+	/// no details, i.e. whose import was cut short.
+	void commitImports();
+
+	/// @throws DatabaseWriteFailed unless @a _s is ok.
+	static void checkWrite(ldb::Status const& _s);
+
 	void checkConsistency();
 
-	/// The caches of the disk DB and their locks.
-	mutable boost::shared_mutex x_details;
-	mutable BlockDetailsHash m_details;
-	mutable boost::shared_mutex x_logBlooms;
-	mutable BlockLogBloomsHash m_logBlooms;
-	mutable boost::shared_mutex x_receipts;
-	mutable BlockReceiptsHash m_receipts;
-	mutable boost::shared_mutex x_cache;
-	mutable std::map<h256, bytes> m_cache;
+	/// The caches of the disk DB. Each is internally locked.
+	mutable ExtrasCache<BlockDetails> m_details;
+	mutable ExtrasCache<BlockLogBlooms> m_logBlooms;
+	mutable ExtrasCache<BlockReceipts> m_receipts;
+	mutable LruCache<h256, bytes, LeadingBytesHash> m_blocks;
+	std::chrono::steady_clock::time_point m_lastStatsNote;
 
 	/// The disk DBs. Thread-safe, so no need for locks.
 	ldb::DB* m_db;
 	ldb::DB* m_extrasDB;
 
+	/// Extras not yet written to the extras DB, keyed as they will be there. Looked at before the DB.
+	mutable SharedMutex x_pendingExtras;
+	std::map<std::string, std::string> m_pendingExtras;
+	/// The blocks whose import markers are still in the blocks DB, as their extras may not have reached the disk.
+	h256s m_unsyncedImports;
+	/// Nonzero while sync() imports a run of blocks; commitImports() is then left until the run is done.
+	unsigned m_importRun = 0;
+
 	/// Hash of the last (valid) block on the longest chain.
 	mutable boost::shared_mutex x_lastBlockHash;
 	h256 m_lastBlockHash;
 
+	/// The last hashes ending at the head, if known, and the head's number.
+	mutable boost::shared_mutex x_lastHashes;
+	mutable std::shared_ptr<LastHashes const> m_lastHashes;
+	mutable unsigned m_lastHashesNumber = 0;
+
 	/// Genesis block info.
 	h256 m_genesisHash;
 	bytes m_genesisBlock;
 
 	ldb::ReadOptions m_readOptions;
 	ldb::WriteOptions m_writeOptions;
+	ldb::WriteOptions m_syncWriteOptions;		///< As m_writeOptions, but waiting until the write has reached the disk.
 
 	friend std::ostream& operator<<(std::ostream& _out, BlockChain const& _bc);
 };
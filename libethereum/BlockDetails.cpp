@@ -21,6 +21,8 @@
 
 #include "BlockDetails.h"
 
+#include <map>
+#include <stdexcept>
 #include <libdevcore/Common.h>
 using namespace std;
 using namespace dev;
@@ -38,3 +40,135 @@ bytes BlockDetails::rlp() const
 {
 	return rlpList(number, totalDifficulty, parent, children);
 }
+
+namespace
+{
+
+/// The fields of the stored receipts: the format version, the address and topic dictionaries, then one column
+/// per receipt field. Logs are stored as [address index, [topic index, ...], data].
+enum ReceiptsField { Version, AddressDict, TopicDict, StateRoots, GasUsed, Logs, ReceiptsFieldCount };
+
+static const unsigned c_receiptsVersion = 1;
+
+/// Earlier versions stored a plain list of receipts, each itself a list; the version tag never is.
+bool isColumnar(RLP const& _r)
+{
+	return _r.itemCount() && !_r[Version].isList();
+}
+
+/// @a _addresses and @a _topics are the dictionaries, either already decoded or as stored.
+template <class A, class T> LogEntry decodeLog(RLP const& _l, A const& _addresses, T const& _topics)
+{
+	LogEntry ret;
+	ret.address = (Address)_addresses[_l[0].toInt<unsigned>()];
+	for (auto const& t: _l[1])
+		ret.topics.push_back((h256)_topics[t.toInt<unsigned>()]);
+	ret.data = _l[2].toBytes();
+	return ret;
+}
+
+template <class A, class T> TransactionReceipt decodeReceipt(RLP const& _root, RLP const& _gasUsed, RLP const& _logs, A const& _addresses, T const& _topics)
+{
+	LogEntries logs;
+	for (auto const& l: _logs)
+		logs.push_back(decodeLog(l, _addresses, _topics));
+	return TransactionReceipt((h256)_root, _gasUsed.toInt<u256>(), logs);
+}
+
+}
+
+BlockReceipts::BlockReceipts(RLP const& _r)
+{
+	if (!isColumnar(_r))
+	{
+		for (auto const& i: _r)
+			receipts.emplace_back(i.data());
+		return;
+	}
+
+	Addresses addresses = _r[AddressDict].toVector<Address>();
+	h256s topics = _r[TopicDict].toVector<h256>();
+	// Held, so that walking them in order is linear.
+	RLP roots = _r[StateRoots];
+	RLP gasUsed = _r[GasUsed];
+	RLP logs = _r[Logs];
+	unsigned n = roots.itemCount();
+	receipts.reserve(n);
+	for (unsigned i = 0; i < n; ++i)
+		receipts.push_back(decodeReceipt(roots[i], gasUsed[i], logs[i], addresses, topics));
+}
+
+bytes BlockReceipts::rlp() const
+{
+	map<Address, unsigned> addressIndex;
+	map<h256, unsigned> topicIndex;
+	Addresses addresses;
+	h256s topics;
+
+	RLPStream roots(receipts.size());
+	RLPStream gasUsed(receipts.size());
+	RLPStream logs(receipts.size());
+	for (TransactionReceipt const& r: receipts)
+	{
+		roots << r.stateRoot();
+		gasUsed << r.gasUsed();
+		logs.appendList(r.log().size());
+		for (LogEntry const& l: r.log())
+		{
+			auto a = addressIndex.insert(make_pair(l.address, (unsigned)addresses.size()));
+			if (a.second)
+				addresses.push_back(l.address);
+			logs.appendList(3) << a.first->second;
+			logs.appendList(l.topics.size());
+			for (h256 const& t: l.topics)
+			{
+				auto it = topicIndex.insert(make_pair(t, (unsigned)topics.size()));
+				if (it.second)
+					topics.push_back(t);
+				logs << it.first->second;
+			}
+			logs << l.data;
+		}
+	}
+
+	RLPStream s(ReceiptsFieldCount);
+	s << c_receiptsVersion << addresses << topics;
+	s.appendRaw(roots.out()).appendRaw(gasUsed.out()).appendRaw(logs.out());
+	return s.out();
+}
+
+size_t BlockReceipts::memoryUsage() const
+{
+	size_t ret = sizeof(BlockReceipts) + receipts.capacity() * sizeof(TransactionReceipt);
+	for (TransactionReceipt const& r: receipts)
+		for (LogEntry const& l: r.log())
+			ret += sizeof(LogEntry) + l.topics.size() * sizeof(h256) + l.data.size();
+	return ret;
+}
+
+TransactionReceipt BlockReceipts::receipt(RLP const& _r, unsigned _i)
+{
+	if (!isColumnar(_r))
+	{
+		if (_i >= _r.itemCount())
+			throw std::out_of_range("No such receipt");
+		return TransactionReceipt(_r[_i].data());
+	}
+	if (_i >= _r[StateRoots].itemCount())
+		throw std::out_of_range("No such receipt");
+	return decodeReceipt(_r[StateRoots][_i], _r[GasUsed][_i], _r[Logs][_i], _r[AddressDict], _r[TopicDict]);
+}
+
+LogEntry BlockReceipts::log(RLP const& _r, unsigned _receipt, unsigned _log)
+{
+	if (!isColumnar(_r))
+	{
+		if (_receipt >= _r.itemCount() || _log >= _r[_receipt][3].itemCount())
+			throw std::out_of_range("No such log");
+		return LogEntry(_r[_receipt][3][_log]);
+	}
+	RLP logs = _r[Logs];
+	if (_receipt >= logs.itemCount() || _log >= logs[_receipt].itemCount())
+		throw std::out_of_range("No such log");
+	return decodeLog(logs[_receipt][_log], _r[AddressDict], _r[TopicDict]);
+}
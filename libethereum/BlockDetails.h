@@ -61,11 +61,26 @@ struct BlockLogBlooms
 	h512s blooms;
 };
 
+/**
+ * @brief The transactions' receipts of a block.
+ * Stored column by column (state roots, gas used, logs), with each distinct log address and topic written once
+ * and referred to by its index. Blooms aren't stored; they're recomputed from the logs. The static accessors
+ * decode a single receipt or log of the stored form without decoding the rest. Receipts stored as a plain list
+ * of receipts by earlier versions are still read.
+ */
 struct BlockReceipts
 {
 	BlockReceipts() {}
-	BlockReceipts(RLP const& _r) { for (auto const& i: _r) receipts.emplace_back(i.data()); }
-	bytes rlp() const { RLPStream s(receipts.size()); for (TransactionReceipt const& i: receipts) i.streamRLP(s); return s.out(); }
+	BlockReceipts(RLP const& _r);
+	bytes rlp() const;
+
+	/// @returns the (approximate) number of bytes the decoded receipts take in memory.
+	size_t memoryUsage() const;
+
+	/// @returns receipt @a _i of the stored receipts @a _r. Throws std::out_of_range if there's no such receipt.
+	static TransactionReceipt receipt(RLP const& _r, unsigned _i);
+	/// @returns log @a _log of receipt @a _receipt of the stored receipts @a _r. Throws std::out_of_range if there's no such log.
+	static LogEntry log(RLP const& _r, unsigned _receipt, unsigned _log);
 
 	TransactionReceipts receipts;
 };
@@ -22,6 +22,7 @@
 #include "BlockQueue.h"
 
 #include <libdevcore/Log.h>
+#include <libdevcore/CommonIO.h>
 #include <libethcore/Exceptions.h>
 #include <libethcore/BlockInfo.h>
 #include "BlockChain.h"
@@ -29,6 +30,44 @@ using namespace std;
 using namespace dev;
 using namespace dev::eth;
 
+BlockQueue::BlockQueue()
+{
+	// Allow some room for other activity.
+	unsigned verifierThreads = max(thread::hardware_concurrency(), 3U) - 2U;
+	for (unsigned i = 0; i < verifierThreads; ++i)
+		m_verifiers.emplace_back([=](){
+			setThreadName(("verifier" + toString(i)).c_str());
+			this->verifierBody();
+		});
+}
+
+BlockQueue::~BlockQueue()
+{
+	{
+		WriteGuard l(m_lock);
+		m_deleting = true;
+	}
+	m_moreToVerify.notify_all();
+	for (auto& i: m_verifiers)
+		i.join();
+}
+
+void BlockQueue::clear()
+{
+	WriteGuard l(m_lock);
+	m_readySet.clear();
+	m_drainingSet.clear();
+	m_ready.clear();
+	m_unverified.clear();
+	m_verifying.clear();
+	m_verifyingSet.clear();
+	m_verifiedSet.clear();
+	m_knownBad.clear();
+	m_unknownSet.clear();
+	m_unknown.clear();
+	m_future.clear();
+}
+
 ImportResult BlockQueue::import(bytesConstRef _block, BlockChain const& _bc)
 {
 	// Check if we already know this block.
@@ -38,14 +77,21 @@ ImportResult BlockQueue::import(bytesConstRef _block, BlockChain const& _bc)
 
 	UpgradableGuard l(m_lock);
 
-	if (m_readySet.count(h) || m_drainingSet.count(h) || m_unknownSet.count(h))
+	if (m_readySet.count(h) || m_drainingSet.count(h) || m_unknownSet.count(h) || m_verifyingSet.count(h) || m_verifiedSet.count(h))
 	{
 		// Already know about this one.
 		cblockq << "Already known.";
 		return ImportResult::AlreadyKnown;
 	}
 
-	// VERIFY: populates from the block and checks the block is internally coherent.
+	if (m_knownBad.contains(h))
+	{
+		cblockq << "Already known to be bad.";
+		return ImportResult::Malformed;
+	}
+
+	// VERIFY: populates from the block and checks the header (including the proof-of-work).
+	// The block's internals are verified later by one of the verifier threads.
 	BlockInfo bi;
 
 #if ETH_CATCH
@@ -53,7 +99,6 @@ ImportResult BlockQueue::import(bytesConstRef _block, BlockChain const& _bc)
 #endif
 	{
 		bi.populate(_block);
-		bi.verifyInternals(_block);
 	}
 #if ETH_CATCH
 	catch (Exception const& _e)
@@ -82,7 +127,21 @@ ImportResult BlockQueue::import(bytesConstRef _block, BlockChain const& _bc)
 	else
 	{
 		// We now know it.
-		if (!m_readySet.count(bi.parentHash) && !m_drainingSet.count(bi.parentHash) && !_bc.isKnown(bi.parentHash))
+		if (m_knownBad.contains(bi.parentHash))
+		{
+			cblockq << "Parent known to be bad.";
+			m_knownBad.insert(h, true, 1);
+			return ImportResult::Malformed;
+		}
+		else if (m_verifyingSet.count(bi.parentHash))
+		{
+			// The parent may yet fail verification, so hold this one back until it has passed.
+			cblockq << "OK - queued behind parent still verifying:" << bi.parentHash.abridged();
+			m_unknown.insert(make_pair(bi.parentHash, make_pair(h, _block.toBytes())));
+			m_unknownSet.insert(h);
+			return ImportResult::Success;
+		}
+		else if (!m_readySet.count(bi.parentHash) && !m_drainingSet.count(bi.parentHash) && !m_verifiedSet.count(bi.parentHash) && !_bc.isKnown(bi.parentHash))
 		{
 			// We don't know the parent (yet) - queue it up for later. It'll get resent to us if we find out about its ancestry later on.
 			cblockq << "OK - queued as unknown parent:" << bi.parentHash.abridged();
@@ -94,16 +153,75 @@ ImportResult BlockQueue::import(bytesConstRef _block, BlockChain const& _bc)
 		else
 		{
 			// If valid, append to blocks.
-			cblockq << "OK - ready for chain insertion.";
-			m_ready.push_back(_block.toBytes());
-			m_readySet.insert(h);
-
-			noteReadyWithoutWriteGuard(h);
+			cblockq << "OK - queued for verification.";
+			m_unverified.push_back(make_pair(h, _block.toBytes()));
+			m_verifyingSet.insert(h);
+			m_moreToVerify.notify_one();
 			return ImportResult::Success;
 		}
 	}
 }
 
+void BlockQueue::verifierBody()
+{
+	while (true)
+	{
+		pair<h256, bytes> work;
+		{
+			WriteGuard l(m_lock);
+			m_moreToVerify.wait(l, [&](){ return !m_unverified.empty() || m_deleting; });
+			if (m_deleting)
+				return;
+			swap(work, m_unverified.front());
+			m_unverified.pop_front();
+			// Keep our place in the order of blocks; the block is filled in once verification is done.
+			VerifiedBlock placeholder;
+			placeholder.info.hash = work.first;
+			m_verifying.push_back(move(placeholder));
+		}
+
+		bool ok = true;
+		VerifiedBlock res;
+		try
+		{
+			res = BlockChain::verifyBlock(&work.second);
+		}
+		catch (...)
+		{
+			cwarn << "Ignoring malformed block " << work.first.abridged() << ":" << boost::current_exception_diagnostic_information();
+			ok = false;
+		}
+
+		WriteGuard l(m_lock);
+		auto it = find_if(m_verifying.begin(), m_verifying.end(), [&](VerifiedBlock const& _i){ return _i.info.hash == work.first; });
+		if (it == m_verifying.end())
+			// Queue was cleared while we were verifying.
+			continue;
+		m_verifyingSet.erase(work.first);
+		if (ok)
+		{
+			*it = move(res);
+			m_verifiedSet.insert(work.first);
+			noteReadyWithoutWriteGuard(work.first);
+		}
+		else
+		{
+			m_verifying.erase(it);
+			m_knownBad.insert(work.first, true, 1);
+			noteBadWithoutWriteGuard(work.first);
+		}
+
+		// Move all verified blocks at the front into the ready list, keeping them in order.
+		while (!m_verifying.empty() && !m_verifying.front().block.empty())
+		{
+			m_verifiedSet.erase(m_verifying.front().info.hash);
+			m_readySet.insert(m_verifying.front().info.hash);
+			m_ready.push_back(move(m_verifying.front()));
+			m_verifying.pop_front();
+		}
+	}
+}
+
 void BlockQueue::tick(BlockChain const& _bc)
 {
 	unsigned t = time(0);
@@ -114,7 +232,7 @@ void BlockQueue::tick(BlockChain const& _bc)
 	m_future.erase(m_future.begin(), m_future.upper_bound(t));
 }
 
-void BlockQueue::drain(std::vector<bytes>& o_out)
+void BlockQueue::drain(VerifiedBlocks& o_out)
 {
 	WriteGuard l(m_lock);
 	if (m_drainingSet.empty())
@@ -126,18 +244,32 @@ void BlockQueue::drain(std::vector<bytes>& o_out)
 
 void BlockQueue::noteReadyWithoutWriteGuard(h256 _good)
 {
-	list<h256> goodQueue(1, _good);
-	while (!goodQueue.empty())
+	// Only the children are released; each of them releases its own once it has been verified.
+	auto r = m_unknown.equal_range(_good);
+	for (auto it = r.first; it != r.second; ++it)
+	{
+		m_unverified.push_back(it->second);
+		auto newReady = it->second.first;
+		m_unknownSet.erase(newReady);
+		m_verifyingSet.insert(newReady);
+		m_moreToVerify.notify_one();
+	}
+	m_unknown.erase(r.first, r.second);
+}
+
+void BlockQueue::noteBadWithoutWriteGuard(h256 _bad)
+{
+	list<h256> badQueue(1, _bad);
+	while (!badQueue.empty())
 	{
-		auto r = m_unknown.equal_range(goodQueue.front());
-		goodQueue.pop_front();
+		auto r = m_unknown.equal_range(badQueue.front());
+		badQueue.pop_front();
 		for (auto it = r.first; it != r.second; ++it)
 		{
-			m_ready.push_back(it->second.second);
-			auto newReady = it->second.first;
-			m_unknownSet.erase(newReady);
-			m_readySet.insert(newReady);
-			goodQueue.push_back(newReady);
+			auto newBad = it->second.first;
+			m_unknownSet.erase(newBad);
+			m_knownBad.insert(newBad, true, 1);
+			badQueue.push_back(newBad);
 		}
 		m_unknown.erase(r.first, r.second);
 	}
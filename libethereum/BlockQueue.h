@@ -21,11 +21,17 @@
 
 #pragma once
 
+#include <condition_variable>
+#include <deque>
+#include <thread>
 #include <boost/thread.hpp>
 #include <libdevcore/Common.h>
 #include <libdevcore/Log.h>
 #include <libethcore/CommonEth.h>
 #include <libdevcore/Guards.h>
+#include <libdevcore/FlatHash.h>
+#include <libdevcore/LruCache.h>
+#include "VerifiedBlock.h"
 
 namespace dev
 {
@@ -35,7 +41,7 @@ namespace eth
 class BlockChain;
 
 struct BlockQueueChannel: public LogChannel { static const char* name() { return "[]Q"; } static const int verbosity = 4; };
-#define cblockq dev::LogOutputStream<dev::eth::BlockQueueChannel, true>()
+#define cblockq LOG_STREAM(dev::eth::BlockQueueChannel, true)
 
 enum class ImportResult
 {
@@ -47,23 +53,37 @@ enum class ImportResult
 	Malformed
 };
 
+/// Maximum number of blocks awaiting verification or chain insertion before the queue reports itself as full.
+static const unsigned c_maxQueuedBlocks = 2048;
+
+/// Number of blocks that failed verification we remember, so as not to verify them again; older ones are forgotten.
+static const unsigned c_maxKnownBad = 16384;
+
 /**
  * @brief A queue of blocks. Sits between network or other I/O and the BlockChain.
  * Sorts them ready for blockchain insertion (with the BlockChain::sync() method).
+ * Only the header is checked on import; the (expensive) internal verification is done by a pool
+ * of verifier threads, so that callers (i.e. the network thread) are not stalled by it. A block whose
+ * parent is still being verified waits with the unknown-parent blocks until its parent passes, and is
+ * dropped if it doesn't. Blocks are handed out already parsed (see VerifiedBlock) so that the chain
+ * need not verify them again.
  * @threadsafe
  */
 class BlockQueue
 {
 public:
-	/// Import a block into the queue.
-	ImportResult import(bytesConstRef _tx, BlockChain const& _bc);
+	BlockQueue();
+	~BlockQueue();
+
+	/// Import a block into the queue. A return of Success means it has been queued for verification.
+	ImportResult import(bytesConstRef _block, BlockChain const& _bc);
 
 	/// Notes that time has moved on and some blocks that used to be "in the future" may no be valid.
 	void tick(BlockChain const& _bc);
 
 	/// Grabs the blocks that are ready, giving them in the correct order for insertion into the chain.
 	/// Don't forget to call doneDrain() once you're done importing.
-	void drain(std::vector<bytes>& o_out);
+	void drain(VerifiedBlocks& o_out);
 
 	/// Must be called after a drain() call. Notes that the drained blocks have been imported into the blockchain, so we can forget about them.
 	void doneDrain() { WriteGuard l(m_lock); m_drainingSet.clear(); }
@@ -72,23 +92,41 @@ public:
 	void noteReady(h256 _b) { WriteGuard l(m_lock); noteReadyWithoutWriteGuard(_b); }
 
 	/// Get information on the items queued.
-	std::pair<unsigned, unsigned> items() const { ReadGuard l(m_lock); return std::make_pair(m_ready.size(), m_unknown.size()); }
+	std::pair<unsigned, unsigned> items() const { ReadGuard l(m_lock); return std::make_pair(m_ready.size() + m_unverified.size() + m_verifying.size(), m_unknown.size()); }
+
+	/// @returns true if there are so many blocks awaiting verification or insertion that no more should be requested for now.
+	bool isFull() const { ReadGuard l(m_lock); return m_ready.size() + m_unverified.size() + m_verifying.size() >= c_maxQueuedBlocks; }
 
 	/// Clear everything.
-	void clear() { WriteGuard l(m_lock); m_readySet.clear(); m_drainingSet.clear(); m_ready.clear(); m_unknownSet.clear(); m_unknown.clear(); m_future.clear(); }
+	void clear();
 
 	/// Return first block with an unknown parent.
 	h256 firstUnknown() const { ReadGuard l(m_lock); return m_unknownSet.size() ? *m_unknownSet.begin() : h256(); }
 
 private:
+	/// Queue for verification the blocks waiting on @a _b, which is now verified or in the chain.
 	void noteReadyWithoutWriteGuard(h256 _b);
+	/// Forget the blocks waiting on @a _b, which failed verification, and their descendants, marking them all bad.
+	void noteBadWithoutWriteGuard(h256 _b);
 	void notePresentWithoutWriteGuard(bytesConstRef _block);
 
+	/// Body of each of the verifier threads.
+	void verifierBody();
+
 	mutable boost::shared_mutex m_lock;						///< General lock.
-	std::set<h256> m_readySet;								///< All blocks ready for chain-import.
-	std::set<h256> m_drainingSet;							///< All blocks being imported.
-	std::vector<bytes> m_ready;								///< List of blocks, in correct order, ready for chain-import.
-	std::set<h256> m_unknownSet;							///< Set of all blocks whose parents are not ready/in-chain.
+	std::condition_variable_any m_moreToVerify;				///< Signalled when m_unverified gains an item or we're shutting down.
+	std::deque<std::pair<h256, bytes>> m_unverified;		///< List of blocks, in correct order, awaiting verification.
+	std::deque<VerifiedBlock> m_verifying;					///< List of blocks, in correct order, being verified; only the hash is set until verification is complete.
+	FlatHashSet<h256> m_verifyingSet;						///< All blocks either unverified or being verified.
+	FlatHashSet<h256> m_verifiedSet;						///< All blocks verified but still in m_verifying behind an unfinished one.
+	LruCache<h256, bool, h256::hash> m_knownBad{c_maxKnownBad};	///< The most recent blocks that failed verification; each is charged as one "byte".
+	std::vector<std::thread> m_verifiers;					///< The verifier threads.
+	bool m_deleting = false;								///< Exit condition for verifiers.
+
+	FlatHashSet<h256> m_readySet;							///< All blocks ready for chain-import.
+	FlatHashSet<h256> m_drainingSet;						///< All blocks being imported.
+	VerifiedBlocks m_ready;									///< List of blocks, in correct order, verified and ready for chain-import.
+	FlatHashSet<h256> m_unknownSet;							///< Set of all blocks whose parents are not ready/in-chain.
 	std::multimap<h256, std::pair<h256, bytes>> m_unknown;	///< For transactions that have an unknown parent; we map their parent hash to the block stuff, and insert once the block appears.
 	std::multimap<unsigned, bytes> m_future;				///< Set of blocks that are not yet valid.
 };
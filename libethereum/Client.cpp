@@ -206,6 +206,7 @@ unsigned Client::installWatch(LogFilter const& _f)
 		{
 			cwatch << "FFF" << _f << h.abridged();
 			m_filters.insert(make_pair(h, _f));
+			m_filterIndex.insert(h, _f);
 		}
 	}
 	return installWatch(h);
@@ -228,6 +229,7 @@ void Client::uninstallWatch(unsigned _i)
 		if (!--fit->second.refCount)
 		{
 			cwatch << "*X*" << fit->first << ":" << fit->second.filter;
+			m_filterIndex.erase(fit->first, fit->second.filter);
 			m_filters.erase(fit);
 		}
 }
@@ -294,42 +296,49 @@ LocalisedLogEntries Client::checkWatch(unsigned _watchId)
 void Client::appendFromNewPending(TransactionReceipt const& _receipt, h256Set& io_changed)
 {
 	Guard l(m_filterLock);
-	for (pair<h256 const, InstalledFilter>& i: m_filters)
-		if ((unsigned)i.second.filter.latest() > m_bc.number())
+	unsigned number = m_bc.number() + 1;
+	h256Set candidates;
+	for (LogEntry const& e: _receipt.log())
+	{
+		candidates.clear();
+		m_filterIndex.candidates(e, candidates);
+		for (auto const& id: candidates)
 		{
-			// acceptable number.
-			auto m = i.second.filter.matches(_receipt);
-			if (m.size())
+			InstalledFilter& f = m_filters.at(id);
+			// acceptable number & the filter catches it.
+			if ((unsigned)f.filter.latest() >= number && f.filter.matches(e))
 			{
-				// filter catches them
-				for (LogEntry const& l: m)
-					i.second.changes.push_back(LocalisedLogEntry(l, m_bc.number() + 1));
-				io_changed.insert(i.first);
+				f.changes.push_back(LocalisedLogEntry(e, number));
+				io_changed.insert(id);
 			}
 		}
+	}
 }
 
 void Client::appendFromNewBlock(h256 const& _block, h256Set& io_changed)
 {
-	// TODO: more precise check on whether the txs match.
 	auto d = m_bc.info(_block);
 	auto br = m_bc.receipts(_block);
+	unsigned number = (unsigned)d.number;
 
 	Guard l(m_filterLock);
-	for (pair<h256 const, InstalledFilter>& i: m_filters)
-		if ((unsigned)i.second.filter.latest() >= d.number && (unsigned)i.second.filter.earliest() <= d.number && i.second.filter.matches(d.logBloom))
-			// acceptable number & looks like block may contain a matching log entry.
-			for (TransactionReceipt const& tr: br.receipts)
+	h256Set candidates;
+	for (TransactionReceipt const& tr: br.receipts)
+		for (LogEntry const& e: tr.log())
+		{
+			candidates.clear();
+			m_filterIndex.candidates(e, candidates);
+			for (auto const& id: candidates)
 			{
-				auto m = i.second.filter.matches(tr);
-				if (m.size())
+				InstalledFilter& f = m_filters.at(id);
+				// acceptable number & the filter catches it.
+				if ((unsigned)f.filter.latest() >= number && (unsigned)f.filter.earliest() <= number && f.filter.matches(e))
 				{
-					// filter catches them
-					for (LogEntry const& l: m)
-						i.second.changes.push_back(LocalisedLogEntry(l, (unsigned)d.number));
-					io_changed.insert(i.first);
+					f.changes.push_back(LocalisedLogEntry(e, number));
+					io_changed.insert(id);
 				}
 			}
+		}
 }
 
 void Client::setForceMining(bool _enable)
@@ -618,10 +627,24 @@ void Client::doWork()
 		}
 		for (auto i: toUninstall)
 			uninstallWatch(i);
+
+		// and on the blockchain's caches.
+		m_bc.process();
+
 		m_lastGarbageCollection = chrono::system_clock::now();
 	}
 }
 
+std::string Client::databaseStats() const
+{
+	std::ostringstream out;
+	out << "Storage profile: " << toString(Defaults::storageProfile()) << endl;
+	out << m_bc.databaseStats();
+	out << "State DB:" << endl << dev::eth::databaseStats(m_stateDB.db());
+	out << "Chain caches: " << m_bc.cacheStats() << endl;
+	return out.str();
+}
+
 unsigned Client::numberOf(int _n) const
 {
 	if (_n > 0)
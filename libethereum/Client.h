@@ -98,13 +98,13 @@ struct ClientWatch
 };
 
 struct WatchChannel: public LogChannel { static const char* name() { return "(o)"; } static const int verbosity = 7; };
-#define cwatch dev::LogOutputStream<dev::eth::WatchChannel, true>()
+#define cwatch LOG_STREAM(dev::eth::WatchChannel, true)
 struct WorkInChannel: public LogChannel { static const char* name() { return ">W>"; } static const int verbosity = 16; };
 struct WorkOutChannel: public LogChannel { static const char* name() { return "<W<"; } static const int verbosity = 16; };
 struct WorkChannel: public LogChannel { static const char* name() { return "-W-"; } static const int verbosity = 16; };
-#define cwork dev::LogOutputStream<dev::eth::WorkChannel, true>()
-#define cworkin dev::LogOutputStream<dev::eth::WorkInChannel, true>()
-#define cworkout dev::LogOutputStream<dev::eth::WorkOutChannel, true>()
+#define cwork LOG_STREAM(dev::eth::WorkChannel, true)
+#define cworkin LOG_STREAM(dev::eth::WorkInChannel, true)
+#define cworkout LOG_STREAM(dev::eth::WorkOutChannel, true)
 
 template <class T> struct ABISerialiser {};
 template <unsigned N> struct ABISerialiser<FixedHash<N>> { static bytes serialise(FixedHash<N> const& _t) { static_assert(N <= 32, "Cannot serialise hash > 32 bytes."); static_assert(N > 0, "Cannot serialise zero-length hash."); return bytes(32 - N, 0) + _t.asBytes(); } };
@@ -254,6 +254,8 @@ public:
 	dev::eth::State postState() const { ReadGuard l(x_stateDB); return m_postMine; }
 	/// Get the object representing the current canonical blockchain.
 	CanonBlockChain const& blockChain() const { return m_bc; }
+	/// Get LevelDB's statistics for the blocks, details and state databases, and the chain's cache usage.
+	std::string databaseStats() const;
 
 	// Mining stuff:
 
@@ -362,6 +364,7 @@ private:
 
 	mutable Mutex m_filterLock;
 	std::map<h256, InstalledFilter> m_filters;
+	LogFilterIndex m_filterIndex;			///< Which of m_filters might match a given log entry.
 	std::map<unsigned, ClientWatch> m_watches;
 
 	mutable std::chrono::system_clock::time_point m_lastGarbageCollection;
@@ -22,6 +22,7 @@
 #pragma once
 
 #include <libdevcore/Common.h>
+#include "StorageProfile.h"
 
 namespace dev
 {
@@ -39,9 +40,12 @@ public:
 	static Defaults* get() { if (!s_this) s_this = new Defaults; return s_this; }
 	static void setDBPath(std::string const& _dbPath) { get()->m_dbPath = _dbPath; }
 	static std::string const& dbPath() { return get()->m_dbPath; }
+	static void setStorageProfile(StorageProfile _p) { get()->m_storageProfile = _p; }
+	static StorageProfile storageProfile() { return get()->m_storageProfile; }
 
 private:
 	std::string m_dbPath;
+	StorageProfile m_storageProfile = StorageProfile::Full;
 
 	static Defaults* s_this;
 };
@@ -63,8 +63,10 @@ bool EthereumHost::ensureInitialised()
 		m_latestBlockSent = m_chain.currentHash();
 		clog(NetNote) << "Initialising: latest=" << m_latestBlockSent.abridged();
 
-		for (auto const& i: m_tq.transactions())
-			m_transactionsSent.insert(i.first);
+		// Anything already in the queue predates us; peers will ask for it when they need it.
+		m_newTransactions.clear();
+		m_tq.drainNew(m_newTransactions);
+		m_newTransactions.clear();
 		return true;
 	}
 	return false;
@@ -149,13 +151,14 @@ void EthereumHost::reset()
 	m_man.resetToChain(h256s());
 
 	m_latestBlockSent = h256();
-	m_transactionsSent.clear();
+	m_newTransactions.clear();
 }
 
 void EthereumHost::doWork()
 {
 	bool netChange = ensureInitialised();
 	auto h = m_chain.currentHash();
+	resumeDeferredBlocks();
 	// If we've finished our initial sync (including getting all the blocks into the chain so as to reduce invalid transactions), start trading transactions & blocks
 	if (!isSyncing() && m_chain.isKnown(m_latestBlockSent))
 	{
@@ -167,28 +170,59 @@ void EthereumHost::doWork()
 	(void)netChange;
 }
 
+void EthereumHost::resumeDeferredBlocks()
+{
+	if (m_bq.isFull())
+		return;
+	// The peer's sync state belongs to its session's strand, so the resumption itself is posted there.
+	for (auto p: peerSessions())
+		if (auto ep = p.first->cap<EthereumPeer>())
+			if (ep->m_blocksDeferred.exchange(false))
+				p.first->post([ep](){ ep->resumeBlocks(); });
+}
+
 void EthereumHost::maintainTransactions()
 {
-	// Send any new transactions.
+	// Only the transactions that arrived since the last tick are gossiped; a peer wanting the lot
+	// (having just finished its handshake) gets the whole pending set, copied at most once per tick.
+	m_newTransactions.clear();
+	m_tq.drainNew(m_newTransactions);
+	shared_ptr<map<h256, bytes>> all;
+
 	for (auto p: peerSessions())
 		if (auto ep = p.first->cap<EthereumPeer>().get())
 		{
-			bytes b;
+			if (!ep->m_requireTransactions && m_newTransactions.empty())
+				continue;
+			if (ep->m_requireTransactions && !all)
+				all = make_shared<map<h256, bytes>>(m_tq.transactions());
+
+			RLPStream ts;
 			unsigned n = 0;
-			for (auto const& i: m_tq.transactions())
-				if (ep->m_requireTransactions || (!m_transactionsSent.count(i.first) && !ep->m_knownTransactions.count(i.first)))
+			{
+				Guard l(ep->x_knownTransactions);
+				auto add = [&](pair<h256, bytes> const& _t)
 				{
-					b += i.second;
-					++n;
-					m_transactionsSent.insert(i.first);
-				}
-			ep->clearKnownTransactions();
+					if (!ep->m_knownTransactions.contains(_t.first))
+					{
+						ts.appendRaw(_t.second);
+						ep->m_knownTransactions.insert(_t.first);
+						++n;
+					}
+				};
+				if (ep->m_requireTransactions)
+					for (auto const& i: *all)
+						add(i);
+				else
+					for (auto const& i: m_newTransactions)
+						add(i);
+			}
 
 			if (n || ep->m_requireTransactions)
 			{
-				RLPStream ts;
-				ep->prep(ts, TransactionsPacket, n).appendRaw(b, n);
-				ep->sealAndSend(ts);
+				RLPStream s;
+				ep->prep(s, TransactionsPacket, n).appendRaw(ts.out(), n);
+				ep->sealAndSend(s);
 			}
 			ep->m_requireTransactions = false;
 		}
@@ -201,16 +235,20 @@ void EthereumHost::maintainBlocks(h256 _currentHash)
 	{
 		clog(NetMessageSummary) << "Sending a new block (current is" << _currentHash << ", was" << m_latestBlockSent << ")";
 
+		// Encode the block once; it's shared between all the peers' packets.
+		RLPStream ts;
+		ts.appendRaw(m_chain.block(), 1).append(m_chain.details().totalDifficulty);
+		bytes b;
+		ts.swapOut(b);
+		auto args = make_shared<bytes const>(move(b));
+
 		for (auto j: peerSessions())
 		{
 			auto p = j.first->cap<EthereumPeer>().get();
 
-			RLPStream ts;
-			p->prep(ts, NewBlockPacket, 2).appendRaw(m_chain.block(), 1).append(m_chain.details().totalDifficulty);
-
 			Guard l(p->x_knownBlocks);
 			if (!p->m_knownBlocks.count(_currentHash))
-				p->sealAndSend(ts);
+				p->sealAndSend(NewBlockPacket, args);
 			p->m_knownBlocks.clear();
 		}
 		m_latestBlockSent = _currentHash;
@@ -88,6 +88,9 @@ private:
 	void maintainTransactions();
 	void maintainBlocks(h256 _currentBlock);
 
+	/// Continue fetching blocks from those peers that held off because the block queue was full.
+	void resumeDeferredBlocks();
+
 	/// Get a bunch of needed blocks.
 	/// Removes them from our list of needed blocks.
 	/// @returns empty if there's no more blocks left to fetch, otherwise the blocks to fetch.
@@ -115,7 +118,7 @@ private:
 	DownloadMan m_man;
 
 	h256 m_latestBlockSent;
-	h256Set m_transactionsSent;
+	std::vector<std::pair<h256, bytes>> m_newTransactions;	///< Scratch space for the transactions newly arrived since the last tick.
 
 	std::set<p2p::NodeId> m_banned;
 };
@@ -37,11 +37,12 @@ using namespace p2p;
 #if defined(clogS)
 #undef clogS
 #endif
-#define clogS(X) dev::LogOutputStream<X, true>(false) << "| " << std::setw(2) << session()->socketId() << "] "
+#define clogS(X) LOG_SESSION_STREAM(X, session()->socketId())
 
 EthereumPeer::EthereumPeer(Session* _s, HostCapabilityFace* _h, unsigned _i):
 	Capability(_s, _h, _i),
-	m_sub(host()->m_man)
+	m_sub(host()->m_man),
+	m_blocksDeferred(false)
 {
 	transition(Asking::State);
 }
@@ -78,6 +79,12 @@ string toString(Asking _a)
 	return "?";
 }
 
+void EthereumPeer::resumeBlocks()
+{
+	if (m_asking == Asking::Blocks)
+		transition(Asking::Blocks);
+}
+
 void EthereumPeer::transition(Asking _a, bool _force)
 {
 	clogS(NetMessageSummary) << "Transition!" << ::toString(_a) << "from" << ::toString(m_asking) << ", " << (isSyncing() ? "syncing" : "holding") << (needsSyncing() ? "& needed" : "");
@@ -329,11 +336,10 @@ bool EthereumPeer::interpret(unsigned _id, RLP const& _r)
 		Guard l(x_knownTransactions);
 		for (unsigned i = 1; i < _r.itemCount(); ++i)
 		{
-			auto h = sha3(_r[i].data());
-			m_knownTransactions.insert(h);
-			if (!host()->m_tq.import(_r[i].data()))
-				// if we already had the transaction, then don't bother sending it on.
-				host()->m_transactionsSent.insert(h);
+			// The peer evidently has it, so never send it back. Whether it's new to us the queue decides;
+			// if so, the host will gossip it on to everyone else once it's verified.
+			m_knownTransactions.insert(sha3(_r[i].data()));
+			host()->m_tq.enqueue(_r[i].data());
 		}
 		break;
 	}
@@ -462,7 +468,16 @@ bool EthereumPeer::interpret(unsigned _id, RLP const& _r)
 		clogS(NetMessageSummary) << dec << success << "imported OK," << unknown << "with unknown parents," << future << "with future timestamps," << got << " already known," << repeated << " repeats received.";
 
 		if (m_asking == Asking::Blocks)
-			transition(Asking::Blocks);
+		{
+			if (host()->m_bq.isFull())
+			{
+				// Hold off asking for more until the block queue has caught up; the host will resume us.
+				clogS(NetNote) << "Block queue full. Deferring further block requests.";
+				m_blocksDeferred = true;
+			}
+			else
+				transition(Asking::Blocks);
+		}
 		break;
 	}
 	case NewBlockPacket:
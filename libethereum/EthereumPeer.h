@@ -22,13 +22,16 @@
 #pragma once
 
 #include <mutex>
+#include <atomic>
 #include <array>
 #include <set>
 #include <memory>
 #include <utility>
 #include <libdevcore/RLP.h>
 #include <libdevcore/Guards.h>
+#include <libdevcore/FlatHash.h>
 #include <libdevcore/RangeMask.h>
+#include <libdevcore/RollingBloom.h>
 #include <libethcore/CommonEth.h>
 #include <libp2p/Capability.h>
 #include "CommonNet.h"
@@ -76,15 +79,15 @@ private:
 	/// Transition state in a particular direction.
 	void transition(Asking _wantState, bool _force = false);
 
+	/// Carry on asking for blocks after a deferral. Must run on our session's strand.
+	void resumeBlocks();
+
 	/// Attempt to begin syncing with this peer; first check the peer has a more difficlult chain to download, then start asking for hashes, then move to blocks.
 	void attemptSync();
 
 	/// Abort the sync operation.
 	void abortSync();
 
-	/// Clear all known transactions.
-	void clearKnownTransactions() { std::lock_guard<std::mutex> l(x_knownTransactions); m_knownTransactions.clear(); }
-
 	/// Update our asking state.
 	void setAsking(Asking _g, bool _isSyncing);
 
@@ -129,10 +132,13 @@ private:
 	/// Have we received a GetTransactions packet that we haven't yet answered?
 	bool m_requireTransactions;
 
+	/// Are we waiting for the block queue to drain before asking for more blocks?
+	std::atomic<bool> m_blocksDeferred;		///< Set on our strand, cleared by the host once the block queue has room.
+
 	Mutex x_knownBlocks;
-	h256Set m_knownBlocks;					///< Blocks that the peer already knows about (that don't need to be sent to them).
+	FlatHashSet<h256> m_knownBlocks;		///< Blocks that the peer already knows about (that don't need to be sent to them).
 	Mutex x_knownTransactions;
-	h256Set m_knownTransactions;			///< Transactions that the peer already knows of.
+	RollingBloom m_knownTransactions;		///< Transactions that the peer (probably) already knows of; old entries are forgotten.
 
 };
 
@@ -0,0 +1,190 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file ExecutionTrace.cpp
+ * @date 2015
+ */
+
+#include "ExecutionTrace.h"
+
+#include <algorithm>
+#include <libevm/VM.h>
+#include "ExtVM.h"
+#include "State.h"
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+
+OnOpFunc ExecutionTrace::onOp()
+{
+	return [=](uint64_t _steps, Instruction _inst, bigint _newMemSize, bigint _gasCost, VM* _vm, ExtVMFace const* _ext)
+	{
+		record(_steps, _inst, _newMemSize, _gasCost, *_vm, *static_cast<ExtVM const*>(_ext));
+	};
+}
+
+void ExecutionTrace::writeStorage(unsigned _from, Address const& _a, u256 const& _key, u256 const& _value)
+{
+	auto& s = m_storage[_a];
+	u256 old = s.count(_key) ? s[_key] : 0;
+	if (_value)
+		s[_key] = _value;
+	else
+		s.erase(_key);
+	m_storageWrites.push_back(StorageWrite{_from, _a, _key, _value, old});
+}
+
+void ExecutionTrace::record(uint64_t _steps, Instruction _inst, bigint const& _newMemSize, bigint const& _gasCost, VM const& _vm, ExtVM const& _ext)
+{
+	unsigned i = m_steps.size();
+	u256s const& stack = _vm.stack();
+	bytesConstRef memory = _vm.memory();
+
+	// Frames deeper than this have returned. A store made by the very last step of one (e.g. before running out of
+	// gas) is only now known to have happened; should the call have failed it is undone below like the callee's others.
+	while (!m_frames.empty() && (m_frames.back().depth > _ext.depth || (m_frames.back().depth == _ext.depth && m_frames.back().vm != &_vm)))
+	{
+		Frame const& f = m_frames.back();
+		if (f.pendingStore)
+			writeStorage(i, m_steps[f.last].address, f.storeKey, f.storeValue);
+		m_frames.pop_back();
+	}
+
+	if (!m_storage.count(_ext.myAddress))
+		m_storage[_ext.myAddress] = m_baseStorage[_ext.myAddress] = _ext.state().storage(_ext.myAddress);
+
+	StepDelta d;
+	if (m_frames.empty() || m_frames.back().depth < _ext.depth)
+		m_frames.push_back(Frame{&_vm, _ext.depth, c_none, 0, u256s(), false, 0, 0});
+	Frame& f = m_frames.back();
+
+	if (f.last != c_none)
+	{
+		Instruction lastInst = m_steps[f.last].inst;
+		auto arg = [&](unsigned _n) { return f.stack.size() > _n ? f.stack[f.stack.size() - 1 - _n] : u256(0); };
+
+		// Memory written by the previous step; anything else new in memory is zero.
+		u256 offset;
+		u256 size;
+		switch (lastInst)
+		{
+		case Instruction::MSTORE: offset = arg(0); size = 32; break;
+		case Instruction::MSTORE8: offset = arg(0); size = 1; break;
+		case Instruction::CALLDATACOPY:
+		case Instruction::CODECOPY: offset = arg(0); size = arg(2); break;
+		case Instruction::EXTCODECOPY: offset = arg(1); size = arg(3); break;
+		case Instruction::CALL:
+		case Instruction::CALLCODE: offset = arg(5); size = arg(6); break;
+		default: break;
+		}
+		d.writesBegin = m_memoryWrites.size();
+		if (size && offset < memory.size())
+		{
+			size_t o = (size_t)offset;
+			size_t s = (size_t)min<u256>(size, memory.size() - o);
+			m_memoryWrites.push_back(MemoryWrite{o, bytes(memory.begin() + o, memory.begin() + o + s)});
+		}
+		d.writesEnd = m_memoryWrites.size();
+
+		if (f.pendingStore)
+			writeStorage(i, _ext.myAddress, f.storeKey, f.storeValue);
+
+		// A failed CALL or CREATE reverts everything its callees stored.
+		if ((lastInst == Instruction::CALL || lastInst == Instruction::CALLCODE || lastInst == Instruction::CREATE) && !stack.empty() && !stack.back())
+			for (unsigned w = m_storageWrites.size(); w > 0 && m_storageWrites[w - 1].from > f.last; --w)
+			{
+				StorageWrite u = m_storageWrites[w - 1];
+				writeStorage(i, u.address, u.key, u.old);
+			}
+	}
+	d.prev = f.last;
+
+	// Only the top of the stack changes from one step to the next.
+	size_t common = mismatch(f.stack.begin(), f.stack.begin() + min(f.stack.size(), stack.size()), stack.begin()).first - f.stack.begin();
+	d.pops = f.stack.size() - common;
+	d.pushesBegin = m_pushes.size();
+	m_pushes.insert(m_pushes.end(), stack.begin() + common, stack.end());
+	d.pushesEnd = m_pushes.size();
+	f.stack.resize(common);
+	f.stack.insert(f.stack.end(), stack.begin() + common, stack.end());
+	d.memorySize = memory.size();
+
+	if (++f.sinceCheckpoint >= m_checkpointInterval)
+	{
+		d.checkpoint = m_checkpoints.size();
+		m_checkpoints.push_back(make_pair(stack, memory.toBytes()));
+		f.sinceCheckpoint = 0;
+	}
+
+	f.last = i;
+	f.pendingStore = _inst == Instruction::SSTORE && stack.size() >= 2;
+	if (f.pendingStore)
+	{
+		f.storeKey = stack.back();
+		f.storeValue = stack[stack.size() - 2];
+	}
+
+	m_steps.push_back(TraceStep{_steps, _ext.myAddress, _vm.curPC(), _inst, _newMemSize, _vm.gas(), _gasCost, _ext.depth});
+	m_deltas.push_back(d);
+}
+
+TraceState ExecutionTrace::state(unsigned _i) const
+{
+	TraceState ret;
+
+	// Walk back to the nearest checkpoint (or the start of the frame), then replay the deltas.
+	vector<unsigned> replay;
+	unsigned j = _i;
+	for (; j != c_none && m_deltas[j].checkpoint == c_none; j = m_deltas[j].prev)
+		replay.push_back(j);
+	if (j != c_none)
+	{
+		ret.stack = m_checkpoints[m_deltas[j].checkpoint].first;
+		ret.memory = m_checkpoints[m_deltas[j].checkpoint].second;
+	}
+	for (auto k = replay.rbegin(); k != replay.rend(); ++k)
+	{
+		StepDelta const& d = m_deltas[*k];
+		ret.memory.resize(d.memorySize);
+		for (unsigned w = d.writesBegin; w < d.writesEnd; ++w)
+			copy(m_memoryWrites[w].data.begin(), m_memoryWrites[w].data.end(), ret.memory.begin() + m_memoryWrites[w].offset);
+		ret.stack.resize(ret.stack.size() - d.pops);
+		ret.stack.insert(ret.stack.end(), m_pushes.begin() + d.pushesBegin, m_pushes.begin() + d.pushesEnd);
+	}
+
+	Address const& a = m_steps[_i].address;
+	auto it = m_baseStorage.find(a);
+	if (it != m_baseStorage.end())
+		ret.storage = it->second;
+	for (StorageWrite const& w: m_storageWrites)
+		if (w.from > _i)
+			break;
+		else if (w.address == a)
+		{
+			if (w.value)
+				ret.storage[w.key] = w.value;
+			else
+				ret.storage.erase(w.key);
+		}
+	return ret;
+}
+
+map<u256, u256> const& ExecutionTrace::storage(Address const& _a) const
+{
+	static const map<u256, u256> c_empty;
+	auto it = m_storage.find(_a);
+	return it != m_storage.end() ? it->second : c_empty;
+}
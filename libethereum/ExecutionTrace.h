@@ -0,0 +1,151 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file ExecutionTrace.h
+ * @date 2015
+ */
+
+#pragma once
+
+#include <map>
+#include <vector>
+#include <libdevcore/Common.h>
+#include <libdevcrypto/Common.h>
+#include <libevmcore/Instruction.h>
+#include <libevm/ExtVMFace.h>
+
+namespace dev
+{
+namespace eth
+{
+
+class ExtVM;
+
+/// The full machine state before a step executes, as reconstructed by ExecutionTrace::state().
+struct TraceState
+{
+	u256s stack;
+	bytes memory;
+	std::map<u256, u256> storage;		///< Storage of the account whose code is executing.
+};
+
+/// A single VM step as recorded by ExecutionTrace; the machine state itself is kept only as deltas.
+struct TraceStep
+{
+	uint64_t steps;
+	Address address;
+	u256 curPC;
+	Instruction inst;
+	bigint newMemSize;
+	u256 gas;
+	bigint gasCost;
+	unsigned depth;
+};
+
+/**
+ * @brief Records a VM execution, step by step, for later inspection.
+ *
+ * Rather than copying the stack, memory and storage at each step, only what changed since the previous step in
+ * the same call frame is kept (stack pops and pushes, memory writes, storage writes), with a full copy of the
+ * stack and memory every few steps. The complete state for any step is rebuilt on demand by state().
+ * Storage is read from the state only once, when an account's code is first seen executing.
+ */
+class ExecutionTrace
+{
+public:
+	explicit ExecutionTrace(unsigned _checkpointInterval = 64): m_checkpointInterval(_checkpointInterval) {}
+
+	/// @returns an OnOpFunc that records each step into this trace. The trace must outlive the execution.
+	OnOpFunc onOp();
+
+	/// Record the state before a step; for use from within an OnOpFunc.
+	void record(uint64_t _steps, Instruction _inst, bigint const& _newMemSize, bigint const& _gasCost, VM const& _vm, ExtVM const& _ext);
+
+	/// @returns the number of steps recorded.
+	unsigned size() const { return m_steps.size(); }
+	/// @returns the step @a _i.
+	TraceStep const& step(unsigned _i) const { return m_steps[_i]; }
+	/// @returns the full machine state before step @a _i executed.
+	TraceState state(unsigned _i) const;
+
+	/// @returns the storage of @a _a as of the most recently recorded step.
+	std::map<u256, u256> const& storage(Address const& _a) const;
+
+private:
+	static const unsigned c_none = (unsigned)-1;
+
+	/// A write to memory made by the previous step of a frame.
+	struct MemoryWrite
+	{
+		size_t offset;
+		bytes data;
+	};
+
+	/// A write to storage, visible from the step @a from onwards. @a old allows it to be undone.
+	struct StorageWrite
+	{
+		unsigned from;
+		Address address;
+		u256 key;
+		u256 value;
+		u256 old;
+	};
+
+	/// How to get from the previous step of the same frame to this one.
+	struct StepDelta
+	{
+		unsigned prev = c_none;			///< Previous step in the same frame, or c_none if this is its first.
+		unsigned pops = 0;
+		unsigned pushesBegin = 0;		///< Range into m_pushes.
+		unsigned pushesEnd = 0;
+		unsigned writesBegin = 0;		///< Range into m_memoryWrites.
+		unsigned writesEnd = 0;
+		size_t memorySize = 0;
+		unsigned checkpoint = c_none;	///< Index into m_checkpoints of the full state after this step's delta.
+	};
+
+	/// A call frame still executing.
+	struct Frame
+	{
+		VM const* vm;
+		unsigned depth;
+		unsigned last;					///< Most recent step in this frame.
+		unsigned sinceCheckpoint;
+		u256s stack;					///< The stack as of step @a last.
+		bool pendingStore;				///< Step @a last was an SSTORE of @a storeValue to @a storeKey.
+		u256 storeKey;
+		u256 storeValue;
+	};
+
+	void writeStorage(unsigned _from, Address const& _a, u256 const& _key, u256 const& _value);
+
+	unsigned m_checkpointInterval;
+
+	std::vector<TraceStep> m_steps;
+	std::vector<StepDelta> m_deltas;
+	u256s m_pushes;
+	std::vector<MemoryWrite> m_memoryWrites;
+	std::vector<std::pair<u256s, bytes>> m_checkpoints;
+
+	std::map<Address, std::map<u256, u256>> m_baseStorage;		///< Storage of each account when first seen.
+	std::map<Address, std::map<u256, u256>> m_storage;			///< Storage of each account as of the latest step.
+	std::vector<StorageWrite> m_storageWrites;
+
+	std::vector<Frame> m_frames;
+};
+
+}
+}
@@ -167,18 +167,60 @@ bool Executive::create(Address _sender, u256 _endowment, u256 _gasPrice, u256 _g
 
 OnOpFunc Executive::simpleTrace()
 {
-	return [](uint64_t steps, Instruction inst, bigint newMemSize, bigint gasCost, VM* voidVM, ExtVMFace const* voidExt)
+	// The storage of the running contract is followed through its SSTOREs rather than re-read from the state trie at
+	// every step. It's read afresh when the frame changes, as a returning call's stores may have been reverted, and
+	// after the channel has been off, as stores will have been missed.
+	struct FollowedStorage
 	{
+		bool valid = false;
+		unsigned depth = 0;
+		Address address;
+		map<u256, u256> storage;
+		bool pending = false;		///< The last step was an SSTORE of value to key.
+		u256 key;
+		u256 value;
+	};
+	auto followed = make_shared<FollowedStorage>();
+	return [=](uint64_t steps, Instruction inst, bigint newMemSize, bigint gasCost, VM* voidVM, ExtVMFace const* voidExt)
+	{
+		FollowedStorage& f = *followed;
+		if (!isChannelVisible<VMTraceChannel>())
+		{
+			f.valid = false;
+			return;
+		}
 		ExtVM const& ext = *static_cast<ExtVM const*>(voidExt);
 		VM& vm = *voidVM;
 
+		if (!f.valid || f.depth != ext.depth || f.address != ext.myAddress)
+		{
+			f.valid = true;
+			f.depth = ext.depth;
+			f.address = ext.myAddress;
+			f.storage = ext.state().storage(ext.myAddress);
+		}
+		else if (f.pending)
+		{
+			if (f.value)
+				f.storage[f.key] = f.value;
+			else
+				f.storage.erase(f.key);
+		}
+		u256s const& stack = vm.stack();
+		f.pending = inst == Instruction::SSTORE && stack.size() >= 2;
+		if (f.pending)
+		{
+			f.key = stack.back();
+			f.value = stack[stack.size() - 2];
+		}
+
 		ostringstream o;
 		o << endl << "    STACK" << endl;
 		for (auto i: vm.stack())
 			o << (h256)i << endl;
 		o << "    MEMORY" << endl << (vm.memory().size() > 1000) ? " mem size greater than 1000 bytes " : memDump(vm.memory());
 		o << "    STORAGE" << endl;
-		for (auto const& i: ext.state().storage(ext.myAddress))
+		for (auto const& i: f.storage)
 			o << showbase << hex << i.first << ": " << i.second << endl;
 		dev::LogOutputStream<VMTraceChannel, false>(true) << o.str();
 		dev::LogOutputStream<VMTraceChannel, false>(false) << " | " << dec << ext.depth << " | " << ext.myAddress << " | #" << steps << " | " << hex << setw(4) << setfill('0') << vm.curPC() << " : " << instructionInfo(inst).name << " | " << dec << vm.gas() << " | -" << dec << gasCost << " | " << newMemSize << "x32" << " ]";
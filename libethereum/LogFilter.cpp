@@ -46,25 +46,40 @@ h256 LogFilter::sha3() const
 	return dev::sha3(s.out());
 }
 
+/// @returns the bits of a LogBloom that would be set by a log entry with @a _h among its address and topics.
+template <class T> static LogBloom bloomMask(T const& _h)
+{
+	return dev::sha3(_h).template nbloom<3, LogBloom::size>();
+}
+
+LogFilter LogFilter::address(Address _a)
+{
+	if (m_addresses.insert(_a).second)
+		m_addressBlooms.push_back(bloomMask(_a));
+	return *this;
+}
+
+LogFilter LogFilter::topic(unsigned _index, h256 const& _t)
+{
+	if (_index < 4 && m_topics[_index].insert(_t).second)
+		m_topicBlooms[_index].push_back(bloomMask(_t));
+	return *this;
+}
+
 bool LogFilter::matches(LogBloom _bloom) const
 {
-	if (m_addresses.size())
+	auto anyIn = [&](LogBlooms const& _masks)
 	{
-		for (auto const& i: m_addresses)
-			if (_bloom.containsBloom<3>(dev::sha3(i)))
-				goto OK1;
+		for (auto const& m: _masks)
+			if (_bloom.contains(m))
+				return true;
 		return false;
-	}
-	OK1:
-	for (auto const& t: m_topics)
-		if (t.size())
-		{
-			for (auto const& i: t)
-				if (_bloom.containsBloom<3>(dev::sha3(i)))
-					goto OK2;
+	};
+	if (m_addressBlooms.size() && !anyIn(m_addressBlooms))
+		return false;
+	for (auto const& t: m_topicBlooms)
+		if (t.size() && !anyIn(t))
 			return false;
-			OK2:;
-		}
 	return true;
 }
 
@@ -78,14 +93,79 @@ LogEntries LogFilter::matches(TransactionReceipt const& _m) const
 	LogEntries ret;
 	if (matches(_m.bloom()))
 		for (LogEntry const& e: _m.log())
+			if (matches(e))
+				ret.push_back(e);
+	return ret;
+}
+
+bool LogFilter::matches(LogEntry const& _e) const
+{
+	if (!m_addresses.empty() && !m_addresses.count(_e.address))
+		return false;
+	for (unsigned i = 0; i < 4; ++i)
+		if (!m_topics[i].empty() && (_e.topics.size() <= i || !m_topics[i].count(_e.topics[i])))
+			return false;
+	return true;
+}
+
+void LogFilterIndex::insert(h256 const& _id, LogFilter const& _f)
+{
+	if (!_f.addresses().empty())
+	{
+		for (auto const& a: _f.addresses())
+			m_byAddress[a].insert(_id);
+		return;
+	}
+	for (auto const& t: _f.topics())
+		if (!t.empty())
 		{
-			if (!m_addresses.empty() && !m_addresses.count(e.address))
-				goto continue2;
-			for (unsigned i = 0; i < 4; ++i)
-				if (!m_topics[i].empty() && (e.topics.size() < i || !m_topics[i].count(e.topics[i])))
-					goto continue2;
-			ret.push_back(e);
-			continue2:;
+			for (auto const& i: t)
+				m_byTopic[i].insert(_id);
+			return;
 		}
-	return ret;
+	m_unindexed.insert(_id);
+}
+
+template <class M, class K> static void eraseFrom(M& _m, K const& _k, h256 const& _id)
+{
+	auto it = _m.find(_k);
+	if (it != _m.end())
+	{
+		it->second.erase(_id);
+		if (it->second.empty())
+			_m.erase(it);
+	}
+}
+
+void LogFilterIndex::erase(h256 const& _id, LogFilter const& _f)
+{
+	if (!_f.addresses().empty())
+	{
+		for (auto const& a: _f.addresses())
+			eraseFrom(m_byAddress, a, _id);
+		return;
+	}
+	for (auto const& t: _f.topics())
+		if (!t.empty())
+		{
+			for (auto const& i: t)
+				eraseFrom(m_byTopic, i, _id);
+			return;
+		}
+	m_unindexed.erase(_id);
+}
+
+void LogFilterIndex::candidates(LogEntry const& _e, h256Set& o_ids) const
+{
+	auto a = m_byAddress.find(_e.address);
+	if (a != m_byAddress.end())
+		o_ids.insert(a->second.begin(), a->second.end());
+	if (!m_byTopic.empty())
+		for (auto const& t: _e.topics)
+		{
+			auto it = m_byTopic.find(t);
+			if (it != m_byTopic.end())
+				o_ids.insert(it->second.begin(), it->second.end());
+		}
+	o_ids.insert(m_unindexed.begin(), m_unindexed.end());
 }
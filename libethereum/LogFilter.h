@@ -42,6 +42,11 @@ std::ostream& operator<<(std::ostream& _out, dev::eth::LogFilter const& _s);
 
 class State;
 
+/**
+ * @brief A filter on log entries by address and topics, and on blocks by number.
+ * The bloom masks of the addresses and topics are computed as they're added, so checking a bloom
+ * needs no hashing.
+ */
 class LogFilter
 {
 public:
@@ -57,9 +62,14 @@ public:
 	bool matches(LogBloom _bloom) const;
 	bool matches(State const& _s, unsigned _i) const;
 	LogEntries matches(TransactionReceipt const& _r) const;
+	/// @returns true if the log entry @a _e is one of those sought (ignoring block numbers).
+	bool matches(LogEntry const& _e) const;
+
+	AddressSet const& addresses() const { return m_addresses; }
+	std::array<h256Set, 4> const& topics() const { return m_topics; }
 
-	LogFilter address(Address _a) { m_addresses.insert(_a); return *this; }
-	LogFilter topic(unsigned _index, h256 const& _t) { if (_index < 4) m_topics[_index].insert(_t); return *this; }
+	LogFilter address(Address _a);
+	LogFilter topic(unsigned _index, h256 const& _t);
 	LogFilter withMax(unsigned _m) { m_max = _m; return *this; }
 	LogFilter withSkip(unsigned _m) { m_skip = _m; return *this; }
 	LogFilter withEarliest(int _e) { m_earliest = _e; return *this; }
@@ -70,12 +80,37 @@ public:
 private:
 	AddressSet m_addresses;
 	std::array<h256Set, 4> m_topics;
+	LogBlooms m_addressBlooms;				///< The bloom mask of each of m_addresses.
+	std::array<LogBlooms, 4> m_topicBlooms;	///< The bloom mask of each of m_topics.
 	int m_earliest = 0;
 	int m_latest = -1;
 	unsigned m_max = 10;
 	unsigned m_skip = 0;
 };
 
+/**
+ * @brief An inverted index of filters by the addresses and topics they seek.
+ * Given a log entry it yields the ids of just those filters that might match it, avoiding a scan
+ * of every filter. Filters seeking particular addresses are indexed by them; those that only seek
+ * particular topics are indexed by the topics of their first constrained position; the rest match
+ * everything and are always candidates.
+ */
+class LogFilterIndex
+{
+public:
+	void insert(h256 const& _id, LogFilter const& _f);
+	void erase(h256 const& _id, LogFilter const& _f);
+	void clear() { m_byAddress.clear(); m_byTopic.clear(); m_unindexed.clear(); }
+
+	/// Add to @a o_ids the ids of filters that might match @a _e.
+	void candidates(LogEntry const& _e, h256Set& o_ids) const;
+
+private:
+	std::map<Address, h256Set> m_byAddress;
+	std::map<h256, h256Set> m_byTopic;
+	h256Set m_unindexed;
+};
+
 }
 
 }
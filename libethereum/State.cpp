@@ -53,10 +53,8 @@ OverlayDB State::openDB(std::string _path, bool _killExisting)
 	if (_killExisting)
 		boost::filesystem::remove_all(_path + "/state");
 
-	ldb::Options o;
-	o.create_if_missing = true;
 	ldb::DB* db = nullptr;
-	ldb::DB::Open(o, _path + "/state", &db);
+	ldb::DB::Open(databaseOptions(Defaults::storageProfile(), Database::State), _path + "/state", &db);
 	if (!db)
 		BOOST_THROW_EXCEPTION(DatabaseAlreadyOpen());
 
@@ -113,7 +111,7 @@ State::State(OverlayDB const& _db, BlockChain const& _bc, h256 _h):
 	m_ourAddress = bi.coinbaseAddress;
 
 	sync(_bc, bi.parentHash, bip);
-	enact(&b, _bc);
+	enact(BlockChain::verifyBlock(&b), _bc);
 }
 
 State::State(State const& _s):
@@ -318,7 +316,7 @@ bool State::sync(BlockChain const& _bc, h256 _block, BlockInfo const& _bi)
 			for (auto it = chain.rbegin(); it != chain.rend(); ++it)
 			{
 				auto b = _bc.block(*it);
-				enact(&b, _bc);
+				enact(BlockChain::verifyBlock(&b), _bc);
 				cleanup(true);
 			}
 		}
@@ -336,15 +334,15 @@ bool State::sync(BlockChain const& _bc, h256 _block, BlockInfo const& _bi)
 	return ret;
 }
 
-u256 State::enactOn(bytesConstRef _block, BlockInfo const& _bi, BlockChain const& _bc)
+u256 State::enactOn(VerifiedBlock const& _block, BlockChain const& _bc)
 {
 	// Check family:
-	BlockInfo biParent(_bc.block(_bi.parentHash));
-	_bi.verifyParent(biParent);
+	BlockInfo biParent(_bc.block(_block.info.parentHash));
+	_block.info.verifyParent(biParent);
 	BlockInfo biGrandParent;
 	if (biParent.number)
 		biGrandParent.populate(_bc.block(biParent.parentHash));
-	sync(_bc, _bi.parentHash);
+	sync(_bc, _block.info.parentHash);
 	resetCurrent();
 	m_previousBlock = biParent;
 	return enact(_block, _bc);
@@ -387,27 +385,13 @@ void State::resetCurrent()
 bool State::cull(TransactionQueue& _tq) const
 {
 	bool ret = false;
-	auto ts = _tq.transactions();
-	for (auto const& i: ts)
-	{
-		if (!m_transactionSet.count(i.first))
+	// The queue has already checked the signatures, so it can tell us each sender and nonce.
+	for (auto const& i: _tq.topTransactions())
+		if (!m_transactionSet.count(i.first) && i.second.nonce < transactionsFrom(i.second.sender))
 		{
-			try
-			{
-				Transaction t(i.second, CheckSignature::Sender);
-				if (t.nonce() <= transactionsFrom(t.sender()))
-				{
-					_tq.drop(i.first);
-					ret = true;
-				}
-			}
-			catch (...)
-			{
-				_tq.drop(i.first);
-				ret = true;
-			}
+			_tq.drop(i.first);
+			ret = true;
 		}
-	}
 	return ret;
 }
 
@@ -415,84 +399,78 @@ TransactionReceipts State::sync(BlockChain const& _bc, TransactionQueue& _tq, bo
 {
 	// TRANSACTIONS
 	TransactionReceipts ret;
-	auto ts = _tq.transactions();
+	auto ts = _tq.topTransactions();
 
 	auto lh = getLastHashes(_bc, _bc.number());
 
-	for (int goodTxs = 1; goodTxs;)
-	{
-		goodTxs = 0;
-		for (auto const& i: ts)
-			if (!m_transactionSet.count(i.first))
+	// The queue gives us each sender's transactions in nonce order, so a single pass suffices. Once a
+	// sender's transaction is found to be from the future, the rest of theirs must wait too.
+	set<Address> stalled;
+	for (auto const& i: ts)
+		if (!m_transactionSet.count(i.first) && !stalled.count(i.second.sender))
+		{
+			// don't have it yet! Execute it now.
+			try
 			{
-				// don't have it yet! Execute it now.
-				try
-				{
-					uncommitToMine();
-//					boost::timer t;
-					execute(lh, i.second);
-					ret.push_back(m_receipts.back());
-					_tq.noteGood(i);
-					++goodTxs;
-//					cnote << "TX took:" << t.elapsed() * 1000;
-				}
-				catch (InvalidNonce const& in)
-				{
-					if (in.required > in.candidate)
-					{
-						// too old
-						_tq.drop(i.first);
-						if (o_transactionQueueChanged)
-							*o_transactionQueueChanged = true;
-					}
-					else
-						_tq.setFuture(i);
-				}
-				catch (Exception const& _e)
-				{
-					// Something else went wrong - drop it.
-					_tq.drop(i.first);
-					if (o_transactionQueueChanged)
-						*o_transactionQueueChanged = true;
-					cwarn << "Sync went wrong\n" << diagnostic_information(_e);
-				}
-				catch (std::exception const&)
+				uncommitToMine();
+//				boost::timer t;
+				execute(lh, i.second.rlp);
+				ret.push_back(m_receipts.back());
+//				cnote << "TX took:" << t.elapsed() * 1000;
+			}
+			catch (InvalidNonce const& in)
+			{
+				if (in.required > in.candidate)
 				{
-					// Something else went wrong - drop it.
+					// too old
 					_tq.drop(i.first);
 					if (o_transactionQueueChanged)
 						*o_transactionQueueChanged = true;
 				}
+				else
+					stalled.insert(i.second.sender);
 			}
-	}
+			catch (Exception const& _e)
+			{
+				// Something else went wrong - drop it.
+				_tq.drop(i.first);
+				if (o_transactionQueueChanged)
+					*o_transactionQueueChanged = true;
+				cwarn << "Sync went wrong\n" << diagnostic_information(_e);
+				stalled.insert(i.second.sender);
+			}
+			catch (std::exception const&)
+			{
+				// Something else went wrong - drop it.
+				_tq.drop(i.first);
+				if (o_transactionQueueChanged)
+					*o_transactionQueueChanged = true;
+				stalled.insert(i.second.sender);
+			}
+		}
 	return ret;
 }
 
-u256 State::enact(bytesConstRef _block, BlockChain const& _bc, bool _checkNonce)
+u256 State::enact(VerifiedBlock const& _block, BlockChain const& _bc)
 {
 	// m_currentBlock is assumed to be prepopulated and reset.
 
 #if !ETH_RELEASE
-	BlockInfo bi(_block, _checkNonce);
-	assert(m_previousBlock.hash == bi.parentHash);
-	assert(m_currentBlock.parentHash == bi.parentHash);
+	assert(m_previousBlock.hash == _block.info.parentHash);
+	assert(m_currentBlock.parentHash == _block.info.parentHash);
 	assert(rootHash() == m_previousBlock.stateRoot);
 #endif
 
 	if (m_currentBlock.parentHash != m_previousBlock.hash)
 		BOOST_THROW_EXCEPTION(InvalidParentHash());
 
-	// Populate m_currentBlock with the correct values.
-	m_currentBlock.populate(_block, _checkNonce);
-	m_currentBlock.verifyInternals(_block);
+	// Populate m_currentBlock with the correct values; the block's internals (including its transactions root)
+	// were checked when it was verified.
+	m_currentBlock = _block.info;
 
 //	cnote << "playback begins:" << m_state.root();
 //	cnote << m_state;
 
-	MemoryDB tm;
-	GenericTrieDB<MemoryDB> transactionsTrie(&tm);
-	transactionsTrie.init();
-
 	MemoryDB rm;
 	GenericTrieDB<MemoryDB> receiptsTrie(&rm);
 	receiptsTrie.init();
@@ -501,13 +479,12 @@ u256 State::enact(bytesConstRef _block, BlockChain const& _bc, bool _checkNonce)
 
 	// All ok with the block generally. Play back the transactions now...
 	unsigned i = 0;
-	for (auto const& tr: RLP(_block)[1])
+	for (Transaction const& tr: _block.transactions)
 	{
 		RLPStream k;
 		k << i;
 
-		transactionsTrie.insert(&k.out(), tr.data());
-		execute(lh, tr.data());
+		execute(lh, tr);
 
 		RLPStream receiptrlp;
 		m_receipts.back().streamRLP(receiptrlp);
@@ -515,17 +492,11 @@ u256 State::enact(bytesConstRef _block, BlockChain const& _bc, bool _checkNonce)
 		++i;
 	}
 
-	if (transactionsTrie.root() != m_currentBlock.transactionsRoot)
-	{
-		cwarn << "Bad transactions state root!";
-		BOOST_THROW_EXCEPTION(InvalidTransactionsStateRoot());
-	}
-
 	if (receiptsTrie.root() != m_currentBlock.receiptsRoot)
 	{
 		cwarn << "Bad receipts state root.";
-		cwarn << "Block:" << toHex(_block);
-		cwarn << "Block RLP:" << RLP(_block);
+		cwarn << "Block:" << toHex(_block.block);
+		cwarn << "Block RLP:" << RLP(_block.block);
 		cwarn << "Calculated: " << receiptsTrie.root();
 		for (unsigned j = 0; j < i; ++j)
 		{
@@ -563,7 +534,7 @@ u256 State::enact(bytesConstRef _block, BlockChain const& _bc, bool _checkNonce)
 	set<h256> nonces = { m_currentBlock.nonce };
 	Addresses rewarded;
 	set<h256> knownUncles = _bc.allUnclesFrom(m_currentBlock.parentHash);
-	for (auto const& i: RLP(_block)[2])
+	for (auto const& i: RLP(_block.block)[2])
 	{
 		if (knownUncles.count(sha3(i.data())))
 			BOOST_THROW_EXCEPTION(UncleInChain(knownUncles, sha3(i.data()) ));
@@ -664,7 +635,7 @@ bool State::amIJustParanoid(BlockChain const& _bc)
 		cnote << "PARANOIA root:" << s.rootHash();
 //		s.m_currentBlock.populate(&block.out(), false);
 //		s.m_currentBlock.verifyInternals(&block.out());
-		s.enact(&block.out(), _bc, false);	// don't check nonce for this since we haven't mined it yet.
+		s.enact(BlockChain::verifyBlock(&block.out(), false), _bc);	// don't check nonce for this since we haven't mined it yet.
 		s.cleanup(false);
 		return true;
 	}
@@ -1028,15 +999,9 @@ bool State::isTrieGood(bool _enforceRefs, bool _requireNoLeftOvers) const
 
 LastHashes State::getLastHashes(BlockChain const& _bc, unsigned _n) const
 {
-	LastHashes ret;
-	ret.resize(256);
 	if (c_protocolVersion > 49)
-	{
-		ret[0] = _bc.numberHash(_n);
-		for (unsigned i = 1; i < 256; ++i)
-			ret[i] = ret[i - 1] ? _bc.details(ret[i - 1]).parent : h256();
-	}
-	return ret;
+		return *_bc.lastHashes(_n);
+	return LastHashes(256);
 }
 
 u256 State::execute(BlockChain const& _bc, bytes const& _rlp, bytes* o_output, bool _commit)
@@ -1049,8 +1014,13 @@ u256 State::execute(BlockChain const& _bc, bytesConstRef _rlp, bytes* o_output,
 	return execute(getLastHashes(_bc, _bc.number()), _rlp, o_output, _commit);
 }
 
-// TODO: maintain node overlay revisions for stateroots -> each commit gives a stateroot + OverlayDB; allow overlay copying for rewind operations.
 u256 State::execute(LastHashes const& _lh, bytesConstRef _rlp, bytes* o_output, bool _commit)
+{
+	return execute(_lh, Transaction(_rlp, CheckSignature::Sender), o_output, _commit);
+}
+
+// TODO: maintain node overlay revisions for stateroots -> each commit gives a stateroot + OverlayDB; allow overlay copying for rewind operations.
+u256 State::execute(LastHashes const& _lh, Transaction const& _t, bytes* o_output, bool _commit)
 {
 #ifndef ETH_RELEASE
 	commit();	// get an updated hash
@@ -1064,7 +1034,7 @@ u256 State::execute(LastHashes const& _lh, bytesConstRef _rlp, bytes* o_output,
 #endif
 
 	Executive e(*this, _lh, 0);
-	e.setup(_rlp);
+	e.setup(_t);
 
 	u256 startGasUsed = gasUsed();
 
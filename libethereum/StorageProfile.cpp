@@ -0,0 +1,140 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file StorageProfile.cpp
+ * @date 2015
+ */
+
+#include "StorageProfile.h"
+
+#include <map>
+#include <memory>
+#include <leveldb/cache.h>
+#include <leveldb/filter_policy.h>
+#include <libdevcore/Guards.h>
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+
+static const size_t c_MB = 1024 * 1024;
+
+DatabaseTuning dev::eth::databaseTuning(StorageProfile _p, Database _d)
+{
+	// Trie nodes in the state DB are looked up at random, so it gets the lion's share of the cache.
+	switch (_p)
+	{
+	case StorageProfile::Archive:
+		switch (_d)
+		{
+		case Database::Blocks: return DatabaseTuning{64 * c_MB, 10, 16 * c_MB, 512, true};
+		case Database::Details: return DatabaseTuning{32 * c_MB, 10, 8 * c_MB, 256, true};
+		case Database::State: return DatabaseTuning{256 * c_MB, 10, 32 * c_MB, 1024, true};
+		}
+		break;
+	case StorageProfile::Full:
+		switch (_d)
+		{
+		case Database::Blocks: return DatabaseTuning{16 * c_MB, 10, 8 * c_MB, 256, true};
+		case Database::Details: return DatabaseTuning{16 * c_MB, 10, 4 * c_MB, 256, true};
+		case Database::State: return DatabaseTuning{64 * c_MB, 10, 16 * c_MB, 512, true};
+		}
+		break;
+	case StorageProfile::Light:
+		switch (_d)
+		{
+		case Database::Blocks: return DatabaseTuning{4 * c_MB, 10, 2 * c_MB, 64, true};
+		case Database::Details: return DatabaseTuning{4 * c_MB, 10, 2 * c_MB, 64, true};
+		case Database::State: return DatabaseTuning{16 * c_MB, 10, 4 * c_MB, 128, true};
+		}
+		break;
+	}
+	return DatabaseTuning{8 * c_MB, 0, 4 * c_MB, 1000, true};
+}
+
+size_t dev::eth::chainCacheBudget(StorageProfile _p)
+{
+	switch (_p)
+	{
+	case StorageProfile::Archive: return 256 * c_MB;
+	case StorageProfile::Full: return 64 * c_MB;
+	case StorageProfile::Light: return 16 * c_MB;
+	}
+	return 64 * c_MB;
+}
+
+ldb::Options dev::eth::databaseOptions(StorageProfile _p, Database _d)
+{
+	// LevelDB doesn't take ownership of these, and they must outlive any DB using them.
+	static Mutex s_x;
+	static map<pair<StorageProfile, Database>, unique_ptr<ldb::Cache>> s_caches;
+	static map<int, unique_ptr<ldb::FilterPolicy const>> s_filters;
+
+	DatabaseTuning t = databaseTuning(_p, _d);
+	ldb::Options ret;
+	ret.create_if_missing = true;
+	ret.write_buffer_size = t.writeBuffer;
+	ret.max_open_files = t.maxOpenFiles;
+	ret.compression = t.compress ? ldb::kSnappyCompression : ldb::kNoCompression;
+
+	Guard l(s_x);
+	auto& c = s_caches[make_pair(_p, _d)];
+	if (!c)
+		c.reset(ldb::NewLRUCache(t.blockCache));
+	ret.block_cache = c.get();
+	if (t.bloomBitsPerKey)
+	{
+		auto& f = s_filters[t.bloomBitsPerKey];
+		if (!f)
+			f.reset(ldb::NewBloomFilterPolicy(t.bloomBitsPerKey));
+		ret.filter_policy = f.get();
+	}
+	return ret;
+}
+
+string dev::eth::databaseStats(ldb::DB* _db)
+{
+	if (!_db)
+		return string();
+	string ret;
+	string s;
+	if (_db->GetProperty("leveldb.stats", &s))
+		ret += s;
+	if (_db->GetProperty("leveldb.approximate-memory-usage", &s))
+		ret += "Approximate memory usage: " + s + " bytes\n";
+	return ret;
+}
+
+StorageProfile dev::eth::storageProfileFromString(string const& _s)
+{
+	if (_s == "archive")
+		return StorageProfile::Archive;
+	if (_s == "full")
+		return StorageProfile::Full;
+	if (_s == "light")
+		return StorageProfile::Light;
+	BOOST_THROW_EXCEPTION(UnknownStorageProfile() << errinfo_comment(_s));
+}
+
+string dev::eth::toString(StorageProfile _p)
+{
+	switch (_p)
+	{
+	case StorageProfile::Archive: return "archive";
+	case StorageProfile::Full: return "full";
+	case StorageProfile::Light: return "light";
+	}
+	return "?";
+}
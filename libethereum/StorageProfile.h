@@ -0,0 +1,86 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file StorageProfile.h
+ * @date 2015
+ */
+
+#pragma once
+
+#pragma warning(push)
+#pragma warning(disable: 4100 4267)
+#include <leveldb/db.h>
+#pragma warning(pop)
+
+#include <string>
+#include <libdevcore/Exceptions.h>
+namespace ldb = leveldb;
+
+namespace dev
+{
+namespace eth
+{
+
+struct UnknownStorageProfile: virtual Exception {};
+
+/// How much memory and how many file handles the node's databases may use.
+/// Archive suits a node serving historical queries, Full a regular node and Light a constrained machine.
+enum class StorageProfile
+{
+	Archive,
+	Full,
+	Light
+};
+
+/// The on-disk databases.
+enum class Database
+{
+	Blocks,
+	Details,
+	State
+};
+
+/// LevelDB tuning for one database under a given profile.
+struct DatabaseTuning
+{
+	size_t blockCache;			///< Bytes of uncompressed table blocks LevelDB keeps in memory.
+	int bloomBitsPerKey;		///< Bits per key of the on-disk bloom filters; 0 for none.
+	size_t writeBuffer;			///< Bytes written to the memtable before it's flushed to disk.
+	int maxOpenFiles;			///< Table files LevelDB may keep open.
+	bool compress;				///< Whether to compress table blocks.
+};
+
+/// @returns the LevelDB tuning of database @a _d under profile @a _p.
+DatabaseTuning databaseTuning(StorageProfile _p, Database _d);
+
+/// @returns the total budget of BlockChain's in-memory caches under profile @a _p.
+size_t chainCacheBudget(StorageProfile _p);
+
+/// @returns options for opening database @a _d under profile @a _p, creating it if missing.
+/// The block cache and filter policy are shared between opens and live for the rest of the process.
+ldb::Options databaseOptions(StorageProfile _p, Database _d);
+
+/// @returns LevelDB's own description of @a _db's levels, compactions and memory use.
+std::string databaseStats(ldb::DB* _db);
+
+/// @returns the profile called @a _s.
+/// @throws UnknownStorageProfile if there's no such profile.
+StorageProfile storageProfileFromString(std::string const& _s);
+
+std::string toString(StorageProfile _p);
+
+}
+}
@@ -21,6 +21,7 @@
 
 #include "TransactionQueue.h"
 
+#include <queue>
 #include <libdevcore/Log.h>
 #include <libethcore/Exceptions.h>
 #include "Transaction.h"
@@ -28,13 +29,67 @@ using namespace std;
 using namespace dev;
 using namespace dev::eth;
 
+TransactionQueue::TransactionQueue()
+{
+	m_verifier = thread([=](){
+		setThreadName("txverifier");
+		this->verifierBody();
+	});
+}
+
+TransactionQueue::~TransactionQueue()
+{
+	{
+		WriteGuard l(m_lock);
+		m_deleting = true;
+	}
+	m_moreToVerify.notify_all();
+	m_verifier.join();
+}
+
+bool TransactionQueue::enqueue(bytesConstRef _transactionRLP)
+{
+	h256 h = sha3(_transactionRLP);
+
+	WriteGuard l(m_lock);
+	if (m_current.count(h) || m_unverifiedSet.count(h) || m_unverified.size() >= c_maxUnverifiedTransactions)
+		return false;
+
+	m_unverified.push_back(_transactionRLP.toBytes());
+	m_unverifiedSet.insert(h);
+	m_moreToVerify.notify_one();
+	return true;
+}
+
+void TransactionQueue::verifierBody()
+{
+	while (true)
+	{
+		bytes work;
+		{
+			WriteGuard l(m_lock);
+			m_moreToVerify.wait(l, [&](){ return !m_unverified.empty() || m_deleting; });
+			if (m_deleting)
+				return;
+			swap(work, m_unverified.front());
+			m_unverified.pop_front();
+		}
+
+		// import() takes the lock itself and deals with any invalid transactions.
+		import(&work);
+
+		WriteGuard l(m_lock);
+		m_unverifiedSet.erase(sha3(work));
+	}
+}
+
 bool TransactionQueue::import(bytesConstRef _transactionRLP)
 {
 	// Check if we already know this transaction.
 	h256 h = sha3(_transactionRLP);
 
 	UpgradableGuard l(m_lock);
-	if (m_known.count(h))
+	if (m_current.count(h))
 		return false;
 
 	try
@@ -46,8 +101,14 @@ bool TransactionQueue::import(bytesConstRef _transactionRLP)
 
 		UpgradeGuard ul(l);
 		// If valid, append to blocks.
-		m_current[h] = _transactionRLP.toBytes();
-		m_known.insert(h);
+		if (!insertWithoutLock(h, QueuedTransaction{_transactionRLP.toBytes(), t.sender(), t.nonce(), t.gasPrice()}))
+			return false;
+		m_new.push_back(h);
+		if (m_new.size() > c_maxNewTransactions)
+		{
+			m_new.pop_front();
+			++m_newForgotten;
+		}
 	}
 	catch (Exception const& _e)
 	{
@@ -63,44 +124,139 @@ bool TransactionQueue::import(bytesConstRef _transactionRLP)
 	return true;
 }
 
-void TransactionQueue::setFuture(std::pair<h256, bytes> const& _t)
+bool TransactionQueue::insertWithoutLock(h256 const& _h, QueuedTransaction&& _t)
 {
-	WriteGuard l(m_lock);
-	if (m_current.count(_t.first))
+	// A second transaction from the same sender with the same nonce must outbid the first.
+	auto s = m_bySender.find(_t.sender);
+	if (s != m_bySender.end())
 	{
-		m_current.erase(_t.first);
-		m_unknown.insert(make_pair(Transaction(_t.second, CheckSignature::Sender).sender(), _t));
+		auto r = s->second.find(_t.nonce);
+		if (r != s->second.end())
+		{
+			if (m_current.at(r->second).gasPrice >= _t.gasPrice)
+				return false;
+			removeWithoutLock(r->second);
+		}
 	}
+
+	// Make room by evicting the cheapest, so long as they're cheaper than what we're adding. The evictee's
+	// sender's later transactions could never be mined without it, so they go too, from the highest nonce down.
+	while (!m_byPrice.empty() && (m_current.size() >= c_maxQueuedTransactions || m_currentBytes + _t.rlp.size() > c_maxQueuedTransactionBytes))
+	{
+		auto cheapest = m_byPrice.begin();
+		if (cheapest->first >= _t.gasPrice)
+			return false;
+		QueuedTransaction const& c = m_current.at(cheapest->second);
+		if (c.sender == _t.sender && c.nonce < _t.nonce)
+			// Evicting it would strand what we're adding.
+			return false;
+		u256 nonce = c.nonce;
+		auto& q = m_bySender.at(c.sender);
+		while (true)
+		{
+			auto last = prev(q.end());
+			bool done = last->first == nonce;
+			removeWithoutLock(last->second);
+			if (done)
+				break;
+		}
+	}
+
+	m_bySender[_t.sender][_t.nonce] = _h;
+	m_byPrice.insert(make_pair(_t.gasPrice, _h));
+	m_currentBytes += _t.rlp.size();
+	m_current[_h] = move(_t);
+	return true;
 }
 
-void TransactionQueue::noteGood(std::pair<h256, bytes> const& _t)
+void TransactionQueue::removeWithoutLock(h256 _h)
 {
-	WriteGuard l(m_lock);
-	auto r = m_unknown.equal_range(Transaction(_t.second, CheckSignature::Sender).sender());
-	for (auto it = r.first; it != r.second; ++it)
-		m_current.insert(it->second);
-	m_unknown.erase(r.first, r.second);
+	auto it = m_current.find(_h);
+	if (it == m_current.end())
+		return;
+	QueuedTransaction const& t = it->second;
+
+	auto s = m_bySender.find(t.sender);
+	if (s != m_bySender.end())
+	{
+		s->second.erase(t.nonce);
+		if (s->second.empty())
+			m_bySender.erase(s);
+	}
+	m_byPrice.erase(make_pair(t.gasPrice, _h));
+	m_currentBytes -= t.rlp.size();
+	m_current.erase(it);
 }
 
-void TransactionQueue::drop(h256 _txHash)
+std::map<h256, bytes> TransactionQueue::transactions() const
 {
-	UpgradableGuard l(m_lock);
+	std::map<h256, bytes> ret;
+	ReadGuard l(m_lock);
+	for (auto const& i: m_current)
+		ret.insert(make_pair(i.first, i.second.rlp));
+	return ret;
+}
 
-	if (!m_known.count(_txHash))
-		return;
+QueuedTransactions TransactionQueue::topTransactions() const
+{
+	QueuedTransactions ret;
+	ReadGuard l(m_lock);
+	ret.reserve(m_current.size());
 
-	UpgradeGuard ul(l);
-	m_known.erase(_txHash);
+	// Merge the senders' nonce-ordered queues, always taking whichever head pays the most.
+	using Head = pair<u256, pair<map<u256, h256>::const_iterator, map<u256, h256>::const_iterator>>;
+	auto cheaper = [](Head const& _a, Head const& _b) { return _a.first < _b.first; };
+	priority_queue<Head, vector<Head>, decltype(cheaper)> heads(cheaper);
+	for (auto const& s: m_bySender)
+		heads.push(make_pair(m_current.at(s.second.begin()->second).gasPrice, make_pair(s.second.begin(), s.second.end())));
 
-	if (m_current.count(_txHash))
-		m_current.erase(_txHash);
-	else
+	while (!heads.empty())
 	{
-		for (auto i = m_unknown.begin(); i != m_unknown.end(); ++i)
-			if (i->second.first == _txHash)
-			{
-				m_unknown.erase(i);
-				break;
-			}
+		auto next = heads.top();
+		heads.pop();
+		auto const& t = *m_current.find(next.second.first->second);
+		ret.push_back(t);
+		if (++next.second.first != next.second.second)
+		{
+			next.first = m_current.at(next.second.first->second).gasPrice;
+			heads.push(next);
+		}
 	}
+	return ret;
+}
+
+void TransactionQueue::drainNew(std::vector<std::pair<h256, bytes>>& o_out)
+{
+	WriteGuard l(m_lock);
+	for (auto const& h: m_new)
+	{
+		auto it = m_current.find(h);
+		if (it != m_current.end())
+			o_out.push_back(make_pair(h, it->second.rlp));
+	}
+	m_new.clear();
+	if (m_newForgotten)
+	{
+		cnote << "Too many new transactions since last drained;" << m_newForgotten << "will not be gossiped.";
+		m_newForgotten = 0;
+	}
+}
+
+void TransactionQueue::drop(h256 _txHash)
+{
+	WriteGuard l(m_lock);
+	removeWithoutLock(_txHash);
+}
+
+void TransactionQueue::clear()
+{
+	WriteGuard l(m_lock);
+	m_current.clear();
+	m_bySender.clear();
+	m_byPrice.clear();
+	m_currentBytes = 0;
+	m_unverified.clear();
+	m_unverifiedSet.clear();
+	m_new.clear();
+	m_newForgotten = 0;
 }
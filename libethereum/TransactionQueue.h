@@ -21,10 +21,14 @@
 
 #pragma once
 
+#include <condition_variable>
+#include <deque>
+#include <thread>
 #include <boost/thread.hpp>
 #include <libdevcore/Common.h>
 #include "libethcore/CommonEth.h"
 #include <libdevcore/Guards.h>
+#include <libdevcore/FlatHash.h>
 
 namespace dev
 {
@@ -33,32 +37,85 @@ namespace eth
 
 class BlockChain;
 
+/// Maximum number of transactions awaiting signature verification; any more are dropped.
+static const unsigned c_maxUnverifiedTransactions = 4096;
+/// Maximum number of freshly imported transactions remembered for gossip between two drainNew() calls.
+/// Should more arrive, the oldest are forgotten and so never gossiped, though a peer asking for the whole
+/// pending set still gets them; drainNew() logs how many were forgotten.
+static const unsigned c_maxNewTransactions = 4096;
+/// Maximum number of verified transactions held; beyond this the cheapest are evicted.
+static const unsigned c_maxQueuedTransactions = 8192;
+/// Maximum total size of the verified transactions held; beyond this the cheapest are evicted.
+static const size_t c_maxQueuedTransactionBytes = 16 * 1024 * 1024;
+
+/// A verified transaction in the queue, together with the details by which it's ordered.
+struct QueuedTransaction
+{
+	bytes rlp;
+	Address sender;
+	u256 nonce;
+	u256 gasPrice;
+};
+
+using QueuedTransactions = std::vector<std::pair<h256, QueuedTransaction>>;
+
 /**
  * @brief A queue of Transactions, each stored as RLP.
+ * Verified transactions are indexed by sender (in nonce order) and by gas price. The queue is bounded
+ * in both count and bytes; when full, the lowest-priced transaction is evicted to make room for a
+ * better-paying one. A transaction with the same sender and nonce as a queued one replaces it only if
+ * it offers a higher gas price.
  * @threadsafe
  */
 class TransactionQueue
 {
 public:
+	TransactionQueue();
+	~TransactionQueue();
+
+	/// Queue a transaction for import once its signature has been checked by the verifier thread.
+	/// @returns false if the transaction is already known or the verification backlog is full.
+	bool enqueue(bytesConstRef _tx);
+
 	bool attemptImport(bytesConstRef _tx) { try { import(_tx); return true; } catch (...) { return false; } }
 	bool attemptImport(bytes const& _tx) { return attemptImport(&_tx); }
 	bool import(bytesConstRef _tx);
 
 	void drop(h256 _txHash);
 
-	std::map<h256, bytes> transactions() const { ReadGuard l(m_lock); return m_current; }
-	std::pair<unsigned, unsigned> items() const { ReadGuard l(m_lock); return std::make_pair(m_current.size(), m_unknown.size()); }
+	std::map<h256, bytes> transactions() const;
+	/// @returns all queued transactions in the order they should be tried for a block: each sender's
+	/// transactions come in nonce order and, between senders, the one whose next transaction pays the
+	/// highest gas price goes first.
+	QueuedTransactions topTransactions() const;
+	/// Move the transactions imported since the last call (and still current) into o_out.
+	void drainNew(std::vector<std::pair<h256, bytes>>& o_out);
+	/// @returns the number of verified transactions and the number still awaiting verification.
+	std::pair<unsigned, unsigned> items() const { ReadGuard l(m_lock); return std::make_pair(m_current.size(), m_unverified.size()); }
 
-	void setFuture(std::pair<h256, bytes> const& _t);
-	void noteGood(std::pair<h256, bytes> const& _t);
-
-	void clear() { WriteGuard l(m_lock); m_known.clear(); m_current.clear(); m_unknown.clear(); }
+	void clear();
 
 private:
+	/// Body of the verifier thread.
+	void verifierBody();
+	/// Insert a verified transaction into the indices. Assumes the write lock is held.
+	/// @returns false if it was not wanted (an equally-priced replacement or too cheap for a full queue).
+	bool insertWithoutLock(h256 const& _h, QueuedTransaction&& _t);
+	/// Remove a queued transaction from the indices. Assumes the write lock is held.
+	void removeWithoutLock(h256 _h);
+
 	mutable boost::shared_mutex m_lock;							///< General lock.
-	std::set<h256> m_known;										///< Hashes of transactions in both sets.
-	std::map<h256, bytes> m_current;							///< Map of SHA3(tx) to tx.
-	std::multimap<Address, std::pair<h256, bytes>> m_unknown;	///< For transactions that have a future nonce; we map their sender address to the tx stuff, and insert once the sender has a valid TX.
+	std::condition_variable_any m_moreToVerify;					///< Signalled when m_unverified gains an item or we're shutting down.
+	std::deque<bytes> m_unverified;								///< Transactions awaiting signature verification.
+	FlatHashSet<h256> m_unverifiedSet;							///< Hashes of transactions in m_unverified.
+	std::thread m_verifier;										///< The verifier thread.
+	bool m_deleting = false;									///< Exit condition for the verifier.
+	FlatHashMap<h256, QueuedTransaction> m_current;				///< Map of SHA3(tx) to tx.
+	std::map<Address, std::map<u256, h256>> m_bySender;			///< For each sender, its queued transactions' hashes by nonce.
+	std::set<std::pair<u256, h256>> m_byPrice;					///< Queued transactions' gas prices and hashes, cheapest first.
+	size_t m_currentBytes = 0;									///< Total size of the RLP in m_current.
+	std::deque<h256> m_new;										///< Hashes of transactions imported since the last drainNew(), oldest first.
+	unsigned m_newForgotten = 0;								///< Number dropped from the front of m_new since the last drainNew().
 };
 
 }
@@ -0,0 +1,49 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file VerifiedBlock.h
+ * @date 2015
+ */
+
+#pragma once
+
+#include <vector>
+#include <libdevcore/Common.h>
+#include <libethcore/BlockInfo.h>
+#include "Transaction.h"
+
+namespace dev
+{
+namespace eth
+{
+
+/**
+ * @brief A block whose internals have been checked, together with everything that checking parsed out of it.
+ *
+ * Produced by BlockChain::verifyBlock() (usually on a BlockQueue verifier thread) so that import and enactment
+ * need not parse the header or the transactions, nor recover the senders, a second time.
+ */
+struct VerifiedBlock
+{
+	BlockInfo info;							///< The populated header; info.hash identifies the block.
+	std::vector<Transaction> transactions;	///< The transactions, in order, with their senders already recovered.
+	bytes block;							///< The block's RLP; empty if the block is yet to be verified.
+};
+
+using VerifiedBlocks = std::vector<VerifiedBlock>;
+
+}
+}
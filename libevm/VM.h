@@ -29,6 +29,7 @@
 #include <libethcore/BlockInfo.h>
 #include "FeeStructure.h"
 #include "VMFace.h"
+#include "VMMemory.h"
 
 namespace dev
 {
@@ -61,7 +62,7 @@ public:
 
 	u256 curPC() const { return m_curPC; }
 
-	bytes const& memory() const { return m_temp; }
+	bytesConstRef memory() const { return m_temp.ref(); }
 	u256s const& stack() const { return m_stack; }
 
 private:
@@ -71,7 +72,7 @@ private:
 	explicit VM(u256 _gas): VMFace(_gas) {}
 
 	u256 m_curPC = 0;
-	bytes m_temp;
+	VMMemory m_temp;
 	u256s m_stack;
 	std::set<u256> m_jumpDests;
 	std::function<void()> m_onFail;
@@ -0,0 +1,153 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file VMMemory.cpp
+ * @date 2015
+ */
+
+#include "VMMemory.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <vector>
+#include <boost/thread/tss.hpp>
+#if !defined(_WIN32)
+#include <sys/mman.h>
+#endif
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+
+namespace
+{
+
+/// Smallest capacity allocated; enough for the memory most contracts ever use.
+size_t const c_minCapacity = 1024;
+
+/// Buffers at least this big are mapped from the OS where possible.
+size_t const c_mapThreshold = 1024 * 1024;
+
+/// Number of buffers each thread keeps for reuse; buffers kept are smaller than c_mapThreshold.
+size_t const c_poolSize = 16;
+
+void release(VMMemory::Buffer const& _b)
+{
+#if !defined(_WIN32)
+	if (_b.mapped)
+	{
+		munmap(_b.data, _b.capacity);
+		return;
+	}
+#endif
+	free(_b.data);
+}
+
+/// Buffers left behind by the frames that finished on this thread.
+struct BufferPool
+{
+	~BufferPool() { for (auto const& b: buffers) release(b); }
+	vector<VMMemory::Buffer> buffers;
+};
+
+boost::thread_specific_ptr<BufferPool> t_pool;
+
+BufferPool& pool()
+{
+	if (!t_pool.get())
+		t_pool.reset(new BufferPool);
+	return *t_pool;
+}
+
+}
+
+VMMemory::~VMMemory()
+{
+	if (!m_buffer.data)
+		return;
+	if (!m_buffer.mapped && m_buffer.capacity < c_mapThreshold && pool().buffers.size() < c_poolSize)
+	{
+		m_buffer.dirty = max(m_buffer.dirty, m_size);
+		pool().buffers.push_back(m_buffer);
+	}
+	else
+		release(m_buffer);
+}
+
+void VMMemory::resize(size_t _size)
+{
+	if (_size > m_buffer.capacity)
+		reserve(max(_size, m_buffer.capacity * 2));
+	if (_size > m_size && m_size < m_buffer.dirty)
+		memset(m_buffer.data + m_size, 0, min(_size, m_buffer.dirty) - m_size);
+	m_buffer.dirty = max(m_buffer.dirty, _size);
+	m_size = _size;
+}
+
+void VMMemory::reserve(size_t _capacity)
+{
+	if (!m_buffer.data && !pool().buffers.empty())
+	{
+		// Take the most recently used buffer; it is the most likely to be in the cache.
+		m_buffer = pool().buffers.back();
+		pool().buffers.pop_back();
+		if (m_buffer.capacity >= _capacity)
+			return;
+	}
+
+	_capacity = max(_capacity, c_minCapacity);
+	Buffer b;
+#if !defined(_WIN32)
+	if (_capacity >= c_mapThreshold)
+	{
+		size_t const page = 4096;
+		_capacity = (_capacity + page - 1) / page * page;
+#if defined(__linux__)
+		if (m_buffer.mapped)
+		{
+			// The kernel moves the pages over; those added are zero.
+			void* p = mremap(m_buffer.data, m_buffer.capacity, _capacity, MREMAP_MAYMOVE);
+			if (p == MAP_FAILED)
+				throw bad_alloc();
+			m_buffer.data = (byte*)p;
+			m_buffer.capacity = _capacity;
+			return;
+		}
+#endif
+		void* p = mmap(nullptr, _capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (p == MAP_FAILED)
+			throw bad_alloc();
+		b.data = (byte*)p;
+		b.mapped = true;
+	}
+	else
+#endif
+	{
+		b.data = (byte*)calloc(_capacity, 1);
+		if (!b.data)
+			throw bad_alloc();
+	}
+	b.capacity = _capacity;
+
+	// Only the bytes in use are copied; everything after them in the new buffer is zero.
+	if (m_size)
+		memcpy(b.data, m_buffer.data, m_size);
+	b.dirty = m_size;
+	if (m_buffer.data)
+		release(m_buffer);
+	m_buffer = b;
+}
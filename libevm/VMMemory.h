@@ -0,0 +1,79 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file VMMemory.h
+ * @date 2015
+ */
+
+#pragma once
+
+#include <libdevcore/Common.h>
+
+namespace dev
+{
+namespace eth
+{
+
+/**
+ * @brief The memory of an EVM call frame: a zero-initialised byte array which only the VM resizes.
+ *
+ * Capacity grows geometrically, so memory expanded a word at a time is reallocated only a logarithmic number
+ * of times. Large buffers are mapped straight from the OS, whose pages arrive zeroed and which on Linux can grow
+ * without a copy. The buffer of a finished frame is kept in a small per-thread pool for the next frame to reuse.
+ */
+class VMMemory
+{
+public:
+	VMMemory() = default;
+	~VMMemory();
+
+	VMMemory(VMMemory const&) = delete;
+	VMMemory& operator=(VMMemory const&) = delete;
+
+	size_t size() const { return m_size; }
+	bool empty() const { return !m_size; }
+
+	byte* data() { return m_buffer.data; }
+	byte const* data() const { return m_buffer.data; }
+
+	byte& operator[](size_t _i) { return m_buffer.data[_i]; }
+	byte operator[](size_t _i) const { return m_buffer.data[_i]; }
+
+	bytesRef ref() { return bytesRef(m_buffer.data, m_size); }
+	bytesConstRef ref() const { return bytesConstRef(m_buffer.data, m_size); }
+
+	/// Resizes to @a _size bytes. Any bytes added are zero.
+	void resize(size_t _size);
+
+	/// A block of memory, possibly holding leftovers of a previous frame.
+	struct Buffer
+	{
+		byte* data = nullptr;
+		size_t capacity = 0;
+		size_t dirty = 0;		///< Bytes from here on up to the capacity are known to be zero.
+		bool mapped = false;	///< Mapped from the OS rather than taken from the heap.
+	};
+
+private:
+	/// Makes room for at least @a _capacity bytes, keeping the first size() bytes.
+	void reserve(size_t _capacity);
+
+	Buffer m_buffer;
+	size_t m_size = 0;
+};
+
+}
+}
@@ -21,6 +21,8 @@
 
 #include "Assembly.h"
 
+#include <unordered_map>
+#include <libdevcore/Guards.h>
 #include <libdevcore/Log.h>
 
 using namespace std;
@@ -237,6 +239,19 @@ AssemblyItem const& Assembly::append(AssemblyItem const& _i, SourceLocation cons
 	return back();
 }
 
+AssemblyItem Assembly::newSub(Assembly const& _sub)
+{
+	// Assemblies may be built on several threads at once; s_fixedHashEngine is not thread-safe.
+	static Mutex s_x;
+	h256 h;
+	{
+		Guard l(s_x);
+		h = h256::random(s_fixedHashEngine);
+	}
+	m_subs[h] = _sub;
+	return AssemblyItem(PushSub, h);
+}
+
 void Assembly::injectStart(AssemblyItem const& _i)
 {
 	m_items.insert(m_items.begin(), _i);
@@ -271,12 +286,51 @@ unsigned bytesRequiredBySlice(Iterator _begin, Iterator _end)
 }
 
 struct OptimiserChannel: public LogChannel { static const char* name() { return "OPT"; } static const int verbosity = 12; };
-#define copt dev::LogOutputStream<OptimiserChannel, true>()
+#define copt LOG_STREAM(OptimiserChannel, true)
 
-Assembly& Assembly::optimise(bool _enable)
+namespace
+{
+
+/// A peephole rule: a sequence of items (UndefinedItem matching anything) and the rewrite of a matching window.
+struct OptimiserRule
+{
+	std::string name;
+	AssemblyItems pattern;
+	function<AssemblyItems(AssemblyItemsConstRef)> action;
+};
+
+/**
+ * The peephole rules, built once and indexed by the type (and instruction, for operations) of the first item of
+ * their pattern, so only rules that can possibly match are tried at each position.
+ */
+class OptimiserRules
+{
+public:
+	static OptimiserRules const& get() { static const OptimiserRules s_rules; return s_rules; }
+
+	std::vector<OptimiserRule> const& rules() const { return m_rules; }
+	/// @returns the indices, in ascending order, of the rules whose pattern can start with @a _first.
+	std::vector<unsigned> const& candidates(AssemblyItem const& _first) const
+	{
+		auto it = m_index.find(key(_first));
+		return it != m_index.end() ? it->second : m_wildcard;
+	}
+	/// @returns the length of the longest pattern.
+	unsigned maxLength() const { return m_maxLength; }
+
+private:
+	OptimiserRules();
+
+	static unsigned key(AssemblyItem const& _i) { return unsigned(_i.type()) << 8 | (_i.type() == Operation ? unsigned(byte(_i.data())) : 0); }
+
+	std::vector<OptimiserRule> m_rules;
+	std::unordered_map<unsigned, std::vector<unsigned>> m_index;
+	std::vector<unsigned> m_wildcard;		///< Rules whose pattern starts with UndefinedItem.
+	unsigned m_maxLength = 0;
+};
+
+OptimiserRules::OptimiserRules()
 {
-	if (!_enable)
-		return *this;
 	auto signextend = [](u256 a, u256 b) -> u256
 	{
 		if (a >= 31)
@@ -310,33 +364,33 @@ Assembly& Assembly::optimise(bool _enable)
 	};
 	std::vector<pair<AssemblyItem, u256>> const c_identities =
 	{ { Instruction::ADD, 0}, { Instruction::MUL, 1}, { Instruction::MOD, 0}, { Instruction::OR, 0}, { Instruction::XOR, 0} };
-	std::vector<pair<AssemblyItems, function<AssemblyItems(AssemblyItemsConstRef)>>> rules =
+	m_rules =
 	{
-		{ { Push, Instruction::POP }, [](AssemblyItemsConstRef) -> AssemblyItems { return {}; } },
-		{ { PushTag, Instruction::POP }, [](AssemblyItemsConstRef) -> AssemblyItems { return {}; } },
-		{ { PushString, Instruction::POP }, [](AssemblyItemsConstRef) -> AssemblyItems { return {}; } },
-		{ { PushSub, Instruction::POP }, [](AssemblyItemsConstRef) -> AssemblyItems { return {}; } },
-		{ { PushSubSize, Instruction::POP }, [](AssemblyItemsConstRef) -> AssemblyItems { return {}; } },
-		{ { PushProgramSize, Instruction::POP }, [](AssemblyItemsConstRef) -> AssemblyItems { return {}; } },
-		{ { Push, PushTag, Instruction::JUMPI }, [](AssemblyItemsConstRef m) -> AssemblyItems { if (m[0].data()) return { m[1], Instruction::JUMP }; else return {}; } },
-		{ { Instruction::ISZERO, Instruction::ISZERO }, [](AssemblyItemsConstRef) -> AssemblyItems { return {}; } },
+		{ "push-pop", { Push, Instruction::POP }, [](AssemblyItemsConstRef) -> AssemblyItems { return {}; } },
+		{ "pushtag-pop", { PushTag, Instruction::POP }, [](AssemblyItemsConstRef) -> AssemblyItems { return {}; } },
+		{ "pushstring-pop", { PushString, Instruction::POP }, [](AssemblyItemsConstRef) -> AssemblyItems { return {}; } },
+		{ "pushsub-pop", { PushSub, Instruction::POP }, [](AssemblyItemsConstRef) -> AssemblyItems { return {}; } },
+		{ "pushsubsize-pop", { PushSubSize, Instruction::POP }, [](AssemblyItemsConstRef) -> AssemblyItems { return {}; } },
+		{ "pushprogramsize-pop", { PushProgramSize, Instruction::POP }, [](AssemblyItemsConstRef) -> AssemblyItems { return {}; } },
+		{ "constant-jumpi", { Push, PushTag, Instruction::JUMPI }, [](AssemblyItemsConstRef m) -> AssemblyItems { if (m[0].data()) return { m[1], Instruction::JUMP }; else return {}; } },
+		{ "double-iszero", { Instruction::ISZERO, Instruction::ISZERO }, [](AssemblyItemsConstRef) -> AssemblyItems { return {}; } },
 	};
 
 	for (auto const& i: c_simple)
-		rules.push_back({ { Push, Push, i.first }, [&](AssemblyItemsConstRef m) -> AssemblyItems { return { i.second(m[1].data(), m[0].data()) }; } });
+		m_rules.push_back({ string("fold-") + instructionInfo(i.first).name, { Push, Push, i.first }, [=](AssemblyItemsConstRef m) -> AssemblyItems { return { i.second(m[1].data(), m[0].data()) }; } });
 	for (auto const& i: c_associative)
 	{
-		rules.push_back({ { Push, Push, i.first }, [&](AssemblyItemsConstRef m) -> AssemblyItems { return { i.second(m[1].data(), m[0].data()) }; } });
-		rules.push_back({ { Push, i.first, Push, i.first }, [&](AssemblyItemsConstRef m) -> AssemblyItems { return { i.second(m[2].data(), m[0].data()), i.first }; } });
+		m_rules.push_back({ string("fold-") + instructionInfo(i.first).name, { Push, Push, i.first }, [=](AssemblyItemsConstRef m) -> AssemblyItems { return { i.second(m[1].data(), m[0].data()) }; } });
+		m_rules.push_back({ string("fold-associative-") + instructionInfo(i.first).name, { Push, i.first, Push, i.first }, [=](AssemblyItemsConstRef m) -> AssemblyItems { return { i.second(m[2].data(), m[0].data()), i.first }; } });
 	}
 	for (auto const& i: c_identities)
-		rules.push_back({{Push, i.first}, [&](AssemblyItemsConstRef m) -> AssemblyItems
+		m_rules.push_back({ string("identity-") + instructionInfo(Instruction(byte(i.first.data()))).name, {Push, i.first}, [=](AssemblyItemsConstRef m) -> AssemblyItems
 							{ return m[0].data() == i.second ? AssemblyItems() : m.toVector(); }});
 	// jump to next instruction
-	rules.push_back({ { PushTag, Instruction::JUMP, Tag }, [](AssemblyItemsConstRef m) -> AssemblyItems { if (m[0].m_data == m[2].m_data) return {m[2]}; else return m.toVector(); }});
+	m_rules.push_back({ "jump-to-next", { PushTag, Instruction::JUMP, Tag }, [](AssemblyItemsConstRef m) -> AssemblyItems { if (m[0].data() == m[2].data()) return {m[2]}; else return m.toVector(); }});
 
 	// pop optimization, do not compute values that are popped again anyway
-	rules.push_back({ { AssemblyItem(UndefinedItem), Instruction::POP }, [](AssemblyItemsConstRef m) -> AssemblyItems
+	m_rules.push_back({ "unused-value", { AssemblyItem(UndefinedItem), Instruction::POP }, [](AssemblyItemsConstRef m) -> AssemblyItems
 					  {
 						  if (m[0].type() != Operation)
 							return m.toVector();
@@ -370,7 +424,47 @@ Assembly& Assembly::optimise(bool _enable)
 		}
 		return m.toVector();
 	};
-	rules.push_back({{Push}, computeConstants});
+	m_rules.push_back({ "compute-constant", {Push}, computeConstants });
+
+	for (unsigned r = 0; r < m_rules.size(); ++r)
+	{
+		AssemblyItem const& first = m_rules[r].pattern.front();
+		if (first.type() == UndefinedItem)
+			m_wildcard.push_back(r);
+		else
+			m_index[key(first)].push_back(r);
+		m_maxLength = max<unsigned>(m_maxLength, m_rules[r].pattern.size());
+	}
+	// Rules starting with a wildcard are candidates everywhere; keep each list in rule order.
+	for (auto& i: m_index)
+	{
+		i.second.insert(i.second.end(), m_wildcard.begin(), m_wildcard.end());
+		sort(i.second.begin(), i.second.end());
+	}
+}
+
+}
+
+Assembly& Assembly::optimise(bool _enable)
+{
+	if (!_enable)
+		return *this;
+
+	OptimiserRules const& rules = OptimiserRules::get();
+	std::vector<unsigned> hits(rules.rules().size(), 0);
+	unsigned deadCode = 0;
+	unsigned unusedTags = 0;
+
+	// A rule's outcome depends only on the items it covers, so after the first pass only positions whose window
+	// (or, for a JUMP, the item after it) changed since they were last examined can match anything new.
+	// m_items[i] needs looking at iff dirty[i].
+	std::vector<char> dirty(m_items.size(), true);
+	unsigned const window = rules.maxLength() - 1;
+	auto markDirty = [&](unsigned _begin, unsigned _end)
+	{
+		for (unsigned j = _begin > window ? _begin - window : 0; j < min<size_t>(_end, dirty.size()); ++j)
+			dirty[j] = true;
+	};
 
 	copt << *this;
 
@@ -386,84 +480,119 @@ Assembly& Assembly::optimise(bool _enable)
 					++i;
 				continue;
 			}
-			for (auto const& r: rules)
+			if (!dirty[i])
+				continue;
+			dirty[i] = false;
+
+			// Try the candidate rules in order, looking them up again whenever a rewrite changes m_items[i].
+			for (unsigned next = 0; i < m_items.size();)
 			{
-				auto vr = AssemblyItemsConstRef(&m_items).cropped(i, r.first.size());
-				if (matches(vr, &r.first))
+				std::vector<unsigned> const& candidates = rules.candidates(m_items[i]);
+				auto it = lower_bound(candidates.begin(), candidates.end(), next);
+				if (it == candidates.end())
+					break;
+				next = *it + 1;
+				OptimiserRule const& r = rules.rules()[*it];
+				auto vr = AssemblyItemsConstRef(&m_items).cropped(i, r.pattern.size());
+				if (matches(vr, &r.pattern))
 				{
-					auto rw = r.second(vr);
+					auto rw = r.action(vr);
 					unsigned const vrSizeInBytes = bytesRequiredBySlice(vr.begin(), vr.end());
 					unsigned const rwSizeInBytes = bytesRequiredBySlice(rw.begin(), rw.end());
 					if (rwSizeInBytes < vrSizeInBytes || (rwSizeInBytes == vrSizeInBytes && popCountIncreased(vr, rw)))
 					{
-						copt << vr << "matches" << AssemblyItemsConstRef(&r.first) << "becomes...";
+						copt << vr << "matches" << AssemblyItemsConstRef(&r.pattern) << "becomes...";
 						copt << AssemblyItemsConstRef(&rw);
-						if (rw.size() > vr.size())
+						unsigned const vrSize = vr.size();
+						if (rw.size() > vrSize)
 						{
 							// create hole in the vector
-							unsigned sizeIncrease = rw.size() - vr.size();
+							unsigned sizeIncrease = rw.size() - vrSize;
 							m_items.resize(m_items.size() + sizeIncrease, AssemblyItem(UndefinedItem));
 							move_backward(m_items.begin() + i, m_items.end() - sizeIncrease, m_items.end());
+							dirty.insert(dirty.begin() + i, sizeIncrease, false);
 						}
 						else
-							m_items.erase(m_items.begin() + i + rw.size(), m_items.begin() + i + vr.size());
+						{
+							m_items.erase(m_items.begin() + i + rw.size(), m_items.begin() + i + vrSize);
+							dirty.erase(dirty.begin() + i + rw.size(), dirty.begin() + i + vrSize);
+						}
 
 						copy(rw.begin(), rw.end(), m_items.begin() + i);
+						markDirty(i, i + max<size_t>(rw.size(), 1));
 
 						count++;
+						hits[*it]++;
 						copt << "Now:\n" << m_items;
 					}
 				}
 			}
-			if (m_items[i].type() == Operation && m_items[i].data() == (byte)Instruction::JUMP)
+			if (i < m_items.size() && m_items[i].type() == Operation && m_items[i].data() == (byte)Instruction::JUMP)
 			{
-				bool o = false;
-				while (m_items.size() > i + 1 && m_items[i + 1].type() != Tag)
-				{
-					if (m_items[i + 1].type() == NoOptimizeBegin)
-						break;
-					m_items.erase(m_items.begin() + i + 1);
-					o = true;
-				}
-				if (o)
+				unsigned end = i + 1;
+				while (end < m_items.size() && m_items[end].type() != Tag && m_items[end].type() != NoOptimizeBegin)
+					++end;
+				if (end > i + 1)
 				{
+					m_items.erase(m_items.begin() + i + 1, m_items.begin() + end);
+					dirty.erase(dirty.begin() + i + 1, dirty.begin() + end);
 					copt << "Jump with no tag. Now:\n" << m_items;
+					markDirty(i + 1, i + 2);
 					++count;
+					++deadCode;
 				}
 			}
 		}
 
-		map<u256, unsigned> tags;
+		// Tags are numbered densely from zero, so plain vectors do for finding the first unused one.
+		std::vector<unsigned> tagPos(m_usedTags, unsigned(-1));
+		std::vector<char> unused(m_usedTags, false);
+		// A tag that isn't below m_usedTags isn't one of ours; it's never indexed and never taken as unused.
 		for (unsigned i = 0; i < m_items.size(); ++i)
-			if (m_items[i].type() == Tag)
-				tags.insert(make_pair(m_items[i].data(), i));
+			if (m_items[i].type() == Tag && m_items[i].data() < m_usedTags && tagPos[unsigned(m_items[i].data())] == unsigned(-1))
+			{
+				tagPos[unsigned(m_items[i].data())] = i;
+				unused[unsigned(m_items[i].data())] = true;
+			}
 
 		for (auto const& i: m_items)
-			if (i.type() == PushTag)
-				tags.erase(i.data());
+			if (i.type() == PushTag && i.data() < m_usedTags)
+				unused[unsigned(i.data())] = false;
 
-		if (!tags.empty())
+		auto t = find(unused.begin(), unused.end(), true);
+		if (t != unused.end())
 		{
-			auto t = *tags.begin();
-			unsigned i = t.second;
+			unsigned i = tagPos[t - unused.begin()];
+			auto isUnusedTag = [&](AssemblyItem const& _i) { return _i.type() == Tag && _i.data() < m_usedTags && unused[unsigned(_i.data())]; };
 			if (i && m_items[i - 1].type() == Operation && m_items[i - 1].data() == (byte)Instruction::JUMP)
-				while (i < m_items.size() && (m_items[i].type() != Tag || tags.count(m_items[i].data())))
-				{
-					if (m_items[i].type() == Tag && tags.count(m_items[i].data()))
-						tags.erase(m_items[i].data());
-					m_items.erase(m_items.begin() + i);
-				}
+			{
+				unsigned end = i;
+				for (; end < m_items.size() && (m_items[end].type() != Tag || isUnusedTag(m_items[end])); ++end)
+					if (isUnusedTag(m_items[end]))
+						unused[unsigned(m_items[end].data())] = false;
+				m_items.erase(m_items.begin() + i, m_items.begin() + end);
+				dirty.erase(dirty.begin() + i, dirty.begin() + end);
+			}
 			else
 			{
 				m_items.erase(m_items.begin() + i);
-				tags.erase(t.first);
+				dirty.erase(dirty.begin() + i);
 			}
+			markDirty(i, i + 1);
 			copt << "Unused tag. Now:\n" << m_items;
 			++count;
+			++unusedTags;
 		}
 	}
 
 	copt << total << " optimisations done.";
+	for (unsigned r = 0; r < hits.size(); ++r)
+		if (hits[r])
+			copt << "  " << rules.rules()[r].name << ": " << hits[r];
+	if (deadCode)
+		copt << "  dead-code: " << deadCode;
+	if (unusedTags)
+		copt << "  unused-tag: " << unusedTags;
 
 	for (auto& i: m_subs)
 	  i.second.optimise(true);
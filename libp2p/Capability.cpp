@@ -30,7 +30,7 @@ using namespace dev::p2p;
 #if defined(clogS)
 #undef clogS
 #endif
-#define clogS(X) dev::LogOutputStream<X, true>(false) << "| " << std::setw(2) << session()->socketId() << "] "
+#define clogS(X) LOG_SESSION_STREAM(X, session()->socketId())
 
 Capability::Capability(Session* _s, HostCapabilityFace* _h, unsigned _idOffset): m_session(_s), m_host(_h), m_idOffset(_idOffset)
 {
@@ -53,6 +53,14 @@ void Capability::sealAndSend(RLPStream& _s)
 	m_session->sealAndSend(_s);
 }
 
+void Capability::sealAndSend(unsigned _id, std::shared_ptr<bytes const> const& _args)
+{
+	bytes id = rlp(_id + m_idOffset);
+	RLPStream s;
+	Session::prep(s).appendListPrefix(id.size() + _args->size()).appendRaw(id);
+	m_session->sealAndSend(s, _args);
+}
+
 void Capability::send(bytesConstRef _msg)
 {
 	m_session->send(_msg);
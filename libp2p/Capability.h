@@ -52,6 +52,9 @@ protected:
 
 	RLPStream& prep(RLPStream& _s, unsigned _id, unsigned _args = 0);
 	void sealAndSend(RLPStream& _s);
+	/// Send packet @a _id whose (RLP-serialised) arguments are @a _args. Only the header is built for this session,
+	/// so the same @a _args may be sent to any number of sessions.
+	void sealAndSend(unsigned _id, std::shared_ptr<bytes const> const& _args);
 	void send(bytes&& _msg);
 	void send(bytesConstRef _msg);
 
@@ -51,7 +51,8 @@ Host::Host(std::string const& _clientVersion, NetworkPreferences const& _n, byte
 	m_clientVersion(_clientVersion),
 	m_netPrefs(_n),
 	m_ifAddresses(Network::getInterfaceAddresses()),
-	m_ioService(2),
+	m_ioService(max(m_netPrefs.ioThreads, 1u)),
+	m_strand(m_ioService),
 	m_tcp4Acceptor(m_ioService),
 	m_alias(networkAlias(_restoreNetwork)),
 	m_lastPing(chrono::steady_clock::time_point::min())
@@ -225,13 +226,13 @@ void Host::onNodeTableEvent(NodeId const& _n, NodeTableEventType const& _e)
 	}
 }
 
-void Host::seal(bytes& _b)
+void Host::seal(bytes& _b, size_t _payloadSize)
 {
 	_b[0] = 0x22;
 	_b[1] = 0x40;
 	_b[2] = 0x08;
 	_b[3] = 0x91;
-	uint32_t len = (uint32_t)_b.size() - 8;
+	uint32_t len = (uint32_t)(_b.size() + _payloadSize) - 8;
 	_b[4] = (len >> 24) & 0xff;
 	_b[5] = (len >> 16) & 0xff;
 	_b[6] = (len >> 8) & 0xff;
@@ -327,7 +328,7 @@ void Host::runAcceptor()
 		// processing socket events after socket is deallocated.
 		
 		bi::tcp::socket *s = new bi::tcp::socket(m_ioService);
-		m_tcp4Acceptor.async_accept(*s, [=](boost::system::error_code ec)
+		m_tcp4Acceptor.async_accept(*s, m_strand.wrap([=](boost::system::error_code ec)
 		{
 			// if no error code, doHandshake takes ownership
 			bool success = false;
@@ -363,7 +364,7 @@ void Host::runAcceptor()
 			
 			if (ec.value() < 1)
 				runAcceptor();
-		});
+		}));
 	}
 }
 
@@ -414,7 +415,7 @@ void Host::addNode(NodeId const& _node, std::string const& _addr, unsigned short
 	if (ec)
 	{
 		bi::tcp::resolver *r = new bi::tcp::resolver(m_ioService);
-		r->async_resolve({_addr, toString(_tcpPeerPort)}, [=](boost::system::error_code const& _ec, bi::tcp::resolver::iterator _epIt)
+		r->async_resolve({_addr, toString(_tcpPeerPort)}, m_strand.wrap([=](boost::system::error_code const& _ec, bi::tcp::resolver::iterator _epIt)
 		{
 			if (!_ec)
 			{
@@ -422,7 +423,7 @@ void Host::addNode(NodeId const& _node, std::string const& _addr, unsigned short
 				if (m_nodeTable) m_nodeTable->addNode(Node(_node, NodeIPEndpoint(bi::udp::endpoint(tcp.address(), _udpNodePort), tcp)));
 			}
 			delete r;
-		});
+		}));
 	}
 	else
 		if (m_nodeTable) m_nodeTable->addNode(Node(_node, NodeIPEndpoint(bi::udp::endpoint(addr, _udpNodePort), bi::tcp::endpoint(addr, _tcpPeerPort))));
@@ -460,7 +461,7 @@ void Host::connect(std::shared_ptr<Peer> const& _p)
 	
 	clog(NetConnect) << "Attempting connection to node" << _p->id.abridged() << "@" << _p->peerEndpoint() << "from" << id().abridged();
 	bi::tcp::socket* s = new bi::tcp::socket(m_ioService);
-	s->async_connect(_p->peerEndpoint(), [=](boost::system::error_code const& ec)
+	s->async_connect(_p->peerEndpoint(), m_strand.wrap([=](boost::system::error_code const& ec)
 	{
 		if (ec)
 		{
@@ -481,7 +482,7 @@ void Host::connect(std::shared_ptr<Peer> const& _p)
 		delete s;
 		Guard l(x_pendingNodeConns);
 		m_pendingPeerConns.erase(nptr);
-	});
+	}));
 }
 
 PeerSessionInfos Host::peerSessionInfo() const
@@ -550,7 +551,7 @@ void Host::run(boost::system::error_code const&)
 	
 	auto runcb = [this](boost::system::error_code const& error) { run(error); };
 	m_timer->expires_from_now(boost::posix_time::milliseconds(c_timerInterval));
-	m_timer->async_wait(runcb);
+	m_timer->async_wait(m_strand.wrap(runcb));
 }
 			
 void Host::startedWorking()
@@ -598,8 +599,20 @@ void Host::startedWorking()
 
 void Host::doWork()
 {
-	if (m_run)
-		m_ioService.run();
+	if (!m_run)
+		return;
+
+	// The worker thread is one of the io threads; the rest only live as long as this call.
+	vector<thread> ioThreads;
+	for (unsigned i = 1; i < m_netPrefs.ioThreads; ++i)
+		ioThreads.push_back(thread([=]()
+		{
+			setThreadName(("p2p" + toString(i)).c_str());
+			m_ioService.run();
+		}));
+	m_ioService.run();
+	for (auto& t: ioThreads)
+		t.join();
 }
 
 void Host::keepAlivePeers()
@@ -607,10 +620,11 @@ void Host::keepAlivePeers()
 	if (chrono::steady_clock::now() - c_keepAliveInterval < m_lastPing)
 		return;
 	
+	// Each session's own handlers may be running on another io thread; its state is only touched on its strand.
 	RecursiveGuard l(x_sessions);
 	for (auto p: m_sessions)
 		if (auto pp = p.second.lock())
-				pp->ping();
+			pp->post([pp]() { pp->ping(); });
 
 	m_lastPing = chrono::steady_clock::now();
 }
@@ -621,11 +635,16 @@ void Host::disconnectLatePeers()
 	if (now - c_keepAliveTimeOut < m_lastPing)
 		return;
 
+	auto lastPing = m_lastPing;
 	RecursiveGuard l(x_sessions);
 	for (auto p: m_sessions)
 		if (auto pp = p.second.lock())
-			if (now - c_keepAliveTimeOut > m_lastPing && pp->m_lastReceived < m_lastPing)
-				pp->disconnect(PingTimeout);
+			if (now - c_keepAliveTimeOut > lastPing)
+				pp->post([pp, lastPing]()
+				{
+					if (pp->m_lastReceived < lastPing)
+						pp->disconnect(PingTimeout);
+				});
 }
 
 bytes Host::saveNetwork() const
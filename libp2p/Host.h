@@ -174,7 +174,8 @@ private:
 	/// Handler for verifying handshake siganture before creating session. _nodeId is passed for outbound connections. If successful, socket is moved to Session via std::move.
 	void doHandshake(bi::tcp::socket* _socket, NodeId _nodeId = NodeId());
 	
-	void seal(bytes& _b);
+	/// Write the packet header into the first 8 bytes of @a _b; the packet is @a _b plus @a _payloadSize bytes sent after it.
+	void seal(bytes& _b, size_t _payloadSize = 0);
 
 	/// Called by Worker. Not thread-safe; to be called only by worker.
 	virtual void startedWorking();
@@ -205,6 +206,7 @@ private:
 	int m_listenPort = -1;												///< What port are we listening on. -1 means binding failed or acceptor hasn't been initialized.
 
 	ba::io_service m_ioService;											///< IOService for network stuff.
+	ba::io_service::strand m_strand;										///< Serialises the Host's own handlers (scheduler, acceptor, connects) when m_ioService is run by several threads.
 	bi::tcp::acceptor m_tcp4Acceptor;										///< Listening acceptor.
 	
 	std::unique_ptr<boost::asio::deadline_timer> m_timer;					///< Timer which, when network is running, calls scheduler() every c_timerInterval ms.
@@ -45,6 +45,7 @@ struct NetworkPreferences
 	std::string publicIP;
 	bool upnp = true;
 	bool localNetworking = false;
+	unsigned ioThreads = 1;		///< Number of threads servicing network I/O.
 };
 
 /**
@@ -192,12 +192,12 @@ void NodeTable::discover(NodeId _node, unsigned _round, shared_ptr<set<shared_pt
 	
 	auto self(shared_from_this());
 	m_evictionCheckTimer.expires_from_now(boost::posix_time::milliseconds(c_reqTimeout.count()));
-	m_evictionCheckTimer.async_wait([this, self, _node, _round, _tried](boost::system::error_code const& _ec)
+	m_evictionCheckTimer.async_wait(m_socketPointer->strand().wrap([this, self, _node, _round, _tried](boost::system::error_code const& _ec)
 	{
 		if (_ec)
 			return;
 		discover(_node, _round + 1, _tried);
-	});
+	}));
 }
 
 vector<shared_ptr<NodeEntry>> NodeTable::nearestNodeEntries(NodeId _target)
@@ -485,7 +485,7 @@ void NodeTable::doCheckEvictions(boost::system::error_code const& _ec)
 
 	auto self(shared_from_this());
 	m_evictionCheckTimer.expires_from_now(c_evictionCheckInterval);
-	m_evictionCheckTimer.async_wait([this, self](boost::system::error_code const& _ec)
+	m_evictionCheckTimer.async_wait(m_socketPointer->strand().wrap([this, self](boost::system::error_code const& _ec)
 	{
 		if (_ec)
 			return;
@@ -508,7 +508,7 @@ void NodeTable::doCheckEvictions(boost::system::error_code const& _ec)
 		
 		if (evictionsRemain)
 			doCheckEvictions(boost::system::error_code());
-	});
+	}));
 }
 
 void NodeTable::doRefreshBuckets(boost::system::error_code const& _ec)
@@ -543,6 +543,6 @@ void NodeTable::doRefreshBuckets(boost::system::error_code const& _ec)
 	unsigned nextRefresh = connected ? (refreshed ? 200 : c_bucketRefresh.count()*1000) : 10000;
 	auto runcb = [this](boost::system::error_code const& error) { doRefreshBuckets(error); };
 	m_bucketRefreshTimer.expires_from_now(boost::posix_time::milliseconds(nextRefresh));
-	m_bucketRefreshTimer.async_wait(runcb);
+	m_bucketRefreshTimer.async_wait(m_socketPointer->strand().wrap(runcb));
 }
 
@@ -34,12 +34,14 @@ using namespace dev::p2p;
 #if defined(clogS)
 #undef clogS
 #endif
-#define clogS(X) dev::LogOutputStream<X, true>(false) << "| " << std::setw(2) << m_socket.native_handle() << "] "
+#define clogS(X) LOG_SESSION_STREAM(X, m_socket.native_handle())
 
 Session::Session(Host* _s, bi::tcp::socket _socket, std::shared_ptr<Peer> const& _n):
 	m_server(_s),
 	m_socket(std::move(_socket)),
+	m_strand(_s->m_ioService),
 	m_peer(_n),
+	m_dropped(false),
 	m_info({NodeId(), "?", m_socket.remote_endpoint().address().to_string(), 0, chrono::steady_clock::duration(0), CapDescSet(), 0, map<string, string>()}),
 	m_ping(chrono::steady_clock::time_point::max())
 {
@@ -371,6 +373,15 @@ void Session::sealAndSend(RLPStream& _s)
 	send(move(b));
 }
 
+void Session::sealAndSend(RLPStream& _s, std::shared_ptr<bytes const> const& _payload)
+{
+	bytes b;
+	_s.swapOut(b);
+	m_server->seal(b, _payload->size());
+	clogS(NetLeft) << "[shared payload of" << _payload->size() << "bytes]";
+	queueWrite(move(b), _payload);
+}
+
 bool Session::checkPacket(bytesConstRef _msg)
 {
 	if (_msg.size() < 8)
@@ -398,25 +409,53 @@ void Session::send(bytes&& _msg)
 	if (!checkPacket(bytesConstRef(&_msg)))
 		clogS(NetWarn) << "INVALID PACKET CONSTRUCTED!";
 
+	queueWrite(move(_msg), nullptr);
+}
+
+void Session::queueWrite(bytes&& _header, std::shared_ptr<bytes const> const& _payload)
+{
 	if (!m_socket.is_open())
 		return;
 
 	bool doWrite = false;
 	{
 		Guard l(x_writeQueue);
-		m_writeQueue.push_back(_msg);
+		m_writeQueue.push_back(make_pair(move(_header), _payload));
 		doWrite = (m_writeQueue.size() == 1);
 	}
 
 	if (doWrite)
-		write();
+	{
+		// Start the write from our strand, since we may be being called from any thread.
+		auto self(shared_from_this());
+		m_strand.post([this, self](){ write(); });
+	}
+}
+
+void Session::post(std::function<void()> const& _f)
+{
+	auto self(shared_from_this());
+	m_strand.post([self, _f](){ _f(); });
 }
 
 void Session::write()
 {
-	const bytes& bytes = m_writeQueue[0];
+	// Gather everything queued so far into a single write. Queue elements aren't moved by later
+	// push_backs, so the buffers stay valid until we pop them.
+	vector<ba::const_buffer> buffers;
+	size_t count;
+	{
+		Guard l(x_writeQueue);
+		count = m_writeQueue.size();
+		for (auto const& i: m_writeQueue)
+		{
+			buffers.push_back(ba::buffer(i.first));
+			if (i.second)
+				buffers.push_back(ba::buffer(*i.second));
+		}
+	}
 	auto self(shared_from_this());
-	ba::async_write(m_socket, ba::buffer(bytes), [this, self](boost::system::error_code ec, std::size_t /*length*/)
+	ba::async_write(m_socket, buffers, m_strand.wrap([this, self, count](boost::system::error_code ec, std::size_t /*length*/)
 	{
 		// must check queue, as write callback can occur following dropped()
 		if (ec)
@@ -428,17 +467,17 @@ void Session::write()
 		else
 		{
 			Guard l(x_writeQueue);
-			m_writeQueue.pop_front();
+			m_writeQueue.erase(m_writeQueue.begin(), m_writeQueue.begin() + count);
 			if (m_writeQueue.empty())
 				return;
 		}
 		write();
-	});
+	}));
 }
 
 void Session::drop(DisconnectReason _reason)
 {
-	if (m_dropped)
+	if (m_dropped.exchange(true))
 		return;
 	if (m_socket.is_open())
 		try
@@ -461,7 +500,6 @@ void Session::drop(DisconnectReason _reason)
 			m_peer->m_score /= 2;
 		}
 	}
-	m_dropped = true;
 }
 
 void Session::disconnect(DisconnectReason _reason)
@@ -495,9 +533,23 @@ void Session::doRead()
 	// ignore packets received while waiting to disconnect
 	if (m_dropped)
 		return;
-	
+
+	// Make room for the read: reclaim the consumed space at the front if the tail is getting short,
+	// and grow the buffer only if it's mostly full of a single, as-yet incomplete, packet.
+	if (m_incoming.size() - m_incomingEnd < c_minReadSpace)
+	{
+		if (m_incomingBegin)
+		{
+			memmove(m_incoming.data(), m_incoming.data() + m_incomingBegin, m_incomingEnd - m_incomingBegin);
+			m_incomingEnd -= m_incomingBegin;
+			m_incomingBegin = 0;
+		}
+		if (m_incoming.size() - m_incomingEnd < c_minReadSpace)
+			m_incoming.resize(max<size_t>(m_incoming.size() * 2, c_initialReadBuffer));
+	}
+
 	auto self(shared_from_this());
-	m_socket.async_read_some(boost::asio::buffer(m_data), [this,self](boost::system::error_code ec, std::size_t length)
+	m_socket.async_read_some(boost::asio::buffer(m_incoming.data() + m_incomingEnd, m_incoming.size() - m_incomingEnd), m_strand.wrap([this,self](boost::system::error_code ec, std::size_t length)
 	{
 		// If error is end of file, ignore
 		if (ec && ec.category() != boost::asio::error::get_misc_category() && ec.value() != boost::asio::error::eof)
@@ -514,28 +566,35 @@ void Session::doRead()
 		{
 			try
 			{
-				m_incoming.resize(m_incoming.size() + length);
-				memcpy(m_incoming.data() + m_incoming.size() - length, m_data.data(), length);
-				while (m_incoming.size() > 8)
+				m_incomingEnd += length;
+				while (m_incomingEnd - m_incomingBegin > 8)
 				{
-					if (m_incoming[0] != 0x22 || m_incoming[1] != 0x40 || m_incoming[2] != 0x08 || m_incoming[3] != 0x91)
+					byte const* in = m_incoming.data() + m_incomingBegin;
+					if (in[0] != 0x22 || in[1] != 0x40 || in[2] != 0x08 || in[3] != 0x91)
 					{
-						clogS(NetWarn) << "INVALID SYNCHRONISATION TOKEN; expected = 22400891; received = " << toHex(bytesConstRef(m_incoming.data(), 4));
+						clogS(NetWarn) << "INVALID SYNCHRONISATION TOKEN; expected = 22400891; received = " << toHex(bytesConstRef(in, 4));
 						disconnect(BadProtocol);
 						return;
 					}
 					else
 					{
-						uint32_t len = fromBigEndian<uint32_t>(bytesConstRef(m_incoming.data() + 4, 4));
-						uint32_t tlen = len + 8;
-						if (m_incoming.size() < tlen)
+						uint32_t len = fromBigEndian<uint32_t>(bytesConstRef(in + 4, 4));
+						if (len > c_maxPacketSize)
+						{
+							clogS(NetWarn) << "OVERSIZED PACKET ANNOUNCED; length = " << len;
+							disconnect(BadProtocol);
+							return;
+						}
+						size_t tlen = (size_t)len + 8;
+						// Not all here yet; doRead() grows the buffer as the rest of it actually arrives.
+						if (m_incomingEnd - m_incomingBegin < tlen)
 							break;
 
 						// enough has come in.
-						auto data = bytesConstRef(m_incoming.data(), tlen);
+						auto data = bytesConstRef(in, tlen);
 						if (!checkPacket(data))
 						{
-							cerr << "Received " << len << ": " << toHex(bytesConstRef(m_incoming.data() + 8, len)) << endl;
+							cerr << "Received " << len << ": " << toHex(bytesConstRef(in + 8, len)) << endl;
 							clogS(NetWarn) << "INVALID MESSAGE RECEIVED";
 							disconnect(BadProtocol);
 							return;
@@ -551,10 +610,11 @@ void Session::doRead()
 								//return;
 							}
 						}
-						memmove(m_incoming.data(), m_incoming.data() + tlen, m_incoming.size() - tlen);
-						m_incoming.resize(m_incoming.size() - tlen);
+						m_incomingBegin += tlen;
 					}
 				}
+				if (m_incomingBegin == m_incomingEnd)
+					m_incomingBegin = m_incomingEnd = 0;
 				doRead();
 			}
 			catch (Exception const& _e)
@@ -568,5 +628,5 @@ void Session::doRead()
 				drop(BadProtocol);
 			}
 		}
-	});
+	}));
 }
@@ -23,7 +23,9 @@
 
 #include <mutex>
 #include <array>
+#include <atomic>
 #include <deque>
+#include <functional>
 #include <set>
 #include <memory>
 #include <utility>
@@ -41,6 +43,10 @@ namespace p2p
 
 class Peer;
 
+static const size_t c_initialReadBuffer = 65536;	///< Initial size of a session's read buffer.
+static const size_t c_minReadSpace = 4096;			///< Minimum free space we'll offer to a socket read.
+static const uint32_t c_maxPacketSize = 16 * 1024 * 1024;	///< Largest packet payload we'll accept from a peer.
+
 /**
  * @brief The Session class
  * @todo Document fully.
@@ -70,6 +76,8 @@ public:
 	static RLPStream& prep(RLPStream& _s, PacketType _t, unsigned _args = 0);
 	static RLPStream& prep(RLPStream& _s);
 	void sealAndSend(RLPStream& _s);
+	/// Seal and send the packet whose start is in @a _s, followed by @a _payload, which may be shared with other sessions.
+	void sealAndSend(RLPStream& _s, std::shared_ptr<bytes const> const& _payload);
 	void send(bytes&& _msg);
 	void send(bytesConstRef _msg);
 
@@ -83,6 +91,9 @@ public:
 	void ensureNodesRequested();
 	void serviceNodesRequest();
 
+	/// Run @a _f on this session's strand, serialised with its packet handlers; may be called from any thread.
+	void post(std::function<void()> const& _f);
+
 private:
 	/// Drop the connection for the reason @a _r.
 	void drop(DisconnectReason _r);
@@ -90,7 +101,10 @@ private:
 	/// Perform a read on the socket.
 	void doRead();
 
-	/// Perform a single round of the write operation. This could end up calling itself asynchronously.
+	/// Queue the message made of @a _header followed by @a _payload (if any) for writing.
+	void queueWrite(bytes&& _header, std::shared_ptr<bytes const> const& _payload);
+
+	/// Perform a single round of the write operation, writing all queued messages at once. This could end up calling itself asynchronously.
 	void write();
 
 	/// Interpret an incoming message.
@@ -102,14 +116,16 @@ private:
 	Host* m_server;							///< The host that owns us. Never null.
 
 	mutable bi::tcp::socket m_socket;		///< Socket for the peer's connection. Mutable to ask for native_handle().
+	ba::io_service::strand m_strand;		///< All of our socket handlers run on this, so they're serialised even when the io_service has several threads.
 	Mutex x_writeQueue;						///< Mutex for the write queue.
-	std::deque<bytes> m_writeQueue;			///< The write queue.
-	std::array<byte, 65536> m_data;			///< Buffer for ingress packet data.
-	bytes m_incoming;						///< Read buffer for ingress bytes.
+	std::deque<std::pair<bytes, std::shared_ptr<bytes const>>> m_writeQueue;	///< The write queue; each message is a session-specific part followed by an optional shared payload.
+	bytes m_incoming;						///< Read buffer for ingress bytes; socket reads go directly into the space after m_incomingEnd.
+	size_t m_incomingBegin = 0;				///< Offset of the first unconsumed byte in m_incoming.
+	size_t m_incomingEnd = 0;				///< Offset one past the last received byte in m_incoming.
 
 	unsigned m_protocolVersion = 0;			///< The protocol version of the peer.
 	std::shared_ptr<Peer> m_peer;			///< The Peer object.
-	bool m_dropped = false;					///< If true, we've already divested ourselves of this peer. We're just waiting for the reads & writes to fail before the shared_ptr goes OOS and the destructor kicks in.
+	std::atomic<bool> m_dropped;			///< If true, we've already divested ourselves of this peer. We're just waiting for the reads & writes to fail before the shared_ptr goes OOS and the destructor kicks in.
 
 	PeerSessionInfo m_info;						///< Dynamic information about this peer.
 	
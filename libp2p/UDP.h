@@ -112,7 +112,7 @@ public:
 	enum { maxDatagramSize = MaxDatagramSize };
 	static_assert(maxDatagramSize < 65507, "UDP datagrams cannot be larger than 65507 bytes");
 	
-	UDPSocket(ba::io_service& _io, UDPSocketEvents& _host, unsigned _port): m_host(_host), m_endpoint(bi::udp::v4(), _port), m_socket(_io) { m_started.store(false); m_closed.store(true); };
+	UDPSocket(ba::io_service& _io, UDPSocketEvents& _host, unsigned _port): m_host(_host), m_endpoint(bi::udp::v4(), _port), m_socket(_io), m_strand(_io) { m_started.store(false); m_closed.store(true); };
 	virtual ~UDPSocket() { disconnect(); }
 
 	/// Socket will begin listening for and delivering packets
@@ -126,6 +126,9 @@ public:
 
 	/// Disconnect socket.
 	void disconnect() { disconnectWithError(boost::asio::error::connection_reset); }
+
+	/// Strand on which all of the socket's handlers run. The owner may use it to serialise its own handlers with them.
+	ba::io_service::strand& strand() { return m_strand; }
 	
 protected:
 	void doRead();
@@ -145,6 +148,7 @@ protected:
 	std::array<byte, maxDatagramSize> m_recvData;	///< Buffer for ingress data.
 	bi::udp::endpoint m_recvEndpoint;				///< Endpoint data was received from.
 	bi::udp::socket m_socket;						///< Boost asio udp socket.
+	ba::io_service::strand m_strand;				///< Serialises socket handlers when the io_service is run by several threads.
 	
 	Mutex x_socketError;							///< Mutex for error which can be set from host or IO thread.
 	boost::system::error_code m_socketError;		///< Set when shut down due to error.
@@ -177,7 +181,10 @@ bool UDPSocket<Handler, MaxDatagramSize>::send(UDPDatagram const& _datagram)
 	Guard l(x_sendQ);
 	m_sendQ.push_back(_datagram);
 	if (m_sendQ.size() == 1)
-		doWrite();
+	{
+		auto self(UDPSocket<Handler, MaxDatagramSize>::shared_from_this());
+		m_strand.post([this, self](){ doWrite(); });
+	}
 	
 	return true;
 }
@@ -189,7 +196,7 @@ void UDPSocket<Handler, MaxDatagramSize>::doRead()
 		return;
 	
 	auto self(UDPSocket<Handler, MaxDatagramSize>::shared_from_this());
-	m_socket.async_receive_from(boost::asio::buffer(m_recvData), m_recvEndpoint, [this, self](boost::system::error_code _ec, size_t _len)
+	m_socket.async_receive_from(boost::asio::buffer(m_recvData), m_recvEndpoint, m_strand.wrap([this, self](boost::system::error_code _ec, size_t _len)
 	{
 		if (_ec)
 			return disconnectWithError(_ec);
@@ -197,7 +204,7 @@ void UDPSocket<Handler, MaxDatagramSize>::doRead()
 		assert(_len);
 		m_host.onReceived(this, m_recvEndpoint, bytesConstRef(m_recvData.data(), _len));
 		doRead();
-	});
+	}));
 }
 	
 template <typename Handler, unsigned MaxDatagramSize>
@@ -208,7 +215,7 @@ void UDPSocket<Handler, MaxDatagramSize>::doWrite()
 	
 	const UDPDatagram& datagram = m_sendQ[0];
 	auto self(UDPSocket<Handler, MaxDatagramSize>::shared_from_this());
-	m_socket.async_send_to(boost::asio::buffer(datagram.data), datagram.endpoint(), [this, self](boost::system::error_code _ec, std::size_t)
+	m_socket.async_send_to(boost::asio::buffer(datagram.data), datagram.endpoint(), m_strand.wrap([this, self](boost::system::error_code _ec, std::size_t)
 	{
 		if (_ec)
 			return disconnectWithError(_ec);
@@ -220,7 +227,7 @@ void UDPSocket<Handler, MaxDatagramSize>::doWrite()
 				return;
 		}
 		doWrite();
-	});
+	}));
 }
 
 template <typename Handler, unsigned MaxDatagramSize>
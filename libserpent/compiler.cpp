@@ -69,7 +69,7 @@ Node multiToken(Node nodes[], int len, Metadata met) {
 
 Node finalize(programData c);
 
-Node popwrap(Node node) {
+Node popwrap(const Node& node) {
     Node nodelist[] = {
         node,
         token("POP", node.metadata)
@@ -78,7 +78,7 @@ Node popwrap(Node node) {
 }
 
 // Turns LLL tree into tree of code fragments
-programData opcodeify(Node node,
+programData opcodeify(const Node& node,
                       programAux aux=Aux(),
                       programVerticalAux vaux=verticalAux()) {
     std::string symb = "_"+mkUniqueToken();
@@ -343,7 +343,7 @@ Node buildFragmentTree(Node node) {
 
 
 // Builds a dictionary mapping labels to variable names
-void buildDict(Node program, programAux &aux, int labelLength) {
+void buildDict(const Node& program, programAux &aux, int labelLength) {
     Metadata m = program.metadata;
     // Token
     if (program.type == TOKEN) {
@@ -376,7 +376,7 @@ void buildDict(Node program, programAux &aux, int labelLength) {
 }
 
 // Applies that dictionary
-void substDict(Node program, programAux aux, int labelLength, std::vector<Node> &out) {
+void substDict(const Node& program, programAux &aux, int labelLength, std::vector<Node> &out) {
     Metadata m = program.metadata;
     std::vector<Node> inner;
     if (program.type == TOKEN) {
@@ -412,7 +412,7 @@ void substDict(Node program, programAux aux, int labelLength, std::vector<Node>
 }
 
 // Compiled fragtree -> compiled fragtree without labels
-std::vector<Node> dereference(Node program) {
+std::vector<Node> dereference(const Node& program) {
     int sz = treeSize(program) * 4;
     int labelLength = 1;
     while (sz >= 256) { labelLength += 1; sz /= 256; }
@@ -8,7 +8,7 @@
 #include "util.h"
 
 // Compiled fragtree -> compiled fragtree without labels
-std::vector<Node> dereference(Node program);
+std::vector<Node> dereference(const Node& program);
 
 // LLL -> fragtree
 Node buildFragmentTree(Node program);
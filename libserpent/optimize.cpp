@@ -15,7 +15,7 @@ Node optimize(Node inp) {
         return o;
     }
 	for (unsigned i = 0; i < inp.args.size(); i++) {
-        inp.args[i] = optimize(inp.args[i]);
+        inp.args[i] = optimize(std::move(inp.args[i]));
     }
     // Arithmetic-specific transform
     if (inp.val == "+") inp.val = "add";
@@ -141,7 +141,7 @@ preprocessResult preprocessInit(Node inp) {
     int functionCount = 0;
     int storageDataCount = 0;
     for (unsigned i = 0; i < inp.args.size(); i++) {
-        Node obj = inp.args[i];
+        const Node& obj = inp.args[i];
         // Functions
         if (obj.val == "def") {
             if (obj.args.size() == 0)
@@ -304,24 +304,26 @@ preprocessResult preprocessInit(Node inp) {
     return preprocessResult(result, out);
 }
 
-preprocessResult processTypes (preprocessResult pr) {
-    preprocessAux aux = pr.second;
-    Node node = pr.first;
-    if (node.type == TOKEN && aux.types.count(node.val))
-        node = asn(aux.types[node.val], node, node.metadata);
-    else if (node.val == "untyped")
-        return preprocessResult(node.args[0], aux);
+// Wraps typed variables in their types, in place
+void processTypes (Node& node, const preprocessAux& aux) {
+    std::map<std::string, std::string>::const_iterator it;
+    if (node.type == TOKEN &&
+            (it = aux.types.find(node.val)) != aux.types.end())
+        node = asn(it->second, node, node.metadata);
+    else if (node.val == "untyped") {
+        Node inner = std::move(node.args[0]);
+        node = std::move(inner);
+    }
     else if (node.val == "outer")
-        return preprocessResult(node, aux);
+        return;
     else {
-        for (unsigned i = 0; i < node.args.size(); i++) {
-            node.args[i] =
-                processTypes(preprocessResult(node.args[i], aux)).first;
-        }
+        for (unsigned i = 0; i < node.args.size(); i++)
+            processTypes(node.args[i], aux);
     }
-    return preprocessResult(node, aux);
 }
 
 preprocessResult preprocess(Node n) {
-    return processTypes(preprocessInit(n));
+    preprocessResult pr = preprocessInit(std::move(n));
+    processTypes(pr.first, pr.second);
+    return pr;
 }
@@ -349,7 +349,7 @@ std::string setters[][2] = {
 std::map<std::string, std::string> setterMap;
 
 // Processes mutable array literals
-Node array_lit_transform(Node node) {
+Node array_lit_transform(const Node& node) {
     std::string prefix = "_temp"+mkUniqueToken() + "_";
     Metadata m = node.metadata;
     std::map<std::string, Node> d;
@@ -394,7 +394,7 @@ Node apply_rules(preprocessResult pr);
 
 // Transform "<variable>.<fun>(args...)" into
 // a call
-Node dotTransform(Node node, preprocessAux aux) {
+Node dotTransform(const Node& node, preprocessAux& aux) {
     Metadata m = node.metadata;
     // We're gonna make lots of temporary variables,
     // so set up a unique flag for them
@@ -416,7 +416,7 @@ Node dotTransform(Node node, preprocessAux aux) {
     std::string op = "call";
     for (unsigned i = 1; i < node.args.size(); i++) {
         fnargs.push_back(node.args[i]);
-        Node arg = fnargs.back();
+        const Node& arg = fnargs.back();
         if (arg.val == "=" || arg.val == "set") {
             if (arg.args[0].val == "as")
                 as = arg.args[1].val;
@@ -501,7 +501,7 @@ Node dotTransform(Node node, preprocessAux aux) {
 // obj2[0].a -> sha3([1, 0, 0])
 // obj2[5].b[1][3] -> sha3([1, 5, 1, 1, 3])
 // obj2[45].c -> sha3([1, 45, 2])
-Node storageTransform(Node node, preprocessAux aux,
+Node storageTransform(const Node& node, preprocessAux& aux,
                       bool mapstyle=false, bool ref=false) {
     Metadata m = node.metadata;
     // Get a list of all of the "access parameters" used in order
@@ -604,66 +604,67 @@ Node storageTransform(Node node, preprocessAux aux,
     else return astnode("sload", o, node.metadata);
 }
 
-// Basic rewrite rule execution
-std::pair<Node, bool> rulesTransform(Node node, rewriteRuleSet macros) {
-    std::string prefix = "_temp_"+mkUniqueToken();
+// Basic rewrite rule execution; rewrites the node in place until
+// no rule matches, returning whether anything changed
+bool rulesTransform(Node& node, const rewriteRuleSet& macros) {
     bool changed = false;
-    if (!macros.ruleLists.count(node.val))
-        return std::pair<Node, bool>(node, false);
-    std::vector<rewriteRule> rules = macros.ruleLists[node.val];
-    for (unsigned pos = 0; pos < rules.size(); pos++) {
-        rewriteRule macro = rules[pos];
-        matchResult mr = match(macro.pattern, node);
-        if (mr.success) {
-            node = subst(macro.substitution, mr.map, prefix, node.metadata);
-            std::pair<Node, bool> o = rulesTransform(node, macros);
-            o.second = true;
-            return o;
+    while (1) {
+        std::string prefix = "_temp_"+mkUniqueToken();
+        const std::vector<rewriteRule>* rules = macros.rulesFor(node);
+        if (!rules)
+            return changed;
+        bool matched = false;
+        for (unsigned pos = 0; pos < rules->size() && !matched; pos++) {
+            const rewriteRule& macro = (*rules)[pos];
+            matchResult mr = match(macro.pattern, node);
+            if (mr.success) {
+                node = subst(macro.substitution, mr.map, prefix, node.metadata);
+                matched = true;
+            }
         }
+        if (!matched)
+            return changed;
+        changed = true;
     }
-    return std::pair<Node, bool>(node, changed);
 }
 
-std::pair<Node, bool> synonymTransform(Node node) {
-    bool changed = false;
-    if (node.type == ASTNODE && synonymMap.count(node.val)) {
-        node.val = synonymMap[node.val];
-        changed = true;
+bool synonymTransform(Node& node) {
+    if (node.type == ASTNODE) {
+        std::map<std::string, std::string>::const_iterator it =
+            synonymMap.find(node.val);
+        if (it != synonymMap.end()) {
+            node.val = it->second;
+            return true;
+        }
     }
-    return std::pair<Node, bool>(node, changed);
+    return false;
 }
 
 rewriteRuleSet nodeMacros;
 rewriteRuleSet setterMacros;
 
-bool dontDescend(std::string s) {
+bool dontDescend(const std::string& s) {
     return s == "macro" || s == "comment" || s == "outer";
 }
 
-// Recursively applies any set of rewrite rules
-std::pair<Node, bool> apply_rules_iter(preprocessResult pr, rewriteRuleSet rules) {
-    bool changed = false;
-    Node node = pr.first;
+// Recursively applies any set of rewrite rules, in place
+bool apply_rules_iter(Node& node, const rewriteRuleSet& rules) {
     if (dontDescend(node.val))
-        return std::pair<Node, bool>(node, false);
-    std::pair<Node, bool> o = rulesTransform(node, rules);
-    node = o.first;
-    changed = changed || o.second;
+        return false;
+    bool changed = rulesTransform(node, rules);
     if (node.type == ASTNODE) {
         for (unsigned i = 0; i < node.args.size(); i++) {
-            std::pair<Node, bool> r =
-                apply_rules_iter(preprocessResult(node.args[i], pr.second), rules);
-            node.args[i] = r.first;
-            changed = changed || r.second;
+            if (apply_rules_iter(node.args[i], rules))
+                changed = true;
         }
     }
-    return std::pair<Node, bool>(node, changed);
+    return changed;
 }
 
-// Recursively applies rewrite rules and other primary transformations
-std::pair<Node, bool> mainTransform(preprocessResult pr) {
+// Recursively applies rewrite rules and other primary transformations,
+// in place
+bool mainTransform(Node& node, preprocessAux& aux) {
     bool changed = false;
-    Node node = pr.first;
 
     // Anything inside "outer" should be treated as a separate program
     // and thus recursively compiled in its entirety
@@ -674,19 +675,19 @@ std::pair<Node, bool> mainTransform(preprocessResult pr) {
 
     // Don't descend into comments, macros and inner scopes
     if (dontDescend(node.val))
-        return std::pair<Node, bool>(node, changed);
+        return changed;
 
     // Special storage transformation
     if (isNodeStorageVariable(node)) {
-        node = storageTransform(node, pr.second);
+        node = storageTransform(node, aux);
         changed = true;
     }
     if (node.val == "ref" && isNodeStorageVariable(node.args[0])) {
-        node = storageTransform(node.args[0], pr.second, false, true);
+        node = storageTransform(node.args[0], aux, false, true);
         changed = true;
     }
     if (node.val == "=" && isNodeStorageVariable(node.args[0])) {
-        Node t = storageTransform(node.args[0], pr.second);
+        Node t = storageTransform(node.args[0], aux);
         if (t.val == "sload") {
             std::vector<Node> o;
             o.push_back(t.args[0]);
@@ -696,13 +697,11 @@ std::pair<Node, bool> mainTransform(preprocessResult pr) {
         changed = true;
     }
     // Main code
-    std::pair<Node, bool> pnb = synonymTransform(node);
-    node = pnb.first;
-    changed = changed || pnb.second;
+    if (synonymTransform(node))
+        changed = true;
     // std::cerr << priority << " " << macros.size() << "\n";
-    std::pair<Node, bool> pnc = rulesTransform(node, nodeMacros);
-    node = pnc.first;
-    changed = changed || pnc.second;
+    if (rulesTransform(node, nodeMacros))
+        changed = true;
 
 
     // Special transformations
@@ -711,7 +710,7 @@ std::pair<Node, bool> mainTransform(preprocessResult pr) {
         changed = true;
     }
     if (node.val == "fun" && node.args[0].val == ".") {
-        node = dotTransform(node, pr.second);
+        node = dotTransform(node, aux);
         changed = true;
     }
     if (node.val == "text") {
@@ -739,17 +738,15 @@ std::pair<Node, bool> mainTransform(preprocessResult pr) {
         }
         // Recursively process children
         for (; i < node.args.size(); i++) {
-            std::pair<Node, bool> r =
-                mainTransform(preprocessResult(node.args[i], pr.second));
-            node.args[i] = r.first;
-            changed = changed || r.second;
+            if (mainTransform(node.args[i], aux))
+                changed = true;
         }
     }
     // Add leading ' to variable names, and wrap them inside get
     else if (node.type == TOKEN && !isNumberLike(node)) {
         if (node.val.size() && node.val[0] != '\'' && node.val[0] != '$') {
             Node n = astnode("get", tkn("'"+node.val), node.metadata);
-            node = n;
+            node = std::move(n);
             changed = true;
         }
     }
@@ -758,7 +755,7 @@ std::pair<Node, bool> mainTransform(preprocessResult pr) {
         node.val = strToNumeric(node.val);
         changed = true;
     }
-    return std::pair<Node, bool>(node, changed);
+    return changed;
 }
 
 // Do some preprocessing to convert all of our macro lists into compiled
@@ -791,34 +788,27 @@ Node apply_rules(preprocessResult pr) {
     if (!nodeMacros.ruleLists.size()) parseMacros();
     // Iterate over macros by priority list
     std::map<int, rewriteRuleSet >::iterator it;
-    std::pair<Node, bool> r;
     for(it=pr.second.customMacros.begin();
         it != pr.second.customMacros.end(); it++) {
         while (1) {
             // std::cerr << "STARTING ARI CYCLE: " << (*it).first <<"\n";
             // std::cerr << printAST(pr.first) << "\n";
-            r = apply_rules_iter(pr, (*it).second);
-            pr.first = r.first;
-            if (!r.second) break;
+            if (!apply_rules_iter(pr.first, (*it).second)) break;
         }
     }
     // Apply setter macros
     while (1) {
-        r = apply_rules_iter(pr, setterMacros);
-        pr.first = r.first;
-        if (!r.second) break;
+        if (!apply_rules_iter(pr.first, setterMacros)) break;
     }
     // Apply all other mactos
     while (1) {
-        r = mainTransform(pr);
-        pr.first = r.first;
-        if (!r.second) break;
+        if (!mainTransform(pr.first, pr.second)) break;
     }
-    return r.first;
+    return pr.first;
 }
 
 // Pre-validation
-Node validate(Node inp) {
+void validate(const Node& inp) {
     Metadata m = inp.metadata;
     if (inp.type == ASTNODE) {
         int i = 0;
@@ -840,7 +830,6 @@ Node validate(Node inp) {
         if (inp.val[0] == '_') err("Variables cannot start with _", m);
     }
 	for (unsigned i = 0; i < inp.args.size(); i++) validate(inp.args[i]);
-    return inp;
 }
 
 Node postValidate(Node inp) {
@@ -865,7 +854,7 @@ Node postValidate(Node inp) {
         }
         else err ("Invalid argument count or LLL function: "+printSimple(inp), inp.metadata);
         for (unsigned i = 0; i < inp.args.size(); i++) {
-            inp.args[i] = postValidate(inp.args[i]);
+            inp.args[i] = postValidate(std::move(inp.args[i]));
         }
     }
     return inp;
@@ -873,13 +862,14 @@ Node postValidate(Node inp) {
 
 
 Node rewriteChunk(Node inp) {
+    validate(inp);
     return postValidate(optimize(apply_rules(
                         preprocessResult(
-                        validate(inp), preprocessAux()))));
+                        std::move(inp), preprocessAux()))));
 }
 
 // Flatten nested sequence into flat sequence
-Node flattenSeq(Node inp) {
+Node flattenSeq(const Node& inp) {
     std::vector<Node> o;
     if (inp.val == "seq" && inp.type == ASTNODE) {
         for (unsigned i = 0; i < inp.args.size(); i++) {
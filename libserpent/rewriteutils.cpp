@@ -69,7 +69,7 @@ void cerrStringList(std::vector<std::string> s, std::string suffix) {
 // self.horse[0] -> ["horse", "0"]
 // self.a[6][7][self.storage[3]].chicken[9] -> 
 //     ["6", "7", (sload 3), "chicken", "9"]
-std::vector<Node> listfyStorageAccess(Node node) {
+std::vector<Node> listfyStorageAccess(const Node& node) {
     std::vector<Node> out;
     std::vector<Node> nodez;
     nodez.push_back(node);
@@ -98,16 +98,15 @@ std::vector<Node> listfyStorageAccess(Node node) {
 // self.cow
 // self.horse[0]
 // self.a[6][7][self.storage[3]].chicken[9]
-bool isNodeStorageVariable(Node node) {
-    std::vector<Node> nodez;
-    nodez.push_back(node);
+bool isNodeStorageVariable(const Node& node) {
+    const Node* n = &node;
     while (1) {
-        if (nodez.back().type == TOKEN) return false;
-        if (nodez.back().args.size() == 0) return false;
-        if (nodez.back().val != "." && nodez.back().val != "access")
+        if (n->type == TOKEN) return false;
+        if (n->args.size() == 0) return false;
+        if (n->val != "." && n->val != "access")
             return false;
-        if (nodez.back().args[0].val == "self") return true;
-        nodez.push_back(nodez.back().args[0]);
+        if (n->args[0].val == "self") return true;
+        n = &n->args[0];
     }
 }
 
@@ -117,34 +116,33 @@ bool isNodeStorageVariable(Node node) {
 // Returns two values. First, a boolean to determine whether the node matches
 // the pattern, second, if the node does match then a map mapping variables
 // in the pattern to nodes
-matchResult match(Node p, Node n) {
-    matchResult o;
-    o.success = false;
+//
+// Variables are bound straight into the one map as they are met, so no
+// subtree is copied more than once
+bool matchInto(const Node& p, const Node& n, std::map<std::string, Node>& o) {
     if (p.type == TOKEN) {
-        if (p.val == n.val && n.type == TOKEN) o.success = true;
+        if (p.val == n.val && n.type == TOKEN) return true;
         else if (p.val[0] == '$' || p.val[0] == '@') {
-            o.success = true;
-            o.map[p.val.substr(1)] = n;
+            o[p.val.substr(1)] = n;
+            return true;
         }
+        return false;
     }
     else if (n.type==TOKEN || p.val!=n.val || p.args.size()!=n.args.size()) {
-        // do nothing
+        return false;
     }
-    else {
-		for (unsigned i = 0; i < p.args.size(); i++) {
-            matchResult oPrime = match(p.args[i], n.args[i]);
-            if (!oPrime.success) {
-                o.success = false;
-                return o;
-            }
-            for (std::map<std::string, Node>::iterator it = oPrime.map.begin();
-                 it != oPrime.map.end();
-                 it++) {
-                o.map[(*it).first] = (*it).second;
-            }
-        }
-        o.success = true;
+    for (unsigned i = 0; i < p.args.size(); i++) {
+        if (!matchInto(p.args[i], n.args[i], o))
+            return false;
     }
+    return true;
+}
+
+matchResult match(const Node& p, const Node& n) {
+    matchResult o;
+    o.success = matchInto(p, n, o.map);
+    if (!o.success)
+        o.map.clear();
     return o;
 }
 
@@ -152,17 +150,17 @@ matchResult match(Node p, Node n) {
 // Fills in the pattern with a dictionary mapping variable names to
 // nodes (these dicts are generated by match). Match and subst together
 // create a full pattern-matching engine. 
-Node subst(Node pattern,
-           std::map<std::string, Node> dict,
-           std::string varflag,
-           Metadata m) {
+Node subst(const Node& pattern,
+           const std::map<std::string, Node>& dict,
+           const std::string& varflag,
+           const Metadata& m) {
     // Swap out patterns at the token level
-    if (pattern.metadata.ln == -1)
-        pattern.metadata = m;
     if (pattern.type == TOKEN && 
             pattern.val[0] == '$') {
-        if (dict.count(pattern.val.substr(1))) {
-            return dict[pattern.val.substr(1)];
+        std::map<std::string, Node>::const_iterator it =
+            dict.find(pattern.val.substr(1));
+        if (it != dict.end()) {
+            return it->second;
         }
         else {
             return token(varflag + pattern.val.substr(1), m);
@@ -170,26 +168,30 @@ Node subst(Node pattern,
     }
     // Other tokens are untouched
     else if (pattern.type == TOKEN) {
-        return pattern;
+        Node o = pattern;
+        if (o.metadata.ln == -1)
+            o.metadata = m;
+        return o;
     }
     // Substitute recursively for ASTs
     else {
         std::vector<Node> args;
+        args.reserve(pattern.args.size());
 		for (unsigned i = 0; i < pattern.args.size(); i++) {
             args.push_back(subst(pattern.args[i], dict, varflag, m));
         }
-        return asn(pattern.val, args, m);
+        return asn(pattern.val, std::move(args), m);
     }
 }
 
 // Transforms a sequence containing two-argument with statements
 // into a statement containing those statements in nested form
-Node withTransform (Node source) {
+Node withTransform (const Node& source) {
     Node o = token("--");
     Metadata m = source.metadata;
     std::vector<Node> args;
     for (int i = source.args.size() - 1; i >= 0; i--) {
-        Node a = source.args[i];
+        const Node& a = source.args[i];
         if (a.val == "with" && a.args.size() == 2) {
             std::vector<Node> flipargs;
             for (int j = args.size() - 1; j >= 0; j--)
@@ -16,7 +16,7 @@ bool isValidFunctionName(std::string f);
 
 // Converts deep array access into ordered list of the arguments
 // along the descent
-std::vector<Node> listfyStorageAccess(Node node);
+std::vector<Node> listfyStorageAccess(const Node& node);
 
 // Cool function for debug purposes (named cerrStringList to make
 // all prints searchable via 'cerr')
@@ -26,7 +26,7 @@ void cerrStringList(std::vector<std::string> s, std::string suffix="");
 // self.cow
 // self.horse[0]
 // self.a[6][7][self.storage[3]].chicken[9]
-bool isNodeStorageVariable(Node node);
+bool isNodeStorageVariable(const Node& node);
 
 // Applies rewrite rules adding without wrapper
 Node rewriteChunk(Node inp);
@@ -38,19 +38,19 @@ struct matchResult {
 };
 
 // Match node to pattern
-matchResult match(Node p, Node n);
+matchResult match(const Node& p, const Node& n);
 
 // Substitute node using pattern
-Node subst(Node pattern,
-           std::map<std::string, Node> dict,
-           std::string varflag,
-           Metadata m);
+Node subst(const Node& pattern,
+           const std::map<std::string, Node>& dict,
+           const std::string& varflag,
+           const Metadata& m);
 
-Node withTransform(Node source);
+Node withTransform(const Node& source);
 
 class rewriteRule {
     public:
-        rewriteRule(Node p, Node s) {
+        rewriteRule(const Node& p, const Node& s) {
             pattern = p;
             substitution = s;
         }
@@ -58,17 +58,29 @@ class rewriteRule {
         Node substitution;
 };
 
+// Rules are indexed by the head symbol and arity of their pattern
+// (-1 for token patterns), as a node can only ever match a pattern
+// with the same head and arity
 class rewriteRuleSet {
     public:
+        typedef std::pair<std::string, int> ruleKey;
         rewriteRuleSet() {
-            ruleLists = std::map<std::string, std::vector<rewriteRule> >();
+            ruleLists = std::map<ruleKey, std::vector<rewriteRule> >();
         }
-        void addRule(rewriteRule r) {
-            if (!ruleLists.count(r.pattern.val))
-                ruleLists[r.pattern.val] = std::vector<rewriteRule>();
-            ruleLists[r.pattern.val].push_back(r);
+        static ruleKey keyOf(const Node& n) {
+            return ruleKey(n.val, n.type == TOKEN ? -1 : (int)n.args.size());
         }
-        std::map<std::string, std::vector<rewriteRule> > ruleLists;
+        void addRule(const rewriteRule& r) {
+            ruleLists[keyOf(r.pattern)].push_back(r);
+        }
+        // Rules that may match the node, in the order they were added,
+        // or null if there are none
+        const std::vector<rewriteRule>* rulesFor(const Node& n) const {
+            std::map<ruleKey, std::vector<rewriteRule> >::const_iterator it =
+                ruleLists.find(keyOf(n));
+            return it == ruleLists.end() ? NULL : &it->second;
+        }
+        std::map<ruleKey, std::vector<rewriteRule> > ruleLists;
 };
 
 
@@ -11,8 +11,8 @@
 Node token(std::string val, Metadata met) {
     Node o;
     o.type = 0;
-    o.val = val;
-    o.metadata = met;
+    o.val = std::move(val);
+    o.metadata = std::move(met);
     return o;
 }
 
@@ -20,46 +20,45 @@ Node token(std::string val, Metadata met) {
 Node astnode(std::string val, std::vector<Node> args, Metadata met) {
     Node o;
     o.type = 1;
-    o.val = val;
-    o.args = args;
-    o.metadata = met;
+    o.val = std::move(val);
+    o.args = std::move(args);
+    o.metadata = std::move(met);
     return o;
 }
 
 //AST node constructors for a specific number of children
 Node astnode(std::string val, Metadata met) {
-    std::vector<Node> args;
-    return astnode(val, args, met);
+    return astnode(std::move(val), std::vector<Node>(), std::move(met));
 }
 
 Node astnode(std::string val, Node a, Metadata met) {
     std::vector<Node> args;
-    args.push_back(a);
-    return astnode(val, args, met);
+    args.push_back(std::move(a));
+    return astnode(std::move(val), std::move(args), std::move(met));
 }
 
 Node astnode(std::string val, Node a, Node b, Metadata met) {
     std::vector<Node> args;
-    args.push_back(a);
-    args.push_back(b);
-    return astnode(val, args, met);
+    args.push_back(std::move(a));
+    args.push_back(std::move(b));
+    return astnode(std::move(val), std::move(args), std::move(met));
 }
 
 Node astnode(std::string val, Node a, Node b, Node c, Metadata met) {
     std::vector<Node> args;
-    args.push_back(a);
-    args.push_back(b);
-    args.push_back(c);
-    return astnode(val, args, met);
+    args.push_back(std::move(a));
+    args.push_back(std::move(b));
+    args.push_back(std::move(c));
+    return astnode(std::move(val), std::move(args), std::move(met));
 }
 
 Node astnode(std::string val, Node a, Node b, Node c, Node d, Metadata met) {
     std::vector<Node> args;
-    args.push_back(a);
-    args.push_back(b);
-    args.push_back(c);
-    args.push_back(d);
-    return astnode(val, args, met);
+    args.push_back(std::move(a));
+    args.push_back(std::move(b));
+    args.push_back(std::move(c));
+    args.push_back(std::move(d));
+    return astnode(std::move(val), std::move(args), std::move(met));
 }
 
 
@@ -73,7 +72,7 @@ std::string printTokens(std::vector<Node> tokens) {
 }
 
 // Prints a lisp AST on one line
-std::string printSimple(Node ast) {
+std::string printSimple(const Node& ast) {
     if (ast.type == TOKEN) return ast.val;
     std::string o = "(" + ast.val;
     std::vector<std::string> subs;
@@ -84,7 +83,7 @@ std::string printSimple(Node ast) {
 }
 
 // Number of tokens in a tree
-int treeSize(Node prog) {
+int treeSize(const Node& prog) {
     if (prog.type == TOKEN) return 1;
     int o = 0;
 	for (unsigned i = 0; i < prog.args.size(); i++) o += treeSize(prog.args[i]);
@@ -92,7 +91,7 @@ int treeSize(Node prog) {
 }
 
 // Pretty-prints a lisp AST
-std::string printAST(Node ast, bool printMetadata) {
+std::string printAST(const Node& ast, bool printMetadata) {
     if (ast.type == TOKEN) return ast.val;
     std::string o = "(";
     if (printMetadata) {
@@ -170,7 +169,7 @@ std::string binToNumeric(std::string inp) {
 }
 
 // Converts string to simple numeric format
-std::string strToNumeric(std::string inp) {
+std::string strToNumeric(const std::string& inp) {
     std::string o = "0";
     if (inp == "") {
         o = "";
@@ -199,13 +198,13 @@ std::string strToNumeric(std::string inp) {
 }
 
 // Does the node contain a number (eg. 124, 0xf012c, "george")
-bool isNumberLike(Node node) {
+bool isNumberLike(const Node& node) {
     if (node.type == ASTNODE) return false;
     return strToNumeric(node.val) != "";
 }
 
 // Is the number decimal?
-bool isDecimal(std::string inp) {
+bool isDecimal(const std::string& inp) {
     for (unsigned i = 0; i < inp.length(); i++) {
         if (inp[i] < '0' || inp[i] > '9') return false;
     }
@@ -213,12 +212,12 @@ bool isDecimal(std::string inp) {
 }
 
 //Normalizes number representations
-Node nodeToNumeric(Node node) {
+Node nodeToNumeric(const Node& node) {
     std::string o = strToNumeric(node.val);
     return token(o == "" ? node.val : o, node.metadata);
 }
 
-Node tryNumberize(Node node) {
+Node tryNumberize(const Node& node) {
     if (node.type == TOKEN && isNumberLike(node)) return nodeToNumeric(node);
     return node;
 }
@@ -227,7 +226,17 @@ Node tryNumberize(Node node) {
 std::vector<Node> toByteArr(std::string val, Metadata metadata, int minLen) {
     std::vector<Node> o;
     int L = 0;
-    while (val != "0" || L < minLen) {
+    // Anything under 10^9 fits in an unsigned, so skip the decimal
+    // string arithmetic for it
+    if (val.size() && val.size() <= 9 && isDecimal(val)) {
+        unsigned v = decimalToUnsigned(val);
+        while (v || L < minLen) {
+            o.push_back(token(unsignedToDecimal(v % 256), metadata));
+            v /= 256;
+            L++;
+        }
+    }
+    else while (val != "0" || L < minLen) {
         o.push_back(token(decimalMod(val, "256"), metadata));
         val = decimalDiv(val, "256");
         L++;
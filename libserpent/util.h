@@ -43,6 +43,9 @@ class Metadata {
 std::string mkUniqueToken();
 
 // type can be TOKEN or ASTNODE
+//
+// The node constructors below take their arguments by value and move
+// them into place, so passing temporaries costs no deep copy
 class Node {
     public:
         int type;
@@ -60,16 +63,16 @@ Node astnode(std::string val, Node a, Node b,
              Node c, Node d, Metadata met=Metadata());
 
 // Number of tokens in a tree
-int treeSize(Node prog);
+int treeSize(const Node& prog);
 
 // Print token list
 std::string printTokens(std::vector<Node> tokens);
 
 // Prints a lisp AST on one line
-std::string printSimple(Node ast);
+std::string printSimple(const Node& ast);
 
 // Pretty-prints a lisp AST
-std::string printAST(Node ast, bool printMetadata=false);
+std::string printAST(const Node& ast, bool printMetadata=false);
 
 // Splits text by line
 std::vector<std::string> splitLines(std::string s);
@@ -84,16 +87,16 @@ std::string indentLines(std::string inp);
 std::string binToNumeric(std::string inp);
 
 // Converts string to simple numeric format
-std::string strToNumeric(std::string inp);
+std::string strToNumeric(const std::string& inp);
 
 // Does the node contain a number (eg. 124, 0xf012c, "george")
-bool isNumberLike(Node node);
+bool isNumberLike(const Node& node);
 
 //Normalizes number representations
-Node nodeToNumeric(Node node);
+Node nodeToNumeric(const Node& node);
 
 //If a node is numeric, normalize its representation
-Node tryNumberize(Node node);
+Node tryNumberize(const Node& node);
 
 //Converts a value to an array of byte number nodes
 std::vector<Node> toByteArr(std::string val, Metadata metadata, int minLen=1);
@@ -126,7 +129,7 @@ std::vector<int> triple(int a, int b, int c);
 std::vector<Node> extend(std::vector<Node> a, std::vector<Node> b);
 
 // Is the number decimal?
-bool isDecimal(std::string inp);
+bool isDecimal(const std::string& inp);
 
 #define asn astnode
 #define tkn token
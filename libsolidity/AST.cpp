@@ -93,6 +93,14 @@ void ContractDefinition::checkTypeRequirements()
 	}
 }
 
+void ContractDefinition::setLinearizedBaseContracts(vector<ContractDefinition const*> const& _bases)
+{
+	RecursiveGuard l(x_lazyMembers);
+	m_linearizedBaseContracts = _bases;
+	m_interfaceFunctionList.reset();
+	m_interfaceEvents.reset();
+}
+
 map<FixedHash<4>, FunctionTypePointer> ContractDefinition::getInterfaceFunctions() const
 {
 	auto exportedFunctionList = getInterfaceFunctionList();
@@ -165,6 +173,7 @@ void ContractDefinition::checkIllegalOverrides() const
 
 std::vector<ASTPointer<EventDefinition>> const& ContractDefinition::getInterfaceEvents() const
 {
+	RecursiveGuard l(x_lazyMembers);
 	if (!m_interfaceEvents)
 	{
 		set<string> eventsSeen;
@@ -182,6 +191,7 @@ std::vector<ASTPointer<EventDefinition>> const& ContractDefinition::getInterface
 
 vector<pair<FixedHash<4>, FunctionTypePointer>> const& ContractDefinition::getInterfaceFunctionList() const
 {
+	RecursiveGuard l(x_lazyMembers);
 	if (!m_interfaceFunctionList)
 	{
 		set<string> functionsSeen;
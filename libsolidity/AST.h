@@ -173,6 +173,7 @@ class VariableScope
 {
 public:
 	void addLocalVariable(VariableDeclaration const& _localVariable) { m_localVariables.push_back(&_localVariable); }
+	void clearLocalVariables() { m_localVariables.clear(); }
 	std::vector<VariableDeclaration const*> const& getLocalVariables() const { return m_localVariables; }
 
 private:
@@ -250,7 +251,8 @@ public:
 	/// List of all (direct and indirect) base contracts in order from derived to base, including
 	/// the contract itself. Available after name resolution
 	std::vector<ContractDefinition const*> const& getLinearizedBaseContracts() const { return m_linearizedBaseContracts; }
-	void setLinearizedBaseContracts(std::vector<ContractDefinition const*> const& _bases) { m_linearizedBaseContracts = _bases; }
+	/// Sets the base contracts; the interface is worked out again from these if the AST is resolved anew.
+	void setLinearizedBaseContracts(std::vector<ContractDefinition const*> const& _bases);
 
 	/// Returns the constructor or nullptr if no constructor was specified.
 	FunctionDefinition const* getConstructor() const;
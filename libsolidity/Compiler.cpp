@@ -54,7 +54,7 @@ void Compiler::compileContract(ContractDefinition const& _contract,
 	m_context = CompilerContext(); // clear it just in case
 	initializeContext(_contract, _contracts);
 	appendFunctionSelector(_contract);
-	set<Declaration const*> functions = m_context.getFunctionsWithoutCode();
+	vector<Declaration const*> functions = m_context.getFunctionsWithoutCode();
 	while (!functions.empty())
 	{
 		for (Declaration const* function: functions)
@@ -117,7 +117,7 @@ void Compiler::packIntoContractCreator(ContractDefinition const& _contract, Comp
 	m_context << u256(0) << eth::Instruction::RETURN;
 
 	// note that we have to include the functions again because of absolute jump labels
-	set<Declaration const*> functions = m_context.getFunctionsWithoutCode();
+	vector<Declaration const*> functions = m_context.getFunctionsWithoutCode();
 	while (!functions.empty())
 	{
 		for (Declaration const* function: functions)
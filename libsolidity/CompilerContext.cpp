@@ -22,6 +22,8 @@
 
 #include <utility>
 #include <numeric>
+#include <algorithm>
+#include <tuple>
 #include <libsolidity/AST.h>
 #include <libsolidity/Compiler.h>
 
@@ -122,13 +124,23 @@ eth::AssemblyItem CompilerContext::getSuperFunctionEntryLabel(string const& _nam
 	return m_asm.newTag(); // not reached
 }
 
-set<Declaration const*> CompilerContext::getFunctionsWithoutCode()
+vector<Declaration const*> CompilerContext::getFunctionsWithoutCode()
 {
-	set<Declaration const*> functions;
+	vector<Declaration const*> functions;
 	for (auto const& it: m_functionEntryLabels)
 		if (m_functionsWithCode.count(it.first) == 0)
-			functions.insert(it.first);
-	return move(functions);
+			functions.push_back(it.first);
+	// In source order rather than by address, so that the code does not depend on where the AST happens to live.
+	auto position = [](Declaration const* _d)
+	{
+		SourceLocation const& l = _d->getLocation();
+		return make_tuple(l.sourceName ? *l.sourceName : string(), l.start);
+	};
+	sort(functions.begin(), functions.end(), [&](Declaration const* _a, Declaration const* _b)
+	{
+		return position(_a) < position(_b);
+	});
+	return functions;
 }
 
 ModifierDefinition const& CompilerContext::getFunctionModifier(string const& _name) const
@@ -62,8 +62,8 @@ public:
 	/// @returns the entry label of function with the given name from the most derived class just
 	/// above _base in the current inheritance hierarchy.
 	eth::AssemblyItem getSuperFunctionEntryLabel(std::string const& _name, ContractDefinition const& _base);
-	/// @returns the set of functions for which we still need to generate code
-	std::set<Declaration const*> getFunctionsWithoutCode();
+	/// @returns the functions for which we still need to generate code, in source order
+	std::vector<Declaration const*> getFunctionsWithoutCode();
 	/// Resets function specific members, inserts the function entry label and marks the function
 	/// as "having code".
 	void startFunction(Declaration const& _function);
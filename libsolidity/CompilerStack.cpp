@@ -21,8 +21,11 @@
  * Full-stack compiler that converts a source code string to bytecode.
  */
 
+#include <atomic>
+#include <thread>
 #include <boost/algorithm/string.hpp>
 #include <libsolidity/AST.h>
+#include <libsolidity/ASTVisitor.h>
 #include <libsolidity/Scanner.h>
 #include <libsolidity/Parser.h>
 #include <libsolidity/GlobalContext.h>
@@ -40,6 +43,20 @@ namespace dev
 namespace solidity
 {
 
+namespace
+{
+
+/// Collects the contracts that are created (with "new") anywhere in a part of the AST.
+class CreatedContracts: public ASTConstVisitor
+{
+public:
+	virtual bool visit(NewExpression const& _node) override { contracts.insert(_node.getContract()); return true; }
+
+	set<ContractDefinition const*> contracts;
+};
+
+}
+
 const map<string, string> StandardSources = map<string, string>{
 	{"coin", R"(import "CoinReg";import "Config";import "configUser";contract coin is configUser{function coin(string3 name, uint denom) {CoinReg(Config(configAddr()).lookup(3)).register(name, denom);}})"},
 	{"Coin", R"(contract Coin{function isApprovedFor(address _target,address _proxy)constant returns(bool _r){}function isApproved(address _proxy)constant returns(bool _r){}function sendCoinFrom(address _from,uint256 _val,address _to){}function coinBalanceOf(address _a)constant returns(uint256 _r){}function sendCoin(uint256 _val,address _to){}function coinBalance()constant returns(uint256 _r){}function approve(address _a){}})"},
@@ -65,8 +82,21 @@ bool CompilerStack::addSource(string const& _name, string const& _content, bool
 {
 	bool existed = m_sources.count(_name) != 0;
 	reset(true);
-	m_sources[_name].scanner = make_shared<Scanner>(CharStream(_content), _name);
-	m_sources[_name].isLibrary = _isLibrary;
+	Source& source = m_sources[_name];
+	source.hash = dev::sha3(_content);
+	auto parsed = m_parsedSources.find(_name);
+	if (parsed != m_parsedSources.end() && parsed->second.hash == source.hash)
+		source.scanner = parsed->second.scanner;
+	else if (parsed != m_parsedSources.end())
+	{
+		// An edited version of a source seen before: only the tokens around the edit are scanned again.
+		source.scanner = parsed->second.scanner;
+		source.scanner->update(CharStream(_content));
+		m_parsedSources.erase(parsed);
+	}
+	else
+		source.scanner = make_shared<Scanner>(CharStream(_content), _name);
+	source.isLibrary = _isLibrary;
 	return existed;
 }
 
@@ -76,13 +106,36 @@ void CompilerStack::setSource(string const& _sourceCode)
 	addSource("", _sourceCode);
 }
 
+void CompilerStack::clearSources()
+{
+	m_sources.clear();
+	reset(true);
+	if (m_addStandardSources)
+		addSources(StandardSources, true);
+}
+
 void CompilerStack::parse()
 {
 	for (auto& sourcePair: m_sources)
 	{
-		sourcePair.second.scanner->reset();
-		sourcePair.second.ast = Parser().parse(sourcePair.second.scanner);
+		Source& source = sourcePair.second;
+		auto parsed = m_parsedSources.find(sourcePair.first);
+		// The AST of an unchanged source is reused; resolving names and types below overwrites whatever
+		// was worked out for it last time.
+		if (parsed != m_parsedSources.end() && parsed->second.hash == source.hash && parsed->second.ast)
+		{
+			source.scanner = parsed->second.scanner;
+			source.ast = parsed->second.ast;
+		}
+		else
+		{
+			source.scanner->reset();
+			source.ast = Parser().parse(source.scanner);
+		}
 	}
+	m_parsedSources.clear();
+	for (auto const& sourcePair: m_sources)
+		m_parsedSources[sourcePair.first] = sourcePair.second;
 	resolveImports();
 
 	m_globalContext = make_shared<GlobalContext>();
@@ -133,19 +186,100 @@ void CompilerStack::compile(bool _optimize)
 	if (!m_parseSuccessful)
 		parse();
 
-	map<ContractDefinition const*, bytes const*> contractBytecode;
+	// A contract can only be compiled once the contracts it (or one of its bases) creates have been.
+	vector<ContractDefinition const*> pending;
+	map<ContractDefinition const*, set<ContractDefinition const*>> dependencies;
 	for (Source const* source: m_sourceOrder)
 		for (ASTPointer<ASTNode> const& node: source->ast->getNodes())
-			if (ContractDefinition* contract = dynamic_cast<ContractDefinition*>(node.get()))
+			if (ContractDefinition const* contract = dynamic_cast<ContractDefinition const*>(node.get()))
 			{
-				shared_ptr<Compiler> compiler = make_shared<Compiler>(_optimize);
-				compiler->compileContract(*contract, contractBytecode);
-				Contract& compiledContract = m_contracts[contract->getName()];
-				compiledContract.bytecode = compiler->getAssembledBytecode();
-				compiledContract.runtimeBytecode = compiler->getRuntimeBytecode();
-				compiledContract.compiler = move(compiler);
-				contractBytecode[compiledContract.contract] = &compiledContract.bytecode;
+				pending.push_back(contract);
+				CreatedContracts created;
+				for (ContractDefinition const* base: contract->getLinearizedBaseContracts())
+					base->accept(created);
+				dependencies[contract] = created.contracts;
 			}
+
+	// Results are kept per definition rather than by name, as two sources may each define a contract of the same
+	// name; the entries are all made up front so that the workers only ever touch their own.
+	struct Compiled
+	{
+		shared_ptr<Compiler> compiler;
+		bytes bytecode;
+		bytes runtimeBytecode;
+	};
+	map<ContractDefinition const*, Compiled> compiled;
+	for (ContractDefinition const* contract: pending)
+		compiled[contract];
+
+	map<ContractDefinition const*, bytes const*> contractBytecode;
+	auto compileContract = [&](ContractDefinition const* _contract)
+	{
+		Compiled& c = compiled.at(_contract);
+		c.compiler = make_shared<Compiler>(_optimize);
+		c.compiler->compileContract(*_contract, contractBytecode);
+		c.bytecode = c.compiler->getAssembledBytecode();
+		c.runtimeBytecode = c.compiler->getRuntimeBytecode();
+	};
+	vector<ContractDefinition const*> inOrder = pending;
+
+	while (!pending.empty())
+	{
+		vector<ContractDefinition const*> ready;
+		vector<ContractDefinition const*> waiting;
+		for (ContractDefinition const* contract: pending)
+		{
+			bool isReady = true;
+			for (ContractDefinition const* created: dependencies[contract])
+				isReady = isReady && contractBytecode.count(created);
+			(isReady ? ready : waiting).push_back(contract);
+		}
+		if (ready.empty())
+		{
+			// Contracts that create each other; compiling the first one fails with a proper error.
+			ready.push_back(waiting.front());
+			waiting.erase(waiting.begin());
+		}
+
+		unsigned threads = min<size_t>(ready.size(), max(thread::hardware_concurrency(), 1U));
+		atomic<unsigned> next(0);
+		vector<exception_ptr> errors(ready.size());
+		auto work = [&]()
+		{
+			for (unsigned i = next++; i < ready.size(); i = next++)
+				try
+				{
+					compileContract(ready[i]);
+				}
+				catch (...)
+				{
+					errors[i] = current_exception();
+				}
+		};
+		vector<thread> workers;
+		for (unsigned i = 1; i < threads; ++i)
+			workers.push_back(thread(work));
+		work();
+		for (thread& worker: workers)
+			worker.join();
+		for (exception_ptr const& error: errors)
+			if (error)
+				rethrow_exception(error);
+
+		for (ContractDefinition const* contract: ready)
+			contractBytecode[contract] = &compiled.at(contract).bytecode;
+		swap(pending, waiting);
+	}
+
+	// As before, of two contracts with the same name, the one that comes later in the sources is the one kept.
+	for (ContractDefinition const* contract: inOrder)
+	{
+		Contract& c = m_contracts.at(contract->getName());
+		Compiled& r = compiled.at(contract);
+		c.compiler = move(r.compiler);
+		c.bytecode = move(r.bytecode);
+		c.runtimeBytecode = move(r.runtimeBytecode);
+	}
 }
 
 bytes const& CompilerStack::compile(string const& _sourceCode, bool _optimize)
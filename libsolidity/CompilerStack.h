@@ -67,6 +67,9 @@ public:
 	void addSources(std::map<std::string, std::string> const& _nameContents, bool _isLibrary = false) { for (auto const& i: _nameContents) addSource(i.first, i.second, _isLibrary); }
 	bool addSource(std::string const& _name, std::string const& _content, bool _isLibrary = false);
 	void setSource(std::string const& _sourceCode);
+	/// Removes all sources (standard sources are added again if they were on construction) and any results.
+	/// The ASTs of sources that are added back unchanged are reused by the next call to parse.
+	void clearSources();
 	/// Parses all source units that were added
 	void parse();
 	/// Sets the given source code as the only source unit apart from standard sources and parses it.
@@ -75,7 +78,8 @@ public:
 	std::vector<std::string> getContractNames() const;
 	std::string defaultContractName() const;
 
-	/// Compiles the source units that were previously added and parsed.
+	/// Compiles the source units that were previously added and parsed. Contracts that do not create
+	/// one another are compiled concurrently.
 	void compile(bool _optimize = false);
 	/// Parses and compiles the given source code.
 	/// @returns the compiled bytecode
@@ -126,6 +130,7 @@ private:
 		std::shared_ptr<SourceUnit> ast;
 		std::string interface;
 		bool isLibrary = false;
+		h256 hash;		///< Hash of the source code.
 		void reset() { scanner.reset(); ast.reset(); interface.clear(); isLibrary = false;}
 	};
 
@@ -153,6 +158,8 @@ private:
 	bool m_addStandardSources; ///< If true, standard sources are added.
 	bool m_parseSuccessful;
 	std::map<std::string const, Source> m_sources;
+	/// Sources as of the last parse, so that unchanged ones need not be parsed again.
+	std::map<std::string const, Source> m_parsedSources;
 	std::shared_ptr<GlobalContext> m_globalContext;
 	std::vector<Source const*> m_sourceOrder;
 	std::map<std::string const, Contract> m_contracts;
@@ -245,6 +245,7 @@ bool DeclarationRegistrationHelper::visit(FunctionDefinition& _function)
 {
 	registerDeclaration(_function, true);
 	m_currentFunction = &_function;
+	m_currentFunction->clearLocalVariables();
 	return true;
 }
 
@@ -258,6 +259,7 @@ bool DeclarationRegistrationHelper::visit(ModifierDefinition& _modifier)
 {
 	registerDeclaration(_modifier, true);
 	m_currentFunction = &_modifier;
+	m_currentFunction->clearLocalVariables();
 	return true;
 }
 
@@ -345,7 +347,10 @@ void ReferencesResolver::endVisit(VariableDeclaration& _variable)
 	}
 	else if (!m_allowLazyTypes)
 		BOOST_THROW_EXCEPTION(_variable.createTypeError("Explicit type needed."));
-	// otherwise we have a "var"-declaration whose type is resolved by the first assignment
+	else
+		// a "var"-declaration whose type is resolved by the first assignment, so forget any type
+		// inferred when this AST was last resolved
+		_variable.setType(TypePointer());
 }
 
 bool ReferencesResolver::visit(Return& _return)
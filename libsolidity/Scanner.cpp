@@ -148,16 +148,128 @@ void Scanner::reset(CharStream const& _source, string const& _sourceName)
 {
 	m_source = _source;
 	m_sourceName = make_shared<string const>(_sourceName);
+	m_tokens.clear();
+	seek(0);
+	do
+		m_tokens.push_back(scanBufferedToken());
+	while (m_tokens.back().token.token != Token::EOS);
 	reset();
 }
 
 void Scanner::reset()
+{
+	m_index = 0;
+	loadTokens();
+}
+
+void Scanner::update(CharStream const& _source)
+{
+	// Scanning a token reads nothing before the end of the previous token and at most two characters past
+	// its own end (a malformed hex escape is rolled back), so all that changes are the tokens from the one
+	// reading the first edited character up to the first one that starts after the edit at the end of an
+	// old token.
+	string const& oldSource = *m_source.getSource();
+	string const& newSource = *_source.getSource();
+	size_t common = min(oldSource.size(), newSource.size());
+	size_t prefix = mismatch(oldSource.begin(), oldSource.begin() + common, newSource.begin()).first - oldSource.begin();
+	size_t suffix = mismatch(oldSource.rbegin(), oldSource.rbegin() + (common - prefix), newSource.rbegin()).first - oldSource.rbegin();
+	int newEditEnd = newSource.size() - suffix;
+	int shift = int(newSource.size()) - int(oldSource.size());
+	// Keep the old source alive while it is compared against.
+	CharStream oldStream = m_source;
+	m_source = _source;
+
+	auto first = upper_bound(m_tokens.begin(), m_tokens.end(), int(prefix), [](int _pos, ScannedToken const& _token)
+	{
+		return _pos < _token.token.end + 2;
+	});
+	seek(first == m_tokens.begin() ? 0 : (first - 1)->token.end);
+	vector<ScannedToken> rescanned;
+	auto resume = m_tokens.end();
+	while (true)
+	{
+		rescanned.push_back(scanBufferedToken());
+		ScannedDesc const& token = rescanned.back().token;
+		if (token.token == Token::EOS)
+			break;
+		if (token.end >= newEditEnd)
+		{
+			auto old = lower_bound(first, m_tokens.end(), token.end - shift, [](ScannedToken const& _token, int _pos)
+			{
+				return _token.token.end < _pos;
+			});
+			if (old != m_tokens.end() && old->token.end == token.end - shift && old->token.token != Token::EOS)
+			{
+				resume = old + 1;
+				break;
+			}
+		}
+	}
+
+	for (auto it = resume; it != m_tokens.end(); ++it)
+		for (ScannedDesc* desc: {&it->token, &it->comment})
+		{
+			desc->start += desc->start < 0 ? 0 : shift;
+			desc->end += desc->end < 0 ? 0 : shift;
+			desc->literalStart += desc->literalStart < 0 ? 0 : shift;
+		}
+	size_t firstIndex = first - m_tokens.begin();
+	m_tokens.erase(first, resume);
+	m_tokens.insert(m_tokens.begin() + firstIndex, make_move_iterator(rescanned.begin()), make_move_iterator(rescanned.end()));
+	reset();
+}
+
+void Scanner::seek(int _pos)
 {
 	m_source.reset();
-	m_char = m_source.get();
-	skipWhitespace();
+	m_char = m_source.advanceAndGet(_pos);
+}
+
+Scanner::ScannedToken Scanner::scanBufferedToken()
+{
 	scanToken();
-	next();
+	return ScannedToken{toScanned(m_nextToken), toScanned(m_nextSkippedComment)};
+}
+
+Scanner::ScannedDesc Scanner::toScanned(TokenDesc const& _desc) const
+{
+	ScannedDesc ret{_desc.token, _desc.location.start, _desc.location.end, -1, 0, string()};
+	if (_desc.literal.empty())
+		return ret;
+	if (_desc.location.start >= 0 && _desc.location.end >= _desc.location.start)
+	{
+		// Any occurrence of the literal within the token will do.
+		string const& source = *m_source.getSource();
+		auto begin = source.begin() + _desc.location.start;
+		auto end = source.begin() + _desc.location.end;
+		auto it = search(begin, end, _desc.literal.begin(), _desc.literal.end());
+		if (it != end)
+		{
+			ret.literalStart = it - source.begin();
+			ret.literalLength = _desc.literal.size();
+			return ret;
+		}
+	}
+	ret.literal = _desc.literal;
+	return ret;
+}
+
+void Scanner::load(ScannedDesc const& _desc, TokenDesc& o_desc) const
+{
+	o_desc.token = _desc.token;
+	o_desc.location.start = _desc.start;
+	o_desc.location.end = _desc.end;
+	if (_desc.literalStart >= 0)
+		o_desc.literal.assign(*m_source.getSource(), _desc.literalStart, _desc.literalLength);
+	else
+		o_desc.literal = _desc.literal;
+}
+
+void Scanner::loadTokens()
+{
+	load(m_tokens[m_index].token, m_currentToken);
+	load(m_tokens[m_index].comment, m_skippedComment);
+	load(m_tokens[min(m_index + 1, m_tokens.size() - 1)].token, m_nextToken);
 }
 
 bool Scanner::scanHexByte(char& o_scannedByte)
@@ -184,10 +296,9 @@ BOOST_STATIC_ASSERT(Token::NUM_TOKENS <= 0x100);
 
 Token::Value Scanner::next()
 {
-	m_currentToken = m_nextToken;
-	m_skippedComment = m_nextSkippedComment;
-	scanToken();
-
+	if (m_index + 1 < m_tokens.size())
+		++m_index;
+	loadTokens();
 	return m_currentToken.token;
 }
 
@@ -380,6 +491,8 @@ Token::Value Scanner::scanSlash()
 void Scanner::scanToken()
 {
 	m_nextToken.literal.clear();
+	m_nextSkippedComment.token = Token::Whitespace;
+	m_nextSkippedComment.location = SourceLocation();
 	m_nextSkippedComment.literal.clear();
 	Token::Value token;
 	do
@@ -722,7 +835,7 @@ char CharStream::advanceAndGet(size_t _chars)
 	m_pos += _chars;
 	if (isPastEndOfInput())
 		return 0;
-	return m_source[m_pos];
+	return (*m_source)[m_pos];
 }
 
 char CharStream::rollback(size_t _amount)
@@ -734,31 +847,33 @@ char CharStream::rollback(size_t _amount)
 
 string CharStream::getLineAtPosition(int _position) const
 {
+	string const& source = *m_source;
 	// if _position points to \n, it returns the line before the \n
 	using size_type = string::size_type;
-	size_type searchStart = min<size_type>(m_source.size(), _position);
+	size_type searchStart = min<size_type>(source.size(), _position);
 	if (searchStart > 0)
 		searchStart--;
-	size_type lineStart = m_source.rfind('\n', searchStart);
+	size_type lineStart = source.rfind('\n', searchStart);
 	if (lineStart == string::npos)
 		lineStart = 0;
 	else
 		lineStart++;
-	return m_source.substr(lineStart, min(m_source.find('\n', lineStart),
-										  m_source.size()) - lineStart);
+	return source.substr(lineStart, min(source.find('\n', lineStart),
+										  source.size()) - lineStart);
 }
 
 tuple<int, int> CharStream::translatePositionToLineColumn(int _position) const
 {
+	string const& source = *m_source;
 	using size_type = string::size_type;
-	size_type searchPosition = min<size_type>(m_source.size(), _position);
-	int lineNumber = count(m_source.begin(), m_source.begin() + searchPosition, '\n');
+	size_type searchPosition = min<size_type>(source.size(), _position);
+	int lineNumber = count(source.begin(), source.begin() + searchPosition, '\n');
 	size_type lineStart;
 	if (searchPosition == 0)
 		lineStart = 0;
 	else
 	{
-		lineStart = m_source.rfind('\n', searchPosition - 1);
+		lineStart = source.rfind('\n', searchPosition - 1);
 		lineStart = lineStart == string::npos ? 0 : lineStart + 1;
 	}
 	return tuple<int, int>(lineNumber, searchPosition - lineStart);
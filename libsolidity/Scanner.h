@@ -68,19 +68,27 @@ class AstRawString;
 class AstValueFactory;
 class ParserRecorder;
 
+/**
+ * Cursor over a source text. The text itself is shared between copies of the stream, it is never copied
+ * once constructed.
+ */
 class CharStream
 {
 public:
-	CharStream(): m_pos(0) {}
-	explicit CharStream(std::string const& _source): m_source(_source), m_pos(0) {}
+	CharStream(): m_source(std::make_shared<std::string const>()), m_pos(0) {}
+	explicit CharStream(std::string const& _source): m_source(std::make_shared<std::string const>(_source)), m_pos(0) {}
+	explicit CharStream(std::string&& _source): m_source(std::make_shared<std::string const>(std::move(_source))), m_pos(0) {}
+	explicit CharStream(std::shared_ptr<std::string const> const& _source): m_source(_source), m_pos(0) {}
 	int getPos() const { return m_pos; }
-	bool isPastEndOfInput(size_t _charsForward = 0) const { return (m_pos + _charsForward) >= m_source.size(); }
-	char get(size_t _charsForward = 0) const { return m_source[m_pos + _charsForward]; }
+	bool isPastEndOfInput(size_t _charsForward = 0) const { return (m_pos + _charsForward) >= m_source->size(); }
+	char get(size_t _charsForward = 0) const { return (*m_source)[m_pos + _charsForward]; }
 	char advanceAndGet(size_t _chars=1);
 	char rollback(size_t _amount);
 
 	void reset() { m_pos = 0; }
 
+	std::shared_ptr<std::string const> const& getSource() const { return m_source; }
+
 	///@{
 	///@name Error printing helper functions
 	/// Functions that help pretty-printing parse errors
@@ -90,12 +98,16 @@ public:
 	///@}
 
 private:
-	std::string m_source;
+	std::shared_ptr<std::string const> m_source;
 	size_t m_pos;
 };
 
 
 
+/**
+ * Splits a source into tokens. The whole source is scanned up front; after an edit, update() re-scans only
+ * the tokens around the edited range and keeps the rest.
+ */
 class Scanner
 {
 	friend class LiteralScope;
@@ -107,6 +119,9 @@ public:
 	void reset(CharStream const& _source, std::string const& _sourceName);
 	/// Resets scanner to the start of input.
 	void reset();
+	/// Replaces the input by @a _source, an edited version of the current input, re-scanning only the tokens
+	/// that the edit can have changed. Resets the scanner to the start of input.
+	void update(CharStream const& _source);
 
 	/// Returns the next token and advances input
 	Token::Value next();
@@ -162,6 +177,34 @@ private:
 		std::string literal;
 	};
 
+	/// A token or comment as kept in m_tokens. Literals that appear verbatim in the source are only
+	/// referenced; the others (strings with escapes, multi-line documentation) are stored.
+	struct ScannedDesc
+	{
+		Token::Value token;
+		int start;
+		int end;
+		int literalStart;		///< Position of the literal in the source, or -1 if it is in @a literal.
+		int literalLength;
+		std::string literal;
+	};
+
+	/// A token together with the documentation comment preceding it.
+	struct ScannedToken
+	{
+		ScannedDesc token;
+		ScannedDesc comment;
+	};
+
+	/// Moves the scanner to @a _pos, which has to be the start of input or the end of a token.
+	void seek(int _pos);
+	/// Scans the next token and @returns it together with its comment in the form kept in m_tokens.
+	ScannedToken scanBufferedToken();
+	ScannedDesc toScanned(TokenDesc const& _desc) const;
+	void load(ScannedDesc const& _desc, TokenDesc& o_desc) const;
+	/// Loads the current token and comment and the look-ahead token from m_tokens.
+	void loadTokens();
+
 	///@{
 	///@name Literal buffer support
 	inline void addLiteralChar(char c) { m_nextToken.literal.push_back(c); }
@@ -216,6 +259,9 @@ private:
 	CharStream m_source;
 	std::shared_ptr<std::string const> m_sourceName;
 
+	std::vector<ScannedToken> m_tokens;	///< All tokens of the source, ending with EOS.
+	size_t m_index = 0;					///< Index of the current token in m_tokens.
+
 	/// one character look-ahead, equals 0 at end of input
 	char m_char;
 };
@@ -35,6 +35,8 @@ namespace dev
 namespace solidity
 {
 
+RecursiveMutex x_lazyMembers;
+
 TypePointer Type::fromElementaryTypeName(Token::Value _typeToken)
 {
 	solAssert(Token::isElementaryTypeName(_typeToken), "Elementary type name expected.");
@@ -618,6 +620,7 @@ string ContractType::toString() const
 
 MemberList const& ContractType::getMembers() const
 {
+	RecursiveGuard l(x_lazyMembers);
 	// We need to lazy-initialize it because of recursive references.
 	if (!m_members)
 	{
@@ -642,6 +645,7 @@ MemberList const& ContractType::getMembers() const
 
 shared_ptr<FunctionType const> const& ContractType::getConstructorType() const
 {
+	RecursiveGuard l(x_lazyMembers);
 	if (!m_constructorType)
 	{
 		FunctionDefinition const* constructor = m_contract.getConstructor();
@@ -701,6 +705,7 @@ string StructType::toString() const
 
 MemberList const& StructType::getMembers() const
 {
+	RecursiveGuard l(x_lazyMembers);
 	// We need to lazy-initialize it because of recursive references.
 	if (!m_members)
 	{
@@ -913,6 +918,8 @@ MemberList const& FunctionType::getMembers() const
 	case Location::SHA256:
 	case Location::RIPEMD160:
 	case Location::Bare:
+	{
+		RecursiveGuard l(x_lazyMembers);
 		if (!m_members)
 		{
 			vector<pair<string, TypePointer>> members{
@@ -927,6 +934,7 @@ MemberList const& FunctionType::getMembers() const
 			m_members.reset(new MemberList(members));
 		}
 		return *m_members;
+	}
 	default:
 		return EmptyMemberList;
 	}
@@ -1014,6 +1022,7 @@ bool TypeType::operator==(Type const& _other) const
 
 MemberList const& TypeType::getMembers() const
 {
+	RecursiveGuard l(x_lazyMembers);
 	// We need to lazy-initialize it because of recursive references.
 	if (!m_members)
 	{
@@ -27,6 +27,7 @@
 #include <map>
 #include <boost/noncopyable.hpp>
 #include <libdevcore/Common.h>
+#include <libdevcore/Guards.h>
 #include <libsolidity/Exceptions.h>
 #include <libsolidity/ASTForward.h>
 #include <libsolidity/Token.h>
@@ -42,6 +43,10 @@ using TypePointer = std::shared_ptr<Type const>;
 using FunctionTypePointer = std::shared_ptr<FunctionType const>;
 using TypePointers = std::vector<TypePointer>;
 
+/// Guards the members of types and AST nodes that are computed on first use, as these are shared between
+/// contracts that CompilerStack compiles concurrently.
+extern RecursiveMutex x_lazyMembers;
+
 /**
  * List of members of a type.
  */
@@ -539,7 +539,10 @@ std::string WebThreeStubServerBase::eth_serpent(std::string const& _code)
 std::string WebThreeStubServerBase::eth_solidity(std::string const& _code)
 {
 	string res;
-	dev::solidity::CompilerStack compiler;
+	Guard l(x_solidity);
+	if (!m_solidity)
+		m_solidity = make_shared<dev::solidity::CompilerStack>();
+	dev::solidity::CompilerStack& compiler = *m_solidity;
 	try
 	{
 		res = toJS(compiler.compile(_code, true));
@@ -26,6 +26,7 @@
 #include <memory>
 #include <iostream>
 #include <jsonrpccpp/server.h>
+#include <libdevcore/Guards.h>
 #include <libdevcrypto/Common.h>
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wunused-parameter"
@@ -47,6 +48,10 @@ namespace shh
 {
 class Interface;
 }
+namespace solidity
+{
+class CompilerStack;
+}
 
 class WebThreeStubDatabaseFace
 {
@@ -147,6 +152,9 @@ protected:
 	std::map<dev::Public, dev::Secret> m_ids;
 	std::map<unsigned, dev::Public> m_shhWatches;
 	std::shared_ptr<dev::AccountHolder> m_accounts;
+
+	Mutex x_solidity;
+	std::shared_ptr<dev::solidity::CompilerStack> m_solidity;	///< Kept between calls so unchanged sources need not be parsed again.
 };
 
 } //namespace dev
@@ -87,7 +87,7 @@ public:
 };
 
 struct WatshhChannel: public dev::LogChannel { static const char* name() { return "shh"; } static const int verbosity = 1; };
-#define cwatshh dev::LogOutputStream<shh::WatshhChannel, true>()
+#define cwatshh LOG_STREAM(shh::WatshhChannel, true)
 
 }
 }
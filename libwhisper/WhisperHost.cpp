@@ -32,7 +32,7 @@ using namespace dev::shh;
 #if defined(clogS)
 #undef clogS
 #endif
-#define clogS(X) dev::LogOutputStream<X, true>(false) << "| " << std::setw(2) << session()->socketId() << "] "
+#define clogS(X) LOG_SESSION_STREAM(X, session()->socketId())
 
 WhisperHost::WhisperHost()
 {
@@ -313,8 +313,11 @@ void ClientModel::showDebuggerForTransaction(ExecutionResult const& _t)
 		data.push_back(QMachineState::getDebugCallData(debugData, d));
 
 	QVariantList states;
-	for (MachineState const& s: _t.machineStates)
-		states.append(QVariant::fromValue(new QMachineState(debugData, s, codes[s.codeIndex], data[s.dataIndex])));
+	for (unsigned i = 0; i < _t.machineStates.size(); ++i)
+	{
+		MachineState const& s = _t.machineStates[i];
+		states.append(QVariant::fromValue(new QMachineState(debugData, s, _t.trace, i, codes[s.codeIndex], data[s.dataIndex])));
+	}
 
 	debugData->setStates(std::move(states));
 
@@ -175,7 +175,10 @@ void CodeModel::runCompilationJob(int _jobId)
 		return; //obsolete job
 
 	ContractMap result;
-	solidity::CompilerStack cs(true);
+	if (!m_compiler)
+		m_compiler.reset(new solidity::CompilerStack(true));
+	solidity::CompilerStack& cs = *m_compiler;
+	cs.clearSources();
 	try
 	{
 		cs.addSource("configUser", R"(contract configUser{function configAddr()constant returns(address a){ return 0xf025d81196b72fba60a1d4dddad12eeb8360d828;}})");
@@ -163,6 +163,7 @@ private:
 	std::map<QString, dev::bytes> m_compiledContracts; //by name
 	dev::Mutex x_pendingContracts;
 	std::map<QString, QString> m_pendingContracts; //name to source
+	std::unique_ptr<solidity::CompilerStack> m_compiler; //used by the background thread only; keeps ASTs of unchanged sources between jobs
 	friend class BackgroundWorker;
 };
 
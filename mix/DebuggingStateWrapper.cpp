@@ -117,7 +117,8 @@ QBigInt* QMachineState::newMemSize()
 QStringList QMachineState::debugStack()
 {
 	QStringList stack;
-	for (std::vector<u256>::reverse_iterator i = m_state.stack.rbegin(); i != m_state.stack.rend(); ++i)
+	u256s s = traceState().stack;
+	for (std::vector<u256>::reverse_iterator i = s.rbegin(); i != s.rend(); ++i)
 		stack.append(QString::fromStdString(prettyU256(*i)));
 	return stack;
 }
@@ -125,7 +126,7 @@ QStringList QMachineState::debugStack()
 QStringList QMachineState::debugStorage()
 {
 	QStringList storage;
-	for (auto const& i: m_state.storage)
+	for (auto const& i: traceState().storage)
 	{
 		std::stringstream s;
 		s << "@" << prettyU256(i.first) << "\t" << prettyU256(i.second);
@@ -136,7 +137,7 @@ QStringList QMachineState::debugStorage()
 
 QVariantList QMachineState::debugMemory()
 {
-	return memDumpToList(m_state.memory, 16);
+	return memDumpToList(traceState().memory, 16);
 }
 
 QCallData* QMachineState::getDebugCallData(QObject* _owner, bytes const& _data)
@@ -166,20 +167,21 @@ QString QMachineState::endOfDebug()
 {
 	if (m_state.gasCost > m_state.gas)
 		return QObject::tr("OUT-OF-GAS");
-	else if (m_state.inst == Instruction::RETURN && m_state.stack.size() >= 2)
+	else if (m_state.inst == Instruction::STOP)
+		return QObject::tr("STOP");
+	dev::eth::TraceState ts = traceState();
+	if (m_state.inst == Instruction::RETURN && ts.stack.size() >= 2)
 	{
-		unsigned from = (unsigned)m_state.stack.back();
-		unsigned size = (unsigned)m_state.stack[m_state.stack.size() - 2];
+		unsigned from = (unsigned)ts.stack.back();
+		unsigned size = (unsigned)ts.stack[ts.stack.size() - 2];
 		unsigned o = 0;
 		bytes out(size, 0);
-		for (; o < size && from + o < m_state.memory.size(); ++o)
-			out[o] = m_state.memory[from + o];
+		for (; o < size && from + o < ts.memory.size(); ++o)
+			out[o] = ts.memory[from + o];
 		return QObject::tr("RETURN") + " " + QString::fromStdString(dev::memDump(out, 16, false));
 	}
-	else if (m_state.inst == Instruction::STOP)
-		return QObject::tr("STOP");
-	else if (m_state.inst == Instruction::SUICIDE && m_state.stack.size() >= 1)
-		return QObject::tr("SUICIDE") + " 0x" + QString::fromStdString(toString(right160(m_state.stack.back())));
+	else if (m_state.inst == Instruction::SUICIDE && ts.stack.size() >= 1)
+		return QObject::tr("SUICIDE") + " 0x" + QString::fromStdString(toString(right160(ts.stack.back())));
 	else
 		return QObject::tr("EXCEPTION");
 }
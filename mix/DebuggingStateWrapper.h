@@ -123,8 +123,8 @@ class QMachineState: public QObject
 	Q_PROPERTY(unsigned dataIndex READ dataIndex CONSTANT)
 
 public:
-	QMachineState(QObject* _owner, MachineState const& _state, QCode* _code, QCallData* _callData):
-		QObject(_owner), m_state(_state), m_code(_code), m_callData(_callData) {}
+	QMachineState(QObject* _owner, MachineState const& _state, std::shared_ptr<dev::eth::ExecutionTrace const> const& _trace, unsigned _traceStep, QCode* _code, QCallData* _callData):
+		QObject(_owner), m_state(_state), m_trace(_trace), m_traceStep(_traceStep), m_code(_code), m_callData(_callData) {}
 	/// Get the step of this machine states.
 	int step() { return  (int)m_state.steps; }
 	/// Get the proccessed code index.
@@ -163,7 +163,12 @@ public:
 	static QCallData* getDebugCallData(QObject* _owner, bytes const& _data);
 
 private:
+	/// @returns the stack, memory and storage at this step, rebuilt from the trace.
+	dev::eth::TraceState traceState() const { return m_trace->state(m_traceStep); }
+
 	MachineState m_state;
+	std::shared_ptr<dev::eth::ExecutionTrace const> m_trace;
+	unsigned m_traceStep;
 	QCode* m_code;
 	QCallData* m_callData;
 };
@@ -25,11 +25,13 @@ along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <vector>
 #include <map>
+#include <memory>
 #include <stdint.h>
 #include <libdevcore/Common.h>
 #include <libdevcrypto/Common.h>
 #include <libevmcore/Instruction.h>
 #include <libethereum/TransactionReceipt.h>
+#include <libethereum/ExecutionTrace.h>
 
 namespace dev
 {
@@ -38,6 +40,7 @@ namespace mix
 
 	/**
 	* @brief Store information about a machine state.
+	* The stack, memory and storage are kept by the ExecutionResult's trace.
 	*/
 	struct MachineState
 	{
@@ -47,10 +50,7 @@ namespace mix
 		dev::eth::Instruction inst;
 		dev::bigint newMemSize;
 		dev::u256 gas;
-		dev::u256s stack;
-		dev::bytes memory;
 		dev::bigint gasCost;
-		std::map<dev::u256, dev::u256> storage;
 		std::vector<unsigned> levels;
 		unsigned codeIndex;
 		unsigned dataIndex;
@@ -64,6 +64,7 @@ namespace mix
 		ExecutionResult(): transactionIndex(std::numeric_limits<unsigned>::max()) {}
 
 		std::vector<MachineState> machineStates;
+		std::shared_ptr<dev::eth::ExecutionTrace const> trace;	///< One step per machine state.
 		std::vector<bytes> transactionData;
 		std::vector<bytes> executionCode;
 		bytes returnValue;
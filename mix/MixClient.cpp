@@ -27,6 +27,7 @@
 #include <libethereum/Executive.h>
 #include <libethereum/ExtVM.h>
 #include <libethereum/BlockChain.h>
+#include <libethereum/ExecutionTrace.h>
 #include <libevm/VM.h>
 
 #include "Exceptions.h"
@@ -97,15 +98,12 @@ void MixClient::executeTransaction(Transaction const& _t, State& _state, bool _c
 	bytes rlp = _t.rlp();
 
 	// do debugging run first
-	LastHashes lastHashes(256);
-	lastHashes[0] = bc().numberHash(bc().number());
-	for (unsigned i = 1; i < 256; ++i)
-		lastHashes[i] = lastHashes[i - 1] ? bc().details(lastHashes[i - 1]).parent : h256();
-
+	auto lastHashes = bc().lastHashes();
 	State execState = _state;
-	Executive execution(execState, lastHashes, 0);
+	Executive execution(execState, *lastHashes, 0);
 	execution.setup(&rlp);
 	std::vector<MachineState> machineStates;
+	auto trace = std::make_shared<ExecutionTrace>();
 	std::vector<unsigned> levels;
 	std::vector<bytes> codes;
 	std::map<bytes const*, unsigned> codeIndexes;
@@ -152,8 +150,9 @@ void MixClient::executeTransaction(Transaction const& _t, State& _state, bool _c
 		else
 			levels.resize(ext.depth);
 
+		trace->record(steps, inst, newMemSize, gasCost, vm, ext);
 		machineStates.emplace_back(MachineState({steps, ext.myAddress, vm.curPC(), inst, newMemSize, vm.gas(),
-									  vm.stack(), vm.memory(), gasCost, ext.state().storage(ext.myAddress), levels, codeIndex, dataIndex}));
+									  gasCost, levels, codeIndex, dataIndex}));
 	};
 
 	execution.go(onOp);
@@ -161,7 +160,8 @@ void MixClient::executeTransaction(Transaction const& _t, State& _state, bool _c
 
 	ExecutionResult d;
 	d.returnValue = execution.out().toVector();
-	d.machineStates = machineStates;
+	d.machineStates = std::move(machineStates);
+	d.trace = trace;
 	d.executionCode = std::move(codes);
 	d.transactionData = std::move(data);
 	d.address = _t.receiveAddress();
@@ -176,7 +176,7 @@ void MixClient::executeTransaction(Transaction const& _t, State& _state, bool _c
 	// execute on a state
 	if (!_call)
 	{
-		_state.execute(lastHashes, rlp, nullptr, true);
+		_state.execute(*lastHashes, rlp, nullptr, true);
 		// collect watches
 		h256Set changed;
 		Guard l(m_filterLock);
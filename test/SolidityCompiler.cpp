@@ -29,6 +29,7 @@
 #include <libsolidity/NameAndTypeResolver.h>
 #include <libsolidity/Compiler.h>
 #include <libsolidity/AST.h>
+#include <libsolidity/CompilerStack.h>
 
 using namespace std;
 using namespace dev::eth;
@@ -186,6 +187,66 @@ BOOST_AUTO_TEST_CASE(loops)
 	checkCodePresentAt(code, expectation, boilerplateSize);
 }
 
+BOOST_AUTO_TEST_CASE(reused_stack_matches_fresh)
+{
+	map<string, string> sources{
+		{"base", "contract Base { function f(uint a) returns (uint) { var b = a * 2; return b + 1; } }"},
+		{"child", "contract Child { uint x; function Child() { x = 7; } }"},
+		{"main", "import \"base\"; import \"child\";\n"
+			"contract Main is Base { function g() returns (uint) { var x = f(3); return x; } function make() returns (address) { return new Child(); } }"}
+	};
+	map<string, string> edited = sources;
+	edited["main"] = "import \"base\"; import \"child\";\n"
+		"contract Main is Base { function g() returns (uint) { var x = f(4); var y = x; return y; } function make() returns (address) { return new Child(); } }";
+
+	auto bytecodes = [](CompilerStack const& _stack)
+	{
+		map<string, bytes> ret;
+		for (string const& name: {"Base", "Child", "Main"})
+			ret[name] = _stack.getBytecode(name);
+		return ret;
+	};
+	auto fresh = [&](map<string, string> const& _sources)
+	{
+		CompilerStack stack(false);
+		stack.addSources(_sources);
+		stack.compile();
+		return bytecodes(stack);
+	};
+	map<string, bytes> original = fresh(sources);
+	map<string, bytes> changed = fresh(edited);
+	BOOST_REQUIRE(original != changed);
+
+	CompilerStack stack(false);
+	stack.addSources(sources);
+	stack.compile();
+	BOOST_CHECK(bytecodes(stack) == original);
+
+	// Nothing changed: every AST is reused.
+	stack.addSources(sources);
+	stack.compile();
+	BOOST_CHECK(bytecodes(stack) == original);
+
+	// One source changed: the others' ASTs are reused, and 'var' types are inferred afresh.
+	stack.addSource("main", edited["main"]);
+	stack.compile();
+	BOOST_CHECK(bytecodes(stack) == changed);
+
+	// And back again.
+	stack.addSource("main", sources["main"]);
+	stack.compile();
+	BOOST_CHECK(bytecodes(stack) == original);
+}
+
+BOOST_AUTO_TEST_CASE(same_contract_name_in_two_sources)
+{
+	// All sources share one global scope, so a second contract of the same name never reaches the compile rounds.
+	CompilerStack stack(false);
+	stack.addSource("a", "contract C { function f() returns (uint) { return 1; } }");
+	stack.addSource("b", "contract C { function f() returns (uint) { return 2; } }");
+	BOOST_CHECK_THROW(stack.compile(), DeclarationError);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }
@@ -264,6 +264,45 @@ BOOST_AUTO_TEST_CASE(ether_subdenominations)
 	BOOST_CHECK_EQUAL(scanner.next(), Token::SubEther);
 }
 
+BOOST_AUTO_TEST_CASE(update_within_token)
+{
+	Scanner scanner(CharStream("var x = 1; var y = 2;"));
+	scanner.update(CharStream("var xyz = 1; var y = 2;"));
+	BOOST_CHECK_EQUAL(scanner.getCurrentToken(), Token::Var);
+	BOOST_CHECK_EQUAL(scanner.next(), Token::Identifier);
+	BOOST_CHECK_EQUAL(scanner.getCurrentLiteral(), "xyz");
+	BOOST_CHECK_EQUAL(scanner.next(), Token::Assign);
+	BOOST_CHECK_EQUAL(scanner.next(), Token::Number);
+	BOOST_CHECK_EQUAL(scanner.next(), Token::Semicolon);
+	BOOST_CHECK_EQUAL(scanner.next(), Token::Var);
+	BOOST_CHECK_EQUAL(scanner.next(), Token::Identifier);
+	BOOST_CHECK_EQUAL(scanner.getCurrentLiteral(), "y");
+	BOOST_CHECK_EQUAL(scanner.getCurrentLocation().start, 17);
+	BOOST_CHECK_EQUAL(scanner.getCurrentLocation().end, 18);
+	BOOST_CHECK_EQUAL(scanner.next(), Token::Assign);
+	BOOST_CHECK_EQUAL(scanner.next(), Token::Number);
+	BOOST_CHECK_EQUAL(scanner.getCurrentLiteral(), "2");
+	BOOST_CHECK_EQUAL(scanner.next(), Token::Semicolon);
+	BOOST_CHECK_EQUAL(scanner.next(), Token::EOS);
+}
+
+BOOST_AUTO_TEST_CASE(update_opening_comment)
+{
+	Scanner scanner(CharStream("a b \"c\\x61\" d"));
+	scanner.update(CharStream("a /* b \"c\\x61\" d"));
+	BOOST_CHECK_EQUAL(scanner.getCurrentToken(), Token::Identifier);
+	BOOST_CHECK_EQUAL(scanner.next(), Token::Illegal);
+	BOOST_CHECK_EQUAL(scanner.next(), Token::EOS);
+	scanner.update(CharStream("a /** b */ \"c\\x61\" d"));
+	BOOST_CHECK_EQUAL(scanner.getCurrentToken(), Token::Identifier);
+	BOOST_CHECK_EQUAL(scanner.next(), Token::StringLiteral);
+	BOOST_CHECK_EQUAL(scanner.getCurrentLiteral(), "ca");
+	BOOST_CHECK_EQUAL(scanner.getCurrentCommentLiteral(), "b ");
+	BOOST_CHECK_EQUAL(scanner.next(), Token::Identifier);
+	BOOST_CHECK_EQUAL(scanner.getCurrentLiteral(), "d");
+	BOOST_CHECK_EQUAL(scanner.next(), Token::EOS);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }
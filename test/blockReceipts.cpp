@@ -0,0 +1,187 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file blockReceipts.cpp
+ * @date 2015
+ * Tests of the stored form of a block's receipts.
+ */
+
+#include <stdexcept>
+#include <boost/test/unit_test.hpp>
+#include <libdevcrypto/SHA3.h>
+#include <libethereum/BlockDetails.h>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+
+namespace
+{
+
+/// Three receipts: one with no logs, and two whose logs share some addresses and topics.
+TransactionReceipts sampleReceipts()
+{
+	Address a1 = Address(sha3("a1"));
+	Address a2 = Address(sha3("a2"));
+	h256 t1 = sha3("t1");
+	h256 t2 = sha3("t2");
+	h256 t3 = sha3("t3");
+
+	TransactionReceipts ret;
+	ret.push_back(TransactionReceipt(sha3("root0"), 21000, LogEntries()));
+	LogEntries l1;
+	l1.push_back(LogEntry(a1, h256s{t1, t2}, bytes{1, 2, 3}));
+	l1.push_back(LogEntry(a2, h256s(), bytes()));
+	ret.push_back(TransactionReceipt(sha3("root1"), 50000, l1));
+	LogEntries l2;
+	l2.push_back(LogEntry(a2, h256s{t2, t3, t1}, bytes(100, 0xff)));
+	l2.push_back(LogEntry(a1, h256s{t1}, bytes{4}));
+	ret.push_back(TransactionReceipt(sha3("root2"), 123456, l2));
+	return ret;
+}
+
+/// The plain list of receipts stored before the columnar format.
+bytes legacyRLP(TransactionReceipts const& _rs)
+{
+	RLPStream s(_rs.size());
+	for (auto const& r: _rs)
+		s.appendRaw(r.rlp());
+	return s.out();
+}
+
+void checkSame(TransactionReceipts const& _a, TransactionReceipts const& _b)
+{
+	BOOST_REQUIRE_EQUAL(_a.size(), _b.size());
+	for (unsigned i = 0; i < _a.size(); ++i)
+	{
+		// The RLP of a receipt includes its bloom, so this checks that it was recomputed properly too.
+		BOOST_CHECK(_a[i].rlp() == _b[i].rlp());
+		BOOST_CHECK(_a[i].bloom() == _b[i].bloom());
+	}
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(BlockReceiptsTests)
+
+BOOST_AUTO_TEST_CASE(roundTrip)
+{
+	BlockReceipts br;
+	br.receipts = sampleReceipts();
+	bytes b = br.rlp();
+
+	BlockReceipts back{RLP(b)};
+	checkSame(back.receipts, br.receipts);
+	BOOST_CHECK(back.rlp() == b);
+
+	// The dictionaries mean the columnar form is smaller than the plain list.
+	BOOST_CHECK_LT(b.size(), legacyRLP(br.receipts).size());
+}
+
+BOOST_AUTO_TEST_CASE(legacyFormat)
+{
+	TransactionReceipts rs = sampleReceipts();
+	bytes b = legacyRLP(rs);
+
+	BlockReceipts br{RLP(b)};
+	checkSame(br.receipts, rs);
+
+	RLP r(b);
+	for (unsigned i = 0; i < rs.size(); ++i)
+	{
+		BOOST_CHECK(BlockReceipts::receipt(r, i).rlp() == rs[i].rlp());
+		for (unsigned j = 0; j < rs[i].log().size(); ++j)
+		{
+			RLPStream expected;
+			rs[i].log()[j].streamRLP(expected);
+			RLPStream got;
+			BlockReceipts::log(r, i, j).streamRLP(got);
+			BOOST_CHECK(got.out() == expected.out());
+		}
+	}
+
+	// Re-encoding it gives the columnar form.
+	bytes c = br.rlp();
+	BOOST_CHECK(BlockReceipts(RLP(c)).rlp() == c);
+}
+
+BOOST_AUTO_TEST_CASE(randomAccess)
+{
+	BlockReceipts br;
+	br.receipts = sampleReceipts();
+	bytes b = br.rlp();
+	RLP r(b);
+
+	for (unsigned i = 0; i < br.receipts.size(); ++i)
+	{
+		TransactionReceipt const& expected = br.receipts[i];
+		BOOST_CHECK(BlockReceipts::receipt(r, i).rlp() == expected.rlp());
+		for (unsigned j = 0; j < expected.log().size(); ++j)
+		{
+			LogEntry got = BlockReceipts::log(r, i, j);
+			LogEntry const& want = expected.log()[j];
+			BOOST_CHECK(got.address == want.address);
+			BOOST_CHECK(got.topics == want.topics);
+			BOOST_CHECK(got.data == want.data);
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(emptyBlock)
+{
+	BlockReceipts br;
+	bytes b = br.rlp();
+	BlockReceipts back{RLP(b)};
+	BOOST_CHECK(back.receipts.empty());
+	BOOST_CHECK(back.rlp() == b);
+
+	bytes l = legacyRLP(TransactionReceipts());
+	BlockReceipts legacy{RLP(l)};
+	BOOST_CHECK(legacy.receipts.empty());
+
+	BOOST_CHECK_THROW(BlockReceipts::receipt(RLP(b), 0), std::out_of_range);
+	BOOST_CHECK_THROW(BlockReceipts::log(RLP(b), 0, 0), std::out_of_range);
+}
+
+BOOST_AUTO_TEST_CASE(outOfRange)
+{
+	TransactionReceipts rs = sampleReceipts();
+	BlockReceipts br;
+	br.receipts = rs;
+	bytes columnar = br.rlp();
+	bytes legacy = legacyRLP(rs);
+
+	for (bytes const* b: {&columnar, &legacy})
+	{
+		RLP r(*b);
+		BOOST_CHECK_THROW(BlockReceipts::receipt(r, rs.size()), std::out_of_range);
+		BOOST_CHECK_THROW(BlockReceipts::log(r, rs.size(), 0), std::out_of_range);
+		// Receipt 0 has no logs; receipt 1 has two.
+		BOOST_CHECK_THROW(BlockReceipts::log(r, 0, 0), std::out_of_range);
+		BOOST_CHECK_THROW(BlockReceipts::log(r, 1, 2), std::out_of_range);
+		BOOST_CHECK_NO_THROW(BlockReceipts::log(r, 1, 1));
+	}
+}
+
+BOOST_AUTO_TEST_CASE(memoryUsage)
+{
+	BlockReceipts br;
+	br.receipts = sampleReceipts();
+	// Each decoded receipt carries its bloom, so it's bigger than its stored form.
+	BOOST_CHECK_GT(br.memoryUsage(), br.rlp().size());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -21,6 +21,7 @@
  */
 
 #include <random>
+#include <thread>
 #include <secp256k1/secp256k1.h>
 #include <libdevcore/Common.h>
 #include <libdevcore/RLP.h>
@@ -228,6 +229,33 @@ BOOST_AUTO_TEST_CASE(cryptopp_ecdsa_sipaseckp256k1)
 	}
 }
 
+BOOST_AUTO_TEST_CASE(cryptopp_concurrent_sign_recover)
+{
+	vector<thread> threads;
+	vector<unsigned> failures(4, 0);
+	for (unsigned t = 0; t < failures.size(); ++t)
+		threads.push_back(thread([t, &failures]()
+		{
+			for (unsigned i = 0; i < 50; ++i)
+			{
+				KeyPair k = KeyPair::create();
+				h256 hm = sha3(toString(t) + ":" + toString(i));
+				Signature sig = s_secp256k1.sign(k.sec(), hm);
+				if (s_secp256k1.recover(sig, hm.ref()) != k.pub())
+					++failures[t];
+				bytes b = asBytes(toString(i));
+				s_secp256k1.encrypt(k.pub(), b);
+				s_secp256k1.decrypt(k.sec(), b);
+				if (b != asBytes(toString(i)))
+					++failures[t];
+			}
+		}));
+	for (auto& t: threads)
+		t.join();
+	for (unsigned f: failures)
+		BOOST_REQUIRE_EQUAL(f, 0);
+}
+
 BOOST_AUTO_TEST_CASE(ecies_eckeypair)
 {
 	KeyPair k = KeyPair::create();
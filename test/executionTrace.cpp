@@ -0,0 +1,166 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file executionTrace.cpp
+ * @date 2015
+ * ExecutionTrace tests: the state rebuilt from the deltas must match a full copy taken at every step.
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <libevm/VM.h>
+#include <libethereum/State.h>
+#include <libethereum/Executive.h>
+#include <libethereum/ExtVM.h>
+#include <libethereum/ExecutionTrace.h>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+
+namespace
+{
+
+class Code
+{
+public:
+	Code& operator<<(Instruction _i) { m_code.push_back((byte)_i); return *this; }
+	Code& push(u256 _v, unsigned _bytes = 1)
+	{
+		m_code.push_back((byte)Instruction::PUSH1 + _bytes - 1);
+		for (unsigned i = _bytes; i > 0; --i)
+			m_code.push_back((byte)(_v >> (8 * (i - 1))));
+		return *this;
+	}
+	Code& raw(byte _b) { m_code.push_back(_b); return *this; }
+	/// CALL @a _to with the input [_inOff, _inOff + _inSize) and the output written to [0, 32).
+	Code& call(Address const& _to, u256 _gas, unsigned _inOff = 0, unsigned _inSize = 0)
+	{
+		push(32).push(0).push(_inSize).push(_inOff).push(0).push((u160)_to, 20).push(_gas, 3);
+		return *this << Instruction::CALL;
+	}
+	unsigned size() const { return m_code.size(); }
+	bytes const& code() const { return m_code; }
+
+private:
+	bytes m_code;
+};
+
+/// Init code that returns @a _runtime.
+bytes deployer(bytes const& _runtime)
+{
+	Code c;
+	c.push(_runtime.size()).push(12).push(0) << Instruction::CODECOPY;
+	c.push(_runtime.size()).push(0) << Instruction::RETURN;
+	bytes ret = c.code();
+	ret += _runtime;
+	return ret;
+}
+
+Address create(State& _s, Address const& _sender, bytes const& _init, OnOpFunc const& _onOp = OnOpFunc())
+{
+	_s.noteSending(_sender);
+	Executive e(_s, LastHashes(), 0);
+	if (!e.create(_sender, 0, 0, 10000000, &_init, _sender))
+		e.go(_onOp);
+	BOOST_REQUIRE(!e.excepted());
+	return e.newAddress();
+}
+
+struct Snapshot
+{
+	Address address;
+	unsigned depth;
+	u256s stack;
+	bytes memory;
+	map<u256, u256> storage;
+};
+
+}
+
+BOOST_AUTO_TEST_SUITE(ExecutionTraceTests)
+
+BOOST_AUTO_TEST_CASE(reconstruction)
+{
+	// B stores twice to the same slot and returns 0x99.
+	Code b;
+	b.push(0x2a).push(5) << Instruction::SSTORE;
+	b.push(7).push(5) << Instruction::SSTORE;
+	b.push(0x99).push(0) << Instruction::MSTORE;
+	b.push(32).push(0) << Instruction::RETURN;
+
+	// C stores, then fails unless given some call data; its store must then be undone.
+	Code c;
+	c.push(1).push(9) << Instruction::SSTORE << Instruction::CALLDATASIZE;
+	c.push(10) << Instruction::JUMPI;
+	c.raw(0xfe) << Instruction::JUMPDEST << Instruction::STOP;
+
+	for (unsigned interval: {1u, 2u, 3u, 5u, 64u})
+	{
+		State s(Address(), OverlayDB(), BaseState::Empty);
+		Address sender(0x1234);
+		Address bAddress = create(s, sender, deployer(b.code()));
+		Address cAddress = create(s, sender, deployer(c.code()));
+
+		// A (run as init code) stores, writes memory in a loop, calls B and C, stores what it got back, and
+		// deletes a slot.
+		Code a;
+		a.push(0x11).push(1) << Instruction::SSTORE;
+		a.push(0xaa).push(0x40) << Instruction::MSTORE;
+		a.push(5);
+		unsigned loop = a.size();
+		a << Instruction::JUMPDEST << Instruction::DUP1 << Instruction::DUP1 << Instruction::MSTORE8;
+		a.push(1) << Instruction::SWAP1 << Instruction::SUB << Instruction::DUP1;
+		a.push(loop) << Instruction::JUMPI << Instruction::POP;
+		a.call(bAddress, 100000) << Instruction::POP;
+		a.push(0) << Instruction::MLOAD;
+		a.push(2) << Instruction::SSTORE;
+		a.push(0).push(1) << Instruction::SSTORE;
+		a.call(cAddress, 100000) << Instruction::POP;
+		a.call(cAddress, 100000, 0x40, 1) << Instruction::POP;
+		a.call(bAddress, 100000) << Instruction::POP;
+		a << Instruction::STOP;
+
+		ExecutionTrace trace(interval);
+		vector<Snapshot> snapshots;
+		create(s, sender, a.code(), [&](uint64_t _steps, Instruction _inst, bigint _newMemSize, bigint _gasCost, VM* _vm, ExtVMFace const* _ext)
+		{
+			ExtVM const& ext = *static_cast<ExtVM const*>(_ext);
+			trace.record(_steps, _inst, _newMemSize, _gasCost, *_vm, ext);
+			snapshots.push_back(Snapshot{ext.myAddress, ext.depth, _vm->stack(), _vm->memory().toBytes(), ext.state().storage(ext.myAddress)});
+		});
+
+		BOOST_REQUIRE_EQUAL(trace.size(), snapshots.size());
+		unsigned maxDepth = 0;
+		for (unsigned i = 0; i < trace.size(); ++i)
+		{
+			Snapshot const& expected = snapshots[i];
+			TraceState got = trace.state(i);
+			BOOST_CHECK(trace.step(i).address == expected.address);
+			BOOST_CHECK_EQUAL(trace.step(i).depth, expected.depth);
+			BOOST_CHECK_MESSAGE(got.stack == expected.stack, "stack differs at step " << i << " with checkpoints every " << interval);
+			BOOST_CHECK_MESSAGE(got.memory == expected.memory, "memory differs at step " << i << " with checkpoints every " << interval);
+			BOOST_CHECK_MESSAGE(got.storage == expected.storage, "storage differs at step " << i << " with checkpoints every " << interval);
+			maxDepth = max(maxDepth, expected.depth);
+		}
+		BOOST_CHECK_EQUAL(maxDepth, 1u);
+
+		// B's and C's final storage, as followed through the trace.
+		BOOST_CHECK(trace.storage(bAddress) == s.storage(bAddress));
+		BOOST_CHECK(trace.storage(cAddress) == s.storage(cAddress));
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,236 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file flatHash.cpp
+ * @date 2015
+ * FlatHashMap and FlatHashSet tests, checked against the standard containers.
+ */
+
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <set>
+#include <random>
+#include <unordered_map>
+#include <boost/test/unit_test.hpp>
+#include <libdevcore/Log.h>
+#include <libdevcore/FixedHash.h>
+#include <libdevcore/FlatHash.h>
+
+using namespace std;
+using namespace dev;
+
+namespace
+{
+
+/// Keys that often share a slot: only a few distinct values in the word the hash starts from.
+h256s collidingKeys(mt19937& _g, unsigned _n)
+{
+	h256s ret;
+	for (unsigned i = 0; i < _n; ++i)
+	{
+		h256 k;
+		for (auto& b: k.asArray())
+			b = (byte)_g();
+		for (unsigned j = 0; j < 24; ++j)
+			k[j] = 0;
+		k[24] = _g() % 4;
+		ret.push_back(k);
+	}
+	return ret;
+}
+
+/// Insert all of @a _keys, look them all up twice, then erase them all.
+template <class C> void exercise(C& _c, h256s const& _keys)
+{
+	size_t found = 0;
+	for (auto const& k: _keys)
+		_c[k] = 1;
+	for (unsigned r = 0; r < 2; ++r)
+		for (auto const& k: _keys)
+			found += _c.count(k);
+	for (auto const& k: _keys)
+		_c.erase(k);
+	BOOST_REQUIRE_EQUAL(found, _keys.size() * 2);
+}
+
+template <class F> unsigned long long timeMs(F _f)
+{
+	auto start = chrono::steady_clock::now();
+	_f();
+	return chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(FlatHashTests)
+
+BOOST_AUTO_TEST_CASE(flatHashMapMatchesMap)
+{
+	mt19937 g(1);
+	for (unsigned round = 0; round < 50; ++round)
+	{
+		h256s keys = collidingKeys(g, 1 + g() % 300);
+		FlatHashMap<h256, string> f;
+		map<h256, string> m;
+		for (unsigned op = 0; op < 3000; ++op)
+		{
+			h256 const& k = keys[g() % keys.size()];
+			switch (g() % 4)
+			{
+			case 0:
+			case 1:
+				f[k] = toString(op);
+				m[k] = toString(op);
+				break;
+			case 2:
+				BOOST_REQUIRE_EQUAL(f.erase(k), m.erase(k));
+				break;
+			case 3:
+			{
+				auto it = f.find(k);
+				BOOST_REQUIRE_EQUAL(it != f.end(), m.count(k) == 1);
+				if (it != f.end())
+				{
+					BOOST_REQUIRE_EQUAL(it->second, m.at(k));
+					f.erase(it);
+					m.erase(k);
+				}
+				break;
+			}
+			}
+			BOOST_REQUIRE_EQUAL(f.size(), m.size());
+		}
+		BOOST_REQUIRE((map<h256, string>(f.begin(), f.end()) == m));
+	}
+}
+
+BOOST_AUTO_TEST_CASE(flatHashSetMatchesSet)
+{
+	mt19937 g(2);
+	h256s keys = collidingKeys(g, 500);
+	FlatHashSet<h160> f;
+	set<h160> s;
+	for (unsigned op = 0; op < 20000; ++op)
+	{
+		h160 k = right160(keys[g() % keys.size()]);
+		if (g() % 3)
+			BOOST_REQUIRE_EQUAL(f.insert(k).second, s.insert(k).second);
+		else
+			BOOST_REQUIRE_EQUAL(f.erase(k), s.erase(k));
+		BOOST_REQUIRE_EQUAL(f.count(k), s.count(k));
+	}
+	BOOST_REQUIRE((set<h160>(f.begin(), f.end()) == s));
+}
+
+BOOST_AUTO_TEST_CASE(flatHashCopyAndMove)
+{
+	FlatHashMap<h256, unsigned> f;
+	for (unsigned i = 0; i < 100; ++i)
+		f[h256(i)] = i;
+	FlatHashMap<h256, unsigned> c = f;
+	BOOST_CHECK(c == f);
+	FlatHashMap<h256, unsigned> m = move(c);
+	BOOST_CHECK(m == f);
+	BOOST_CHECK(c.empty());
+	BOOST_CHECK(!c.count(h256(1)));
+	BOOST_CHECK_EQUAL(m.at(h256(42)), 42);
+	BOOST_CHECK_THROW(m.at(h256(100)), out_of_range);
+}
+
+BOOST_AUTO_TEST_CASE(flatHashClearKeepsTable)
+{
+	FlatHashMap<h256, string> f;
+	for (unsigned i = 0; i < 1000; ++i)
+		f[h256(i)] = toString(i);
+	size_t buckets = f.bucket_count();
+
+	// clear() empties the table but leaves it allocated for the next fill.
+	f.clear();
+	BOOST_CHECK(f.empty());
+	BOOST_CHECK(f.begin() == f.end());
+	BOOST_CHECK(!f.count(h256(1)));
+	BOOST_CHECK_EQUAL(f.bucket_count(), buckets);
+	for (unsigned i = 0; i < 1000; ++i)
+		f[h256(i)] = toString(i);
+	BOOST_CHECK_EQUAL(f.bucket_count(), buckets);
+	BOOST_CHECK_EQUAL(f.at(h256(999)), "999");
+
+	// Only shrink_to_fit() gives it back.
+	for (unsigned i = 10; i < 1000; ++i)
+		f.erase(h256(i));
+	f.shrink_to_fit();
+	BOOST_CHECK_LT(f.bucket_count(), buckets);
+	BOOST_CHECK_EQUAL(f.size(), 10u);
+	for (unsigned i = 0; i < 10; ++i)
+		BOOST_CHECK_EQUAL(f.at(h256(i)), toString(i));
+	f.clear();
+	f.shrink_to_fit();
+	BOOST_CHECK_EQUAL(f.bucket_count(), 0u);
+	f[h256(1)] = "1";
+	BOOST_CHECK_EQUAL(f.size(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(flatHashGroundKeys)
+{
+	// Keys a peer could grind cheaply: their hash's words fold to the same low 24 bits.
+	mt19937 g(1);
+	h256s ground;
+	h256s random;
+	for (unsigned i = 0; i < 50000; ++i)
+	{
+		h256 k;
+		for (auto& b: k.asArray())
+			b = (byte)g();
+		random.push_back(k);
+		uint64_t w[4];
+		memcpy(w, k.data(), 32);
+		w[3] = w[0] ^ w[1] ^ w[2] ^ (w[3] & ~uint64_t(0xffffff));
+		memcpy(k.data(), w, 32);
+		ground.push_back(k);
+	}
+
+	// Were the slot taken straight from the fold, these would all share a run, making this quadratic.
+	FlatHashMap<h256, unsigned> f;
+	auto groundMs = timeMs([&]{ exercise(f, ground); });
+	auto randomMs = timeMs([&]{ exercise(f, random); });
+	BOOST_CHECK_LT(groundMs, randomMs * 20 + 200);
+}
+
+BOOST_AUTO_TEST_CASE(flatHashPerformance)
+{
+	bool run = false;
+	for (int i = 1; i < boost::unit_test::framework::master_test_suite().argc; ++i)
+	{
+		string arg = boost::unit_test::framework::master_test_suite().argv[i];
+		run = run || arg == "--performance" || arg == "--all";
+	}
+	if (!run)
+		return;
+
+	h256s keys;
+	for (unsigned i = 0; i < 1000000; ++i)
+		keys.push_back(h256::random());
+
+	map<h256, unsigned> m;
+	unordered_map<h256, unsigned> u;
+	FlatHashMap<h256, unsigned> f;
+	cnote << "std::map:" << timeMs([&]{ exercise(m, keys); }) << "ms";
+	cnote << "std::unordered_map:" << timeMs([&]{ exercise(u, keys); }) << "ms";
+	cnote << "FlatHashMap:" << timeMs([&]{ exercise(f, keys); }) << "ms";
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,74 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file logFilter.cpp
+ * @date 2015
+ * LogFilter and LogFilterIndex test functions.
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <libethereum/LogFilter.h>
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+
+BOOST_AUTO_TEST_SUITE(LogFilterTests)
+
+BOOST_AUTO_TEST_CASE(lfBloomAndEntry)
+{
+	Address a = Address::random();
+	h256 t0 = h256::random();
+	LogFilter f = LogFilter().address(a).topic(0, t0);
+
+	LogEntry hit(a, h256s{t0}, bytes());
+	LogEntry wrongTopic(a, h256s{h256::random()}, bytes());
+	LogEntry noTopics(a, h256s(), bytes());
+
+	BOOST_CHECK(f.matches(hit.bloom()));
+	BOOST_CHECK(!f.matches(LogEntry(Address::random(), h256s(), bytes()).bloom()));
+	BOOST_CHECK(f.matches(hit));
+	BOOST_CHECK(!f.matches(wrongTopic));
+	BOOST_CHECK(!f.matches(noTopics));
+}
+
+BOOST_AUTO_TEST_CASE(lfIndexCandidates)
+{
+	Address a = Address::random();
+	h256 t = h256::random();
+	LogFilter byAddress = LogFilter().address(a);
+	LogFilter byTopic = LogFilter().topic(1, t);
+	LogFilter everything;
+
+	LogFilterIndex index;
+	index.insert(byAddress.sha3(), byAddress);
+	index.insert(byTopic.sha3(), byTopic);
+	index.insert(everything.sha3(), everything);
+
+	h256Set c;
+	index.candidates(LogEntry(Address::random(), h256s(), bytes()), c);
+	BOOST_CHECK(c == h256Set{everything.sha3()});
+
+	c.clear();
+	index.candidates(LogEntry(a, h256s{h256(), t}, bytes()), c);
+	BOOST_CHECK(c == (h256Set{byAddress.sha3(), byTopic.sha3(), everything.sha3()}));
+
+	index.erase(byAddress.sha3(), byAddress);
+	c.clear();
+	index.candidates(LogEntry(a, h256s(), bytes()), c);
+	BOOST_CHECK(c == h256Set{everything.sha3()});
+}
+
+BOOST_AUTO_TEST_SUITE_END()
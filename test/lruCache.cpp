@@ -0,0 +1,150 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file lruCache.cpp
+ * @date 2015
+ * LruCache tests.
+ */
+
+#include <string>
+#include <boost/test/unit_test.hpp>
+#include <libdevcore/LruCache.h>
+#include <libdevcore/FixedHash.h>
+
+using namespace std;
+using namespace dev;
+
+namespace
+{
+/// A single shard, so that eviction order is entirely down to recency.
+using Cache = LruCache<unsigned, string, std::hash<unsigned>, 1>;
+}
+
+BOOST_AUTO_TEST_SUITE(LruCacheTests)
+
+BOOST_AUTO_TEST_CASE(byteBudget)
+{
+	Cache c(100);
+	for (unsigned i = 0; i < 10; ++i)
+		c.insert(i, to_string(i), 10);
+	for (unsigned i = 0; i < 10; ++i)
+		BOOST_CHECK(c.contains(i));
+
+	c.insert(10, "10", 10);
+	BOOST_CHECK(!c.contains(0));
+	BOOST_CHECK(c.contains(10));
+
+	// One big value displaces as many small ones as it needs to.
+	c.insert(11, "11", 35);
+	BOOST_CHECK(!c.contains(1));
+	BOOST_CHECK(!c.contains(2));
+	BOOST_CHECK(!c.contains(3));
+	BOOST_CHECK(!c.contains(4));
+	BOOST_CHECK(c.contains(5));
+
+	// Replacing a value recharges it.
+	c.insert(11, "11", 5);
+	BOOST_CHECK_EQUAL(c.stats().bytes, 65u);
+
+	c.setBudget(50);
+	BOOST_CHECK_LE(c.stats().bytes, 50u);
+	BOOST_CHECK(c.contains(11));
+	BOOST_CHECK(!c.contains(5));
+}
+
+BOOST_AUTO_TEST_CASE(lruOrder)
+{
+	Cache c(30);
+	c.insert(1, "a", 10);
+	c.insert(2, "b", 10);
+	c.insert(3, "c", 10);
+
+	// Looking 1 up makes 2 the least recently used; contains() doesn't count as a use.
+	string v;
+	BOOST_CHECK(c.get(1, v));
+	BOOST_CHECK_EQUAL(v, "a");
+	BOOST_CHECK(c.contains(2));
+	c.insert(4, "d", 10);
+	BOOST_CHECK(c.contains(1));
+	BOOST_CHECK(!c.contains(2));
+	BOOST_CHECK(c.contains(3));
+
+	c.erase(3);
+	c.insert(5, "e", 10);
+	BOOST_CHECK(c.contains(1));
+	BOOST_CHECK(c.contains(4));
+	BOOST_CHECK(c.contains(5));
+}
+
+BOOST_AUTO_TEST_CASE(stats)
+{
+	Cache c(20);
+	string v;
+	c.insert(1, "a", 10);
+	c.insert(2, "b", 10);
+	BOOST_CHECK(c.get(1, v));
+	BOOST_CHECK(c.get(1, v));
+	BOOST_CHECK(!c.get(3, v));
+	c.insert(3, "c", 10);
+
+	CacheStats s = c.stats();
+	BOOST_CHECK_EQUAL(s.hits, 2u);
+	BOOST_CHECK_EQUAL(s.misses, 1u);
+	BOOST_CHECK_EQUAL(s.evictions, 1u);
+	BOOST_CHECK_EQUAL(s.entries, 2u);
+	BOOST_CHECK_EQUAL(s.bytes, 20u);
+	BOOST_CHECK_EQUAL(s.budget, 20u);
+
+	c.clear();
+	s = c.stats();
+	BOOST_CHECK_EQUAL(s.entries, 0u);
+	BOOST_CHECK_EQUAL(s.bytes, 0u);
+}
+
+BOOST_AUTO_TEST_CASE(oversizedEntry)
+{
+	Cache c(100);
+	for (unsigned i = 0; i < 5; ++i)
+		c.insert(i, to_string(i), 10);
+
+	// Too big for the shard: not cached, and nothing else is evicted for it.
+	c.insert(5, "5", 101);
+	BOOST_CHECK(!c.contains(5));
+	for (unsigned i = 0; i < 5; ++i)
+		BOOST_CHECK(c.contains(i));
+	BOOST_CHECK_EQUAL(c.stats().evictions, 0u);
+
+	// A key whose new value is too big loses its old one rather than keeping it stale.
+	c.insert(0, "0", 200);
+	BOOST_CHECK(!c.contains(0));
+	BOOST_CHECK_EQUAL(c.stats().bytes, 40u);
+}
+
+BOOST_AUTO_TEST_CASE(sharded)
+{
+	LruCache<h256, unsigned, h256::hash> c(16 * 1024);
+	h256s keys;
+	for (unsigned i = 0; i < 1000; ++i)
+		keys.push_back(h256::random());
+	for (unsigned i = 0; i < keys.size(); ++i)
+		c.insert(keys[i], i, 1);
+	unsigned v;
+	for (unsigned i = 0; i < keys.size(); ++i)
+		BOOST_CHECK(c.get(keys[i], v) && v == i);
+	BOOST_CHECK_EQUAL(c.stats().entries, keys.size());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
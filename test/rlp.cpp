@@ -196,5 +196,19 @@ BOOST_AUTO_TEST_CASE(rlp_decoding_test)
 	}
 }
 
+BOOST_AUTO_TEST_CASE(rlp_list_prefix_test)
+{
+	cnote << "Testing RLP list prefixes...";
+	for (unsigned size: {0u, 1u, 55u, 56u, 300u, 70000u})
+	{
+		bytes payload = RLPStream().append(bytes(size, 0x42)).out();
+		RLPStream whole;
+		whole.appendList(payload);
+		RLPStream split;
+		split.appendListPrefix(payload.size()).appendRaw(payload);
+		BOOST_CHECK(whole.out() == split.out());
+	}
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
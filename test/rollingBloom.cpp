@@ -0,0 +1,123 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file rollingBloom.cpp
+ * @date 2015
+ * RollingBloom tests.
+ */
+
+#include <random>
+#include <boost/test/unit_test.hpp>
+#include <libdevcore/RollingBloom.h>
+
+using namespace std;
+using namespace dev;
+
+namespace
+{
+
+h256s randomHashes(mt19937_64& _g, unsigned _n)
+{
+	h256s ret;
+	for (unsigned i = 0; i < _n; ++i)
+		ret.push_back(h256::random(_g));
+	return ret;
+}
+
+unsigned countContained(RollingBloom const& _b, h256s const& _hs)
+{
+	unsigned ret = 0;
+	for (auto const& h: _hs)
+		ret += _b.contains(h) ? 1 : 0;
+	return ret;
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(RollingBloomTests)
+
+BOOST_AUTO_TEST_CASE(insertContains)
+{
+	mt19937_64 g(42);
+	h256s in = randomHashes(g, 1000);
+	h256s out = randomHashes(g, 1000);
+
+	RollingBloom b(1000);
+	for (auto const& h: in)
+		b.insert(h);
+
+	BOOST_CHECK_EQUAL(countContained(b, in), in.size());
+	// Around 1% false positives at capacity; allow some slack.
+	BOOST_CHECK_LT(countContained(b, out), 30u);
+
+	b.clear();
+	BOOST_CHECK_EQUAL(countContained(b, in), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(rollOnCapacity)
+{
+	mt19937_64 g(43);
+	h256s first = randomHashes(g, 100);
+	h256s second = randomHashes(g, 100);
+	h256s third = randomHashes(g, 100);
+
+	RollingBloom b(100, chrono::seconds(3600));
+	for (auto const& h: first)
+		b.insert(h);
+	for (auto const& h: second)
+		b.insert(h);
+
+	// The first generation is now the previous one; still there.
+	BOOST_CHECK_EQUAL(countContained(b, first), first.size());
+	BOOST_CHECK_EQUAL(countContained(b, second), second.size());
+
+	for (auto const& h: third)
+		b.insert(h);
+
+	// Two generations on, the first has been forgotten (bar the odd false positive).
+	BOOST_CHECK_LT(countContained(b, first), 5u);
+	BOOST_CHECK_EQUAL(countContained(b, second), second.size());
+	BOOST_CHECK_EQUAL(countContained(b, third), third.size());
+}
+
+BOOST_AUTO_TEST_CASE(rollOnAge)
+{
+	mt19937_64 g(44);
+	h256s hs = randomHashes(g, 3);
+
+	// With no maximum age every insertion starts a new generation.
+	RollingBloom b(100, chrono::seconds(0));
+	b.insert(hs[0]);
+	b.insert(hs[1]);
+	BOOST_CHECK(b.contains(hs[0]));
+	BOOST_CHECK(b.contains(hs[1]));
+	b.insert(hs[2]);
+	BOOST_CHECK(!b.contains(hs[0]));
+	BOOST_CHECK(b.contains(hs[1]));
+	BOOST_CHECK(b.contains(hs[2]));
+}
+
+BOOST_AUTO_TEST_CASE(fixedMemory)
+{
+	mt19937_64 g(45);
+	RollingBloom b(256);
+	size_t before = b.memoryUsage();
+	for (auto const& h: randomHashes(g, 10000))
+		b.insert(h);
+	BOOST_CHECK_EQUAL(b.memoryUsage(), before);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,181 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file transactionQueue.cpp
+ * @date 2015
+ * TransactionQueue ordering test functions.
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <libethereum/TransactionQueue.h>
+#include <libethereum/Transaction.h>
+#include <libethereum/State.h>
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+
+namespace
+{
+bool import(TransactionQueue& _tq, Transaction const& _t)
+{
+	bytes rlp = _t.rlp();
+	return _tq.import(&rlp);
+}
+}
+
+BOOST_AUTO_TEST_SUITE(TransactionQueueTests)
+
+BOOST_AUTO_TEST_CASE(tqOrdering)
+{
+	KeyPair a = KeyPair::create();
+	KeyPair b = KeyPair::create();
+	Transaction a0(0, 10, 21000, Address(), bytes(), 0, a.secret());
+	Transaction a1(0, 50, 21000, Address(), bytes(), 1, a.secret());
+	Transaction b0(0, 20, 21000, Address(), bytes(), 0, b.secret());
+
+	TransactionQueue tq;
+	BOOST_CHECK(import(tq, a1));
+	BOOST_CHECK(import(tq, b0));
+	BOOST_CHECK(import(tq, a0));
+
+	// b0 pays more than a0, and a1 can't come before a0 however much it pays.
+	auto ts = tq.topTransactions();
+	BOOST_REQUIRE_EQUAL(ts.size(), 3u);
+	BOOST_CHECK(ts[0].first == b0.sha3());
+	BOOST_CHECK(ts[1].first == a0.sha3());
+	BOOST_CHECK(ts[2].first == a1.sha3());
+}
+
+BOOST_AUTO_TEST_CASE(tqReplacement)
+{
+	KeyPair a = KeyPair::create();
+	Transaction cheap(0, 10, 21000, Address(), bytes(), 0, a.secret());
+	Transaction same(1, 10, 21000, Address(), bytes(), 0, a.secret());
+	Transaction dear(0, 11, 21000, Address(), bytes(), 0, a.secret());
+
+	TransactionQueue tq;
+	BOOST_CHECK(import(tq, cheap));
+	BOOST_CHECK(!import(tq, same));
+	BOOST_CHECK(import(tq, dear));
+
+	auto ts = tq.topTransactions();
+	BOOST_REQUIRE_EQUAL(ts.size(), 1u);
+	BOOST_CHECK(ts[0].first == dear.sha3());
+	BOOST_CHECK_EQUAL(tq.items().first, 1u);
+}
+
+BOOST_AUTO_TEST_CASE(tqEvictionTakesLaterNonces)
+{
+	// Each of these is just over 1MB, so 15 fit within c_maxQueuedTransactionBytes but 16 don't.
+	bytes data(1100000, 0x42);
+	KeyPair a = KeyPair::create();
+	KeyPair b = KeyPair::create();
+	KeyPair c = KeyPair::create();
+	Transaction a0(0, 10, 21000, Address(), data, 0, a.secret());
+	Transaction a1(0, 100, 21000, Address(), data, 1, a.secret());
+
+	TransactionQueue tq;
+	BOOST_REQUIRE(import(tq, a0));
+	BOOST_REQUIRE(import(tq, a1));
+	for (unsigned i = 0; i < 13; ++i)
+		BOOST_REQUIRE(import(tq, Transaction(0, 50, 21000, Address(), data, i, b.secret())));
+	BOOST_REQUIRE_EQUAL(tq.items().first, 15u);
+
+	// Making room evicts a0, the cheapest; a1 can't be mined without it, so goes too, however much it pays.
+	Transaction c0(0, 20, 21000, Address(), data, 0, c.secret());
+	BOOST_CHECK(import(tq, c0));
+	auto ts = tq.transactions();
+	BOOST_CHECK_EQUAL(ts.size(), 14u);
+	BOOST_CHECK(!ts.count(a0.sha3()));
+	BOOST_CHECK(!ts.count(a1.sha3()));
+	BOOST_CHECK(ts.count(c0.sha3()));
+}
+
+BOOST_AUTO_TEST_CASE(tqCullKeepsNextNonce)
+{
+	KeyPair a = KeyPair::create();
+	Transaction a0(0, 10, 21000, Address(), bytes(), 0, a.secret());
+	Transaction a1(0, 10, 21000, Address(), bytes(), 1, a.secret());
+	Transaction a2(0, 10, 21000, Address(), bytes(), 2, a.secret());
+	Transaction a3(0, 10, 21000, Address(), bytes(), 3, a.secret());
+
+	TransactionQueue tq;
+	for (auto const& t: {a0, a1, a2, a3})
+		BOOST_REQUIRE(import(tq, t));
+
+	// a has sent two transactions, so a0 and a1 are stale but a2 is the next one to be mined.
+	State s(Address(), OverlayDB(), BaseState::Empty);
+	s.noteSending(a.address());
+	s.noteSending(a.address());
+	BOOST_CHECK(s.cull(tq));
+
+	auto ts = tq.transactions();
+	BOOST_CHECK_EQUAL(ts.size(), 2u);
+	BOOST_CHECK(ts.count(a2.sha3()));
+	BOOST_CHECK(ts.count(a3.sha3()));
+	BOOST_CHECK(!s.cull(tq));
+}
+
+BOOST_AUTO_TEST_CASE(tqCullKeepsNonceEqualToTransactionsFrom)
+{
+	KeyPair a = KeyPair::create();
+	KeyPair b = KeyPair::create();
+	Transaction a1(0, 10, 21000, Address(), bytes(), 1, a.secret());
+	Transaction b0(0, 10, 21000, Address(), bytes(), 0, b.secret());
+
+	TransactionQueue tq;
+	BOOST_REQUIRE(import(tq, a1));
+	BOOST_REQUIRE(import(tq, b0));
+
+	// Executive::setup requires a nonce of exactly transactionsFrom(sender), so these are the ones to mine next.
+	State s(Address(), OverlayDB(), BaseState::Empty);
+	s.noteSending(a.address());
+	BOOST_REQUIRE_EQUAL(s.transactionsFrom(a.address()), a1.nonce());
+	BOOST_REQUIRE_EQUAL(s.transactionsFrom(b.address()), b0.nonce());
+	BOOST_CHECK(!s.cull(tq));
+
+	auto ts = tq.transactions();
+	BOOST_CHECK_EQUAL(ts.size(), 2u);
+	BOOST_CHECK(ts.count(a1.sha3()));
+	BOOST_CHECK(ts.count(b0.sha3()));
+}
+
+BOOST_AUTO_TEST_CASE(tqNewCapped)
+{
+	KeyPair a = KeyPair::create();
+	TransactionQueue tq;
+	h256s hashes;
+	for (unsigned i = 0; i < c_maxNewTransactions + 10; ++i)
+	{
+		Transaction t(0, 10, 21000, Address(), bytes(), i, a.secret());
+		BOOST_REQUIRE(import(tq, t));
+		hashes.push_back(t.sha3());
+	}
+
+	// Only the most recent c_maxNewTransactions are left to gossip, though all are still queued.
+	vector<pair<h256, bytes>> fresh;
+	tq.drainNew(fresh);
+	BOOST_REQUIRE_EQUAL(fresh.size(), c_maxNewTransactions);
+	BOOST_CHECK(fresh.front().first == hashes[10]);
+	BOOST_CHECK(fresh.back().first == hashes.back());
+	BOOST_CHECK_EQUAL(tq.items().first, c_maxNewTransactions + 10);
+
+	fresh.clear();
+	tq.drainNew(fresh);
+	BOOST_CHECK(fresh.empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -459,6 +459,74 @@ void doVMTests(json_spirit::mValue& v, bool _fillin)
 	}
 }
 
+#if ETH_EVMJIT
+
+namespace
+{
+
+/// What a run leaves behind that depends on the gas it was charged.
+struct GasOutcome
+{
+	bool excepted = false;
+	u256 gas;
+	bytes output;
+	map<u256, u256> storage;
+	bytes logs;
+};
+
+GasOutcome runWithGas(VMKind _kind, bytes const& _code, u256 _gas)
+{
+	VMFactory::setKind(_kind);
+	FakeExtVM fev;
+	fev.setTransaction(Address(69), 0, 1, fromHex("0102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f202122232425262728292a2b2c2d2e2f303132333435363738393a3b3c3d3e3f40"));
+	fev.setContract(Address(0x1000), 0, 0, map<u256, u256>(), _code);
+	fev.code = _code;
+
+	GasOutcome ret;
+	try
+	{
+		auto vm = VMFactory::create(_gas);
+		ret.output = vm->go(fev).toBytes();
+		ret.gas = vm->gas();
+	}
+	catch (VMException const&)
+	{
+		ret.excepted = true;
+	}
+	ret.storage = get<2>(fev.addresses[fev.myAddress]);
+	RLPStream logs(fev.sub.logs.size());
+	for (LogEntry const& l: fev.sub.logs)
+		l.streamRLP(logs);
+	ret.logs = logs.out();
+	return ret;
+}
+
+/// Runs @a _code through the interpreter and the JIT with every amount of gas up to what the interpreter needs,
+/// so that each run stops at a different step, and requires the same outcome from both.
+void checkJitMatchesInterpreter(bytes const& _code, string const& _name)
+{
+	u256 const plenty = 100000;
+	GasOutcome full = runWithGas(VMKind::Interpreter, _code, plenty);
+	// A run that excepts takes all its gas, so then sweep well past the step that raises.
+	u256 used = full.excepted ? 1000 : plenty - full.gas;
+	for (u256 gas = 0; gas <= used + 2; ++gas)
+	{
+		GasOutcome interpreted = runWithGas(VMKind::Interpreter, _code, gas);
+		GasOutcome jitted = runWithGas(VMKind::JIT, _code, gas);
+		BOOST_REQUIRE_MESSAGE(interpreted.excepted == jitted.excepted, _name << " with gas " << gas);
+		if (interpreted.excepted)
+			continue;
+		BOOST_REQUIRE_MESSAGE(interpreted.gas == jitted.gas, _name << " with gas " << gas << ": " << interpreted.gas << " vs " << jitted.gas);
+		BOOST_REQUIRE(interpreted.output == jitted.output);
+		BOOST_REQUIRE(interpreted.storage == jitted.storage);
+		BOOST_REQUIRE(interpreted.logs == jitted.logs);
+	}
+}
+
+}
+
+#endif
+
 } } // Namespace Close
 
 BOOST_AUTO_TEST_SUITE(VMTests)
@@ -592,6 +660,51 @@ BOOST_AUTO_TEST_CASE(vmRandom)
 	}
 }
 
+BOOST_AUTO_TEST_CASE(vmJitGasMatchesInterpreter)
+{
+#if ETH_EVMJIT
+	// Every amount of gas up to what the interpreter needs, so that each run goes out of gas at a different step.
+	vector<string> sources{
+		"{ (for [i] 0 (< @i 12) [i] (+ @i 1) { [[@i]] (EXP 3 (* @i 40)) [32] (SHA3 0 (* @i 8)) (LOG1 0 (* @i 4) @i) (CALLDATACOPY 64 0 (* @i 3)) }) [[100]] @i }",
+		"{ [[0]] 1 [[0]] 2 [[0]] 0 [[1]] (GAS) [0] 1 [32] 2 [0] 3 (MSTORE8 63 4) [[2]] (GAS) (RETURN 0 64) }",
+		"{ [0] (GAS) [[0]] (SHA3 0 1000) [32] (GAS) (for [i] 1 (< @i 0x1000000000) [i] (* @i 256) [[@i]] (EXP @i @i)) (RETURN 0 64) }",
+		"{ (for [i] 0 (< @i 30) [i] (+ @i 1) { (when (% @i 3) [[@i]] @i) (unless (% @i 5) [[@i]] 0) }) [64] (GAS) (RETURN 64 32) }"
+	};
+	for (string const& source: sources)
+	{
+		bytes code = compileLLL(source, false);
+		BOOST_REQUIRE(!runWithGas(VMKind::Interpreter, code, 100000).excepted);
+		checkJitMatchesInterpreter(code, source);
+	}
+	VMFactory::setKind(VMKind::Interpreter);
+	processCommandLineOptions();
+#endif
+}
+
+BOOST_AUTO_TEST_CASE(vmJitStackForwardingMatchesInterpreter)
+{
+#if ETH_EVMJIT
+	// Code whose stack items cross blocks that leave them untouched, which the JIT hands on in registers.
+	map<string, string> codes{
+		// 0xaa, 0xbb and 0xcc ride under the counter of a loop and are stored after it.
+		{"deep items across a loop", "60aa60bb60cc" "6000" "5b" "600101" "80" "6009" "11" "6008" "57" "55" "55" "00"},
+		// Both arms of a JUMPI push a different item onto two carried ones; the join adds and stores them.
+		{"diamond, taken", "60116022" "600035" "600f" "57" "6033" "6012" "56" "5b" "6044" "5b" "01" "90" "55" "00"},
+		{"diamond, not taken", "60116022" "604035" "600f" "57" "6033" "6012" "56" "5b" "6044" "5b" "01" "90" "55" "00"},
+		// A subroutine called from two sites; the argument and the return address pass through it.
+		{"subroutine", "6003" "600b" "6020" "56" "00000000" "5b" "6013" "6020" "56" "0000" "5b" "6000" "55" "00" "0000000000000000" "5b" "90" "80" "02" "90" "56"},
+		// A loop that leaves one more item each time round, so its entry stack grows.
+		{"growing loop", "6000" "5b" "80" "600101" "80" "6008" "11" "6002" "57" "55" "55" "01" "55" "55" "00"},
+		// A loop that pops more than it pushes, until the stack underflows.
+		{"shrinking loop", "600160026003" "5b" "50" "6006" "56"}
+	};
+	for (auto const& c: codes)
+		checkJitMatchesInterpreter(fromHex(c.second), c.first);
+	VMFactory::setKind(VMKind::Interpreter);
+	processCommandLineOptions();
+#endif
+}
+
 BOOST_AUTO_TEST_CASE(userDefinedFileVM)
 {
 	dev::test::userDefinedTest("--vmtest", dev::test::doVMTests);
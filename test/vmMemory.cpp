@@ -0,0 +1,77 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file vmMemory.cpp
+ * @date 2015
+ * VMMemory tests, checked against a plain byte vector.
+ */
+
+#include <random>
+#include <boost/test/unit_test.hpp>
+#include <libevm/VMMemory.h>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+
+BOOST_AUTO_TEST_SUITE(VMMemoryTests)
+
+BOOST_AUTO_TEST_CASE(vmMemoryMatchesBytes)
+{
+	mt19937 g(1);
+	for (unsigned frame = 0; frame < 40; ++frame)
+	{
+		// Every frame after the first reuses a buffer some earlier frame scribbled over.
+		VMMemory m;
+		bytes b;
+		for (unsigned op = 0; op < 200; ++op)
+		{
+			size_t size = b.size();
+			switch (g() % 4)
+			{
+			case 0:
+				size += 32;
+				break;
+			case 1:
+				size += g() % (frame % 8 == 7 ? 3 * 1024 * 1024 : 4096);
+				break;
+			case 2:
+				size -= size ? g() % size : 0;
+				break;
+			}
+			m.resize(size);
+			b.resize(size);
+			for (unsigned i = 0; size && i < 16; ++i)
+			{
+				size_t at = g() % size;
+				m[at] = b[at] = (byte)g();
+			}
+			BOOST_REQUIRE_EQUAL(m.size(), b.size());
+		}
+		BOOST_REQUIRE(m.ref().toBytes() == b);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(vmMemoryStartsEmpty)
+{
+	VMMemory m;
+	BOOST_CHECK(m.empty());
+	BOOST_CHECK(m.ref().empty());
+	m.resize(64);
+	BOOST_CHECK(m.ref().toBytes() == bytes(64, 0));
+}
+
+BOOST_AUTO_TEST_SUITE_END()